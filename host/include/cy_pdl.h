@@ -0,0 +1,132 @@
+/***************************************************************************//**
+* \file cy_pdl.h
+*
+* \brief
+* Host build stand-in of the PDL and CMSIS core symbols used by the ML
+* middleware. SystemCoreClock is the frequency of mtb_ml_model_profile_get_tsc(),
+* see mtb_ml_host.c. Cache maintenance and interrupt setup are no-ops.
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#if !defined(CY_PDL_H)
+#define CY_PDL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "cy_result.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/** Frequency of the time stamp counter of the host build */
+extern uint32_t SystemCoreClock;
+
+typedef int32_t IRQn_Type;
+
+typedef struct
+{
+    IRQn_Type intrSrc;          /**< Interrupt source */
+    uint32_t intrPriority;      /**< Interrupt priority */
+} cy_stc_sysint_t;
+
+typedef void (*cy_israddress)(void);
+
+typedef enum
+{
+    CY_SYSINT_SUCCESS = 0x00U,
+    CY_SYSINT_BAD_PARAM = 0x01U,
+} cy_en_sysint_status_t;
+
+static inline cy_en_sysint_status_t Cy_SysInt_Init(const cy_stc_sysint_t *config, cy_israddress isr)
+{
+    (void)isr;
+    return (config != NULL) ? CY_SYSINT_SUCCESS : CY_SYSINT_BAD_PARAM;
+}
+
+static inline void NVIC_EnableIRQ(IRQn_Type irq)
+{
+    (void)irq;
+}
+
+static inline void NVIC_DisableIRQ(IRQn_Type irq)
+{
+    (void)irq;
+}
+
+/* The host caches are coherent */
+static inline void SCB_CleanDCache_by_Addr(volatile void *addr, int32_t size)
+{
+    (void)addr;
+    (void)size;
+}
+
+static inline void SCB_InvalidateDCache_by_Addr(volatile void *addr, int32_t size)
+{
+    (void)addr;
+    (void)size;
+}
+
+static inline void SCB_CleanInvalidateDCache_by_Addr(volatile void *addr, int32_t size)
+{
+    (void)addr;
+    (void)size;
+}
+
+static inline void SCB_CleanDCache(void)
+{
+}
+
+static inline void SCB_InvalidateDCache(void)
+{
+}
+
+static inline void __DSB(void)
+{
+    __sync_synchronize();
+}
+
+static inline void __DMB(void)
+{
+    __sync_synchronize();
+}
+
+static inline void __ISB(void)
+{
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CY_PDL_H */
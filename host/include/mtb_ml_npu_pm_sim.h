@@ -0,0 +1,92 @@
+/***************************************************************************//**
+* \file mtb_ml_npu_pm_sim.h
+*
+* \brief
+* Simulated NPU power controller of the host build. It provides the time and
+* power operations of the NPU power manager, with a manual millisecond clock.
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#if !defined(__MTB_ML_NPU_PM_SIM_H__)
+#define __MTB_ML_NPU_PM_SIM_H__
+
+#include "mtb_ml_npu_pm.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Typedefs
+ *****************************************************************************/
+/**
+ * Simulated power controller, its fields may be set directly by a test
+ */
+typedef struct
+{
+    uint32_t now_ms;            /**< Time base of the idle timeout */
+    uint64_t cycles;            /**< Time base of the wake latency */
+    uint64_t wake_cycles;       /**< Cycles a power up takes */
+    bool powered;               /**< NPU power */
+    bool fail_power_on;         /**< Next power ups fail */
+    bool held;                  /**< Lock held, by the manager or by a simulated other task */
+    uint32_t power_on_count;    /**< Power ups */
+    uint32_t power_off_count;   /**< Power downs */
+    uint32_t lock_errors;       /**< Lock taken while held or unlock while free */
+} mtb_ml_npu_pm_sim_t;
+
+/******************************************************************************
+ * Public definitions
+ *****************************************************************************/
+/**
+ * \brief : Initialize a simulated controller of a powered NPU and its operations
+ *
+ * \param[out] sim       : Simulated controller
+ * \param[out] ops       : Operations for mtb_ml_npu_pm_init()
+ * \param[in] now_ms     : Start time
+ */
+void mtb_ml_npu_pm_sim_init(mtb_ml_npu_pm_sim_t *sim, mtb_ml_npu_pm_ops_t *ops, uint32_t now_ms);
+
+/**
+ * \brief : Advance the simulated time, wrapping as a 32-bit millisecond counter
+ *
+ * \param[in] sim        : Simulated controller
+ * \param[in] ms         : Elapsed time
+ */
+void mtb_ml_npu_pm_sim_advance(mtb_ml_npu_pm_sim_t *sim, uint32_t ms);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __MTB_ML_NPU_PM_SIM_H__ */
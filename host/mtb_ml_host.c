@@ -0,0 +1,111 @@
+/***************************************************************************//**
+* \file mtb_ml_host.c
+*
+* \brief
+* Board support of the ML middleware host build: the time stamp counter used
+* for profiling and SystemCoreClock, its frequency.
+*
+* The counter is CLOCK_MONOTONIC in nanoseconds. With MTB_ML_HOST_TSC_RDTSC=1
+* on x86-64 it is the TSC instead, calibrated against CLOCK_MONOTONIC at start.
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#include <stdint.h>
+#include <time.h>
+#include "cy_pdl.h"
+#include "mtb_ml_model.h"
+
+#ifndef MTB_ML_HOST_TSC_RDTSC
+#define MTB_ML_HOST_TSC_RDTSC       (0)
+#endif
+
+#if (MTB_ML_HOST_TSC_RDTSC == 1) && !defined(__x86_64__)
+#error "MTB_ML_HOST_TSC_RDTSC requires an x86-64 host"
+#endif
+
+#if (MTB_ML_HOST_TSC_RDTSC == 1)
+#include <x86intrin.h>
+
+/* Calibration period of the TSC frequency */
+#define HOST_TSC_CALIBRATION_NS     (20000000ULL)
+#endif
+
+#define HOST_NS_PER_S               (1000000000ULL)
+
+/*******************************************************************************
+ * Public variables
+*******************************************************************************/
+uint32_t SystemCoreClock = (uint32_t)HOST_NS_PER_S;
+
+/*******************************************************************************
+ * Private Functions
+*******************************************************************************/
+static uint64_t host_monotonic_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * HOST_NS_PER_S + (uint64_t)ts.tv_nsec;
+}
+
+#if (MTB_ML_HOST_TSC_RDTSC == 1)
+__attribute__((constructor)) static void host_tsc_calibrate(void)
+{
+    uint64_t start_ns = host_monotonic_ns();
+    uint64_t start_tsc = __rdtsc();
+    uint64_t ns, tsc;
+
+    do
+    {
+        ns = host_monotonic_ns() - start_ns;
+    } while(ns < HOST_TSC_CALIBRATION_NS);
+    tsc = __rdtsc() - start_tsc;
+
+    /* SystemCoreClock is 32 bits as on the device, enough up to 4.29 GHz */
+    tsc = tsc * HOST_NS_PER_S / ns;
+    SystemCoreClock = (tsc > UINT32_MAX) ? UINT32_MAX : (uint32_t)tsc;
+}
+#endif
+
+/*******************************************************************************
+ * Public Functions
+*******************************************************************************/
+int mtb_ml_model_profile_get_tsc(uint64_t *val)
+{
+#if (MTB_ML_HOST_TSC_RDTSC == 1)
+    *val = __rdtsc();
+#else
+    *val = host_monotonic_ns();
+#endif
+    return 0;
+}
@@ -0,0 +1,135 @@
+/***************************************************************************//**
+* \file mtb_ml_npu_pm_sim.c
+*
+* \brief
+* Simulated NPU power controller of the host build.
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#include <string.h>
+#include "mtb_ml_npu_pm_sim.h"
+
+/*******************************************************************************
+ * Private Functions
+*******************************************************************************/
+static cy_rslt_t sim_power_on(void *arg)
+{
+    mtb_ml_npu_pm_sim_t *sim = (mtb_ml_npu_pm_sim_t *)arg;
+
+    if (sim->fail_power_on)
+    {
+        return MTB_ML_RESULT_NPU_INIT_ERROR;
+    }
+    sim->cycles += sim->wake_cycles;
+    sim->powered = true;
+    sim->power_on_count++;
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+static void sim_power_off(void *arg)
+{
+    mtb_ml_npu_pm_sim_t *sim = (mtb_ml_npu_pm_sim_t *)arg;
+
+    sim->powered = false;
+    sim->power_off_count++;
+}
+
+static uint32_t sim_get_time_ms(void *arg)
+{
+    return ((mtb_ml_npu_pm_sim_t *)arg)->now_ms;
+}
+
+static uint64_t sim_get_cycles(void *arg)
+{
+    return ((mtb_ml_npu_pm_sim_t *)arg)->cycles;
+}
+
+/* Single threaded, a blocking lock of a held state machine would never return */
+static void sim_lock(void *arg)
+{
+    mtb_ml_npu_pm_sim_t *sim = (mtb_ml_npu_pm_sim_t *)arg;
+
+    if (sim->held)
+    {
+        sim->lock_errors++;
+    }
+    sim->held = true;
+}
+
+static void sim_unlock(void *arg)
+{
+    mtb_ml_npu_pm_sim_t *sim = (mtb_ml_npu_pm_sim_t *)arg;
+
+    if (!sim->held)
+    {
+        sim->lock_errors++;
+    }
+    sim->held = false;
+}
+
+static bool sim_try_lock(void *arg)
+{
+    mtb_ml_npu_pm_sim_t *sim = (mtb_ml_npu_pm_sim_t *)arg;
+
+    if (sim->held)
+    {
+        return false;
+    }
+    sim->held = true;
+    return true;
+}
+
+/*******************************************************************************
+ * Public Functions
+*******************************************************************************/
+void mtb_ml_npu_pm_sim_init(mtb_ml_npu_pm_sim_t *sim, mtb_ml_npu_pm_ops_t *ops, uint32_t now_ms)
+{
+    memset(sim, 0, sizeof(*sim));
+    sim->now_ms = now_ms;
+    sim->wake_cycles = 1000;
+    sim->powered = true;
+
+    ops->power_on = sim_power_on;
+    ops->power_off = sim_power_off;
+    ops->get_time_ms = sim_get_time_ms;
+    ops->get_cycles = sim_get_cycles;
+    ops->lock = sim_lock;
+    ops->unlock = sim_unlock;
+    ops->try_lock = sim_try_lock;
+    ops->arg = sim;
+}
+
+void mtb_ml_npu_pm_sim_advance(mtb_ml_npu_pm_sim_t *sim, uint32_t ms)
+{
+    sim->now_ms += ms;
+}
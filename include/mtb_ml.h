@@ -39,9 +39,16 @@
 #if !defined(__MTB_ML_H__)
 #define __MTB_ML_H__
 
+#include "mtb_ml_cascade.h"
 #include "mtb_ml_common.h"
 #include "mtb_ml_dataset.h"
+#include "mtb_ml_dataset_reader.h"
 #include "mtb_ml_model.h"
+#include "mtb_ml_model_swap.h"
+#include "mtb_ml_model_variants.h"
+#include "mtb_ml_npu_pm.h"
+#include "mtb_ml_regression.h"
+#include "mtb_ml_scheduler.h"
 #include "mtb_ml_stream.h"
 #include "mtb_ml_utils.h"
 
@@ -61,8 +68,35 @@ extern "C" {
 #define MTB_ML_ETHOSU_CACHE_MGMT_TYPE MTB_ML_ETHOSU_CACHE_MGMT_ALL_LAYERS
 #endif
 
+#ifndef MTB_ML_ETHOSU_PMU_EVENT0
+#define MTB_ML_ETHOSU_PMU_EVENT0 ETHOSU_PMU_AXI0_RD_DATA_BEAT_RECEIVED
+#endif
+#ifndef MTB_ML_ETHOSU_PMU_EVENT1
+#define MTB_ML_ETHOSU_PMU_EVENT1 ETHOSU_PMU_AXI0_WR_DATA_BEAT_WRITTEN
+#endif
+#ifndef MTB_ML_ETHOSU_PMU_EVENT2
+#define MTB_ML_ETHOSU_PMU_EVENT2 ETHOSU_PMU_MAC_ACTIVE
+#endif
+#ifndef MTB_ML_ETHOSU_PMU_EVENT3
+#define MTB_ML_ETHOSU_PMU_EVENT3 ETHOSU_PMU_NPU_IDLE
+#endif
+
 void mtb_ml_set_cache_mgmt_type(uint32_t type);
 uint32_t mtb_ml_get_cache_mgmt_type(void);
+void mtb_ml_set_pmu_events(const enum ethosu_pmu_event_type events[MTB_ML_NPU_PMU_EVENT_COUNT]);
+void mtb_ml_get_pmu_events(enum ethosu_pmu_event_type events[MTB_ML_NPU_PMU_EVENT_COUNT]);
+
+#ifndef MTB_ML_NPU_IDLE_TIMEOUT_MS
+/* Idle time in ms before the NPU is powered down, MTB_ML_NPU_PM_ALWAYS_ON keeps it powered */
+#define MTB_ML_NPU_IDLE_TIMEOUT_MS MTB_ML_NPU_PM_ALWAYS_ON
+#endif
+
+cy_rslt_t mtb_ml_npu_power_acquire(void);
+void mtb_ml_npu_power_release(void);
+bool mtb_ml_npu_power_process(void);
+void mtb_ml_npu_power_set_idle_timeout(uint32_t idle_timeout_ms);
+void mtb_ml_npu_power_set_time_source(uint32_t (*get_time_ms)(void));
+void mtb_ml_npu_power_get_stats(mtb_ml_npu_pm_stats_t *stats);
 #endif
 
 #if defined(COMPONENT_NNLITE2)
@@ -76,6 +110,32 @@ uint32_t Cy_NNLite_Sem_Give(void *sem);
 uint32_t Cy_NNLite_Sem_Delete(void *sem);
 void Cy_NNLite_Lpm_Lock(void);
 void Cy_NNLite_Lpm_Unlock(void);
+void mtb_ml_nnlite_prof_bind(mtb_ml_npu_prof_ctx_t *ctx);
+cy_rslt_t mtb_ml_nnlite_prof_kernels_enable(mtb_ml_npu_prof_ctx_t *ctx, bool enable);
+cy_rslt_t mtb_ml_nnlite_prof_kernels_log(const mtb_ml_npu_prof_ctx_t *ctx);
+
+#ifndef MTB_ML_NNLITE_PROF_RING_SIZE
+/* Number of NNLite kernel timing records kept per model */
+#define MTB_ML_NNLITE_PROF_RING_SIZE    (64)
+#endif
+
+/* Bare-metal wait for NNLite completion */
+#define MTB_ML_NNLITE_WAIT_SPIN         (0) /* busy-wait on the completion flag */
+#define MTB_ML_NNLITE_WAIT_WFE          (1) /* sleep in WFE, the NNLite ISR issues SEV */
+#define MTB_ML_NNLITE_WAIT_CALLBACK     (2) /* run the application wait callback until completion */
+#define MTB_ML_NNLITE_WAIT_BENCHMARK    (3) /* alternate SPIN and WFE per frame, NPU cycles are reported per mode */
+
+#ifndef MTB_ML_NNLITE_WAIT_MODE
+#define MTB_ML_NNLITE_WAIT_MODE MTB_ML_NNLITE_WAIT_SPIN
+#endif
+
+typedef void (*mtb_ml_nnlite_wait_cb_t)(void *arg);
+
+void mtb_ml_set_nnlite_wait_mode(uint32_t mode);
+uint32_t mtb_ml_get_nnlite_wait_mode(void);
+void mtb_ml_set_nnlite_wait_callback(mtb_ml_nnlite_wait_cb_t callback, void *arg);
+void mtb_ml_nnlite_wait_account(uint64_t npu_cycles);
+void mtb_ml_nnlite_wait_log(void);
 #endif
 
 /******************************************************************************
@@ -129,7 +189,7 @@ void Cy_NNLite_Lpm_Unlock(void);
 extern uint32_t mtb_ml_cpu_clk_freq;
 #if defined(COMPONENT_U55) || \
     defined(COMPONENT_NNLITE2)
-extern uint64_t mtb_ml_npu_cycles;          /** Profiling cycles */
+extern uint64_t mtb_ml_npu_cycles;          /** NPU cycles of the last profiled inference */
 extern uint32_t mtb_ml_npu_clk_freq;
 extern float mtb_ml_norm_clk_freq;          /** NPU : CPU clock frequency */
 #endif
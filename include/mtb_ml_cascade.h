@@ -0,0 +1,209 @@
+/***************************************************************************//**
+* \file mtb_ml_cascade.h
+*
+* \brief
+* This is the header file of the ModusToolbox ML middleware model cascade module
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#if !defined(__MTB_ML_CASCADE_H__)
+#define __MTB_ML_CASCADE_H__
+
+#include "mtb_ml_common.h"
+#include "mtb_ml_model.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Typedefs
+ *****************************************************************************/
+/**
+ * Gating predicate on the output of the gate model
+ */
+typedef enum
+{
+    MTB_ML_CASCADE_GATE_THRESHOLD = 0,  /**< Output element index at or above threshold */
+    MTB_ML_CASCADE_GATE_ARGMAX_IN_SET,  /**< Top-1 class of the gate output in class_set */
+    MTB_ML_CASCADE_GATE_CALLBACK,       /**< Application callback on the quantized gate output */
+} mtb_ml_cascade_gate_type_t;
+
+/**
+ * Application gating predicate, the gate output is read with mtb_ml_model_get_output()
+ */
+typedef bool (*mtb_ml_cascade_gate_cb_t)(const mtb_ml_model_t *gate, void *arg);
+
+/******************************************************************************
+ * Structures
+******************************************************************************/
+/**
+ * Gating predicate configuration
+ */
+typedef struct
+{
+    mtb_ml_cascade_gate_type_t type;    /**< Predicate type */
+    uint32_t index;                     /**< MTB_ML_CASCADE_GATE_THRESHOLD: output element compared */
+    float threshold;                    /**< MTB_ML_CASCADE_GATE_THRESHOLD: dequantized threshold */
+    uint64_t class_set;                 /**< MTB_ML_CASCADE_GATE_ARGMAX_IN_SET: bit n set for class n, classes 0..63 */
+    mtb_ml_cascade_gate_cb_t callback;  /**< MTB_ML_CASCADE_GATE_CALLBACK: predicate */
+    void *callback_arg;                 /**< MTB_ML_CASCADE_GATE_CALLBACK: argument of the callback */
+} mtb_ml_cascade_gate_t;
+
+/**
+ * Cascade statistics, in CPU cycles of mtb_ml_model_profile_get_tsc(). At a fixed clock
+ * the energy saved scales with the saved cycles.
+ */
+typedef struct
+{
+    uint32_t frames;                /**< Frames run through the gate */
+    uint32_t gate_hits;             /**< Frames that triggered the expensive model */
+    float hit_rate;                 /**< gate_hits / frames */
+    uint64_t gate_cycles;           /**< Cycles of all gate runs */
+    uint64_t main_cycles;           /**< Cycles of all expensive model runs */
+    int64_t saved_cycles;           /**< Cycles of an always-on expensive model, at its average, minus gate_cycles and main_cycles */
+    int64_t avg_saved_cycles;       /**< saved_cycles / frames */
+    float saved_ratio;              /**< saved_cycles relative to the always-on expensive model */
+} mtb_ml_cascade_stats_t;
+
+/**
+ * Cascade of a cheap gate model and an expensive model
+ */
+typedef struct
+{
+    mtb_ml_model_t *gate;           /**< Gate model */
+    mtb_ml_model_t *main;           /**< Expensive model */
+    mtb_ml_cascade_gate_t predicate;/**< Gating predicate */
+    int32_t q_threshold;            /**< Threshold in the quantized gate output domain */
+    bool owns_models;               /**< Models created by mtb_ml_cascade_init() */
+    mtb_ml_cascade_stats_t stats;   /**< Statistics */
+} mtb_ml_cascade_t;
+
+/*******************************************************************************
+ * Function Prototypes
+*******************************************************************************/
+/**
+ * \addtogroup Cascade_API
+ * @{
+ */
+/**
+ * \brief : Creates both models of a cascade. With a shared working buffer the gate model takes
+ *          the first gate_bin->arena_size bytes (16 byte aligned) and the expensive model the rest,
+ *          so one arena sized for both is enough. Without a buffer each model allocates its own.
+ *
+ * \param[out]  cascade     : Cascade context.
+ * \param[in]   gate_bin    : Model binary data of the gate model.
+ * \param[in]   main_bin    : Model binary data of the expensive model.
+ * \param[in]   buffer      : Shared working buffer or NULL.
+ * \param[in]   predicate   : Gating predicate.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ *                          : MTB_ML_RESULT_ALLOC_ERR - if the shared buffer is too small.
+ *                          : otherwise - error of mtb_ml_model_init().
+ */
+cy_rslt_t mtb_ml_cascade_init(mtb_ml_cascade_t *cascade, const mtb_ml_model_bin_t *gate_bin,
+                              const mtb_ml_model_bin_t *main_bin, const mtb_ml_model_buffer_t *buffer,
+                              const mtb_ml_cascade_gate_t *predicate);
+
+/**
+ * \brief : Builds a cascade of two initialized model objects, which stay owned by the caller.
+ *
+ * \param[out]  cascade     : Cascade context.
+ * \param[in]   gate        : Gate model object.
+ * \param[in]   main        : Expensive model object.
+ * \param[in]   predicate   : Gating predicate.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ */
+cy_rslt_t mtb_ml_cascade_attach(mtb_ml_cascade_t *cascade, mtb_ml_model_t *gate, mtb_ml_model_t *main,
+                                const mtb_ml_cascade_gate_t *predicate);
+
+/**
+ * \brief : Runs the gate model and, if its output passes the predicate, the expensive model.
+ *          The gate output is evaluated in its quantized domain.
+ *
+ * \param[in]   cascade     : Cascade context.
+ * \param[in]   gate_input  : Input data of the gate model.
+ * \param[in]   main_input  : Input data of the expensive model, NULL to reuse gate_input.
+ * \param[out]  triggered   : True if the expensive model ran, its output is then read from cascade->main.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ *                          : MTB_ML_RESULT_INPUT_ERROR - if gate_input is reused and the model inputs differ.
+ *                          : otherwise - error of mtb_ml_model_run().
+ */
+cy_rslt_t mtb_ml_cascade_run(mtb_ml_cascade_t *cascade, MTB_ML_DATA_T *gate_input,
+                             MTB_ML_DATA_T *main_input, bool *triggered);
+
+/**
+ * \brief : Statistics of the cascade.
+ *
+ * \param[in]   cascade     : Cascade context.
+ * \param[out]  stats       : Statistics record.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ */
+cy_rslt_t mtb_ml_cascade_get_stats(const mtb_ml_cascade_t *cascade, mtb_ml_cascade_stats_t *stats);
+
+/**
+ * \brief : Prints the statistics in one line.
+ *
+ * \param[in]   stats       : Statistics record.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ */
+cy_rslt_t mtb_ml_cascade_log(const mtb_ml_cascade_stats_t *stats);
+
+/**
+ * \brief : Deletes the models created by mtb_ml_cascade_init().
+ *
+ * \param[in]   cascade     : Cascade context.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ */
+cy_rslt_t mtb_ml_cascade_deinit(mtb_ml_cascade_t *cascade);
+
+/**
+ * @} end of Cascade_API group
+ */
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __MTB_ML_CASCADE_H__ */
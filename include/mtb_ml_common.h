@@ -148,6 +148,7 @@ typedef enum
 #define MTB_ML_RESULT_TIMEOUT            CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_ML, 8)
 #define MTB_ML_RESULT_NPU_INIT_ERROR     CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_ML, 9)
 #define MTB_ML_RESULT_CYCLE_COUNT_ERROR  CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_ML, 10)
+#define MTB_ML_RESULT_BUSY               CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_ML, 11)
 
 /******************************************************************************
 * Structures
@@ -50,6 +50,8 @@ extern "C" {
 /******************************************************************************
  * Macros
  *****************************************************************************/
+/** Magic of mtb_ml_y_file_header_t ("MLY1"), reference data without it has no header */
+#define MTB_ML_Y_FILE_MAGIC         (0x31594C4DU)
 
 /******************************************************************************
  * Typedefs
@@ -80,6 +82,17 @@ typedef struct mtb_ml_x_file_header
     int32_t recurrent_ts_size;      /**< -1 - non-RNN model, 1 - non-streaming RNN, other - number of time steps */
 } mtb_ml_x_file_header_t;
 
+/**
+ * Reference result data file header data structure
+ */
+typedef struct mtb_ml_y_file_header
+{
+    uint32_t magic;                 /**< MTB_ML_Y_FILE_MAGIC */
+    mtb_ml_x_data_type_t data_type; /**< data type of reference results */
+    int32_t num_of_samples;         /**< number of samples in dataset */
+    int32_t output_size;            /**< Output length of each sample */
+} mtb_ml_y_file_header_t;
+
 #if defined(__cplusplus)
 }
 #endif
@@ -0,0 +1,196 @@
+/***************************************************************************//**
+* \file mtb_ml_dataset_reader.h
+*
+* \brief
+* This is the header file of the ModusToolbox ML middleware dataset reader
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#if !defined(__MTB_ML_DATASET_READER_H__)
+#define __MTB_ML_DATASET_READER_H__
+
+#include "mtb_ml_common.h"
+#include "mtb_ml_dataset.h"
+#include "mtb_ml_model.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Structures
+******************************************************************************/
+/**
+ * Dataset reader, zero-copy view of an x data blob and its optional reference results
+ */
+typedef struct
+{
+    const mtb_ml_x_file_header_t *x_header; /**< Header of the x data */
+    const uint8_t *x_samples;       /**< First sample */
+    const uint8_t *y_samples;       /**< First reference result, NULL without y data */
+    mtb_ml_x_data_type_t y_type;    /**< Type of the reference results, MTB_ML_X_DATA_UNKNOWN until
+                                         mtb_ml_dataset_validate() for y data without header */
+    int32_t output_size;            /**< Outputs of each reference result, 0 until validated without header */
+    uint32_t num_samples;           /**< Number of samples */
+    uint32_t slices;                /**< Time step slices of each sample, 1 unless streaming RNN */
+    size_t sample_bytes;            /**< Bytes of each sample */
+    size_t slice_bytes;             /**< Bytes of each time step slice */
+    size_t y_bytes;                 /**< Bytes of the reference results */
+    uint32_t next;                  /**< Next sample of mtb_ml_dataset_next() */
+    void *x_map;                    /**< Mapping of the x data file, NULL for blobs */
+    size_t x_map_size;              /**< Bytes of x_map */
+    void *y_map;                    /**< Mapping of the y data file, NULL for blobs */
+    size_t y_map_size;              /**< Bytes of y_map */
+} mtb_ml_dataset_t;
+
+/*******************************************************************************
+ * Function Prototypes
+*******************************************************************************/
+/**
+ * \addtogroup Dataset_API
+ * @{
+ */
+/**
+ * \brief : Opens a dataset linked in as blobs, e.g. MTB_ML_MODEL_X_DATA_BIN and
+ *          MTB_ML_MODEL_Y_DATA_BIN. The blobs are used in place.
+ *
+ * \param[out]  dataset     : Dataset reader.
+ * \param[in]   x_data      : x data blob, a mtb_ml_x_file_header_t followed by the samples.
+ * \param[in]   x_size      : Bytes of x_data.
+ * \param[in]   y_data      : Reference results, optionally starting with a mtb_ml_y_file_header_t,
+ *                            or NULL.
+ * \param[in]   y_size      : Bytes of y_data.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ *                          : MTB_ML_RESULT_INPUT_ERROR - if a header is invalid or a blob is too short.
+ */
+cy_rslt_t mtb_ml_dataset_open(mtb_ml_dataset_t *dataset, const void *x_data, size_t x_size,
+                              const void *y_data, size_t y_size);
+
+#if defined(COMPONENT_ML_HOST)
+/**
+ * \brief : Opens a dataset from files by mapping them read-only (host build only).
+ *
+ * \param[out]  dataset     : Dataset reader.
+ * \param[in]   x_path      : x data file.
+ * \param[in]   y_path      : Reference result file or NULL.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid or a file cannot be mapped.
+ *                          : MTB_ML_RESULT_INPUT_ERROR - see mtb_ml_dataset_open().
+ */
+cy_rslt_t mtb_ml_dataset_open_files(mtb_ml_dataset_t *dataset, const char *x_path, const char *y_path);
+#endif
+
+/**
+ * \brief : Closes a dataset and unmaps its files.
+ *
+ * \param[in]   dataset     : Dataset reader.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ */
+cy_rslt_t mtb_ml_dataset_close(mtb_ml_dataset_t *dataset);
+
+/**
+ * \brief : Validates a dataset against a model: the sample type against input_type_size,
+ *          the slice size against input_size and the reference results against the outputs.
+ *          Reference results without header take the model output type.
+ *
+ * \param[in]   dataset     : Dataset reader.
+ * \param[in]   model       : Model object.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ *                          : MTB_ML_RESULT_MISMATCH_DATA_TYPE - if a data type does not match the model.
+ *                          : MTB_ML_RESULT_INPUT_ERROR - if a size does not match the model.
+ */
+cy_rslt_t mtb_ml_dataset_validate(mtb_ml_dataset_t *dataset, const mtb_ml_model_t *model);
+
+/**
+ * \brief : Random access to a sample and its reference result.
+ *
+ * \param[in]   dataset     : Dataset reader.
+ * \param[in]   index       : Sample index.
+ * \param[out]  x           : The sample.
+ * \param[out]  y           : The reference result, NULL without y data or before the validation of
+ *                            y data without header. Optional.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid or index is out of range.
+ */
+cy_rslt_t mtb_ml_dataset_get_sample(const mtb_ml_dataset_t *dataset, uint32_t index, const void **x, const void **y);
+
+/**
+ * \brief : Random access to a time step slice of a streaming RNN sample.
+ *
+ * \param[in]   dataset     : Dataset reader.
+ * \param[in]   index       : Sample index.
+ * \param[in]   slice       : Slice index, below dataset->slices.
+ * \param[out]  x           : The slice.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid or an index is out of range.
+ */
+cy_rslt_t mtb_ml_dataset_get_slice(const mtb_ml_dataset_t *dataset, uint32_t index, uint32_t slice, const void **x);
+
+/**
+ * \brief : Sequential access, returns the next sample and its reference result.
+ *
+ * \param[in]   dataset     : Dataset reader.
+ * \param[out]  x           : The sample.
+ * \param[out]  y           : The reference result, NULL without y data or before the validation of
+ *                            y data without header. Optional.
+ *
+ * \return                  : true - sample returned
+ *                          : false - end of dataset, see mtb_ml_dataset_rewind().
+ */
+bool mtb_ml_dataset_next(mtb_ml_dataset_t *dataset, const void **x, const void **y);
+
+/**
+ * \brief : Restarts the sequential access at the first sample.
+ *
+ * \param[in]   dataset     : Dataset reader.
+ */
+void mtb_ml_dataset_rewind(mtb_ml_dataset_t *dataset);
+
+/**
+ * @} end of Dataset_API group
+ */
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __MTB_ML_DATASET_READER_H__ */
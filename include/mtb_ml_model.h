@@ -56,6 +56,16 @@ extern "C" {
 #define MTB_ML_MEM_DYNAMIC_SCRATCH      (1 << MEM_FLAG_SHIFT_SCRATCH)
 
 #define MTB_ML_MODEL_NAME_LEN           64
+
+#if defined(COMPONENT_U55)
+/* Number of Ethos-U55 PMU event counters (ETHOSU_PMU_NCOUNTERS) */
+#define MTB_ML_NPU_PMU_EVENT_COUNT      4
+
+#ifndef MTB_ML_NPU_COUNTERS_MAX_OPS
+/* Number of Ethos-U custom operators with individually kept PMU counters */
+#define MTB_ML_NPU_COUNTERS_MAX_OPS     8
+#endif
+#endif
 /******************************************************************************
  * Typedefs
  *****************************************************************************/
@@ -82,6 +92,73 @@ typedef struct
 ///@}
 } mtb_ml_model_buffer_t;
 
+#if defined(COMPONENT_U55)
+/**
+ * Ethos-U PMU counter values, extended to 64 bits
+ */
+typedef struct
+{
+    uint64_t cycles;                                /**< NPU cycle counter (CCNT) */
+    uint64_t events[MTB_ML_NPU_PMU_EVENT_COUNT];    /**< PMU event counters */
+} mtb_ml_npu_pmu_sample_t;
+
+/**
+ * Ethos-U PMU counters captured per inference and per custom operator
+ */
+typedef struct
+{
+    uint32_t event_type[MTB_ML_NPU_PMU_EVENT_COUNT];        /**< PMU event (ethosu_pmu_event_type) of each counter */
+    mtb_ml_npu_pmu_sample_t total;                          /**< counters summed over all custom operators */
+    mtb_ml_npu_pmu_sample_t op[MTB_ML_NPU_COUNTERS_MAX_OPS];/**< counters of each custom operator */
+    uint32_t op_count;                                      /**< number of custom operators invoked */
+    uint32_t overflow_count;                                /**< number of counter wraps extended to 64 bits */
+} mtb_ml_npu_counters_t;
+#endif
+
+#if defined(COMPONENT_NNLITE2)
+/**
+ * NNLite kernel timing record
+ */
+typedef struct
+{
+    const char *kernel_type;    /**< TFLM operator name of the kernel, NULL if unknown */
+    uint64_t start;             /**< time stamp of the kernel start */
+    uint32_t frame;             /**< profiled frame the kernel belongs to */
+    uint16_t op_index;          /**< operator index in the model, kernel sequence number in the frame for TFLM_LESS */
+    uint16_t accel_passes;      /**< accelerator runs, more than one for composite kernels (SoftMax, LayerNorm) */
+    uint32_t accel_cycles;      /**< cycles between accelerator start and done */
+    uint32_t wait_cycles;       /**< cycles between accelerator done (ISR) and the waiting task resuming */
+    uint32_t total_cycles;      /**< cycles between kernel start and stop */
+} mtb_ml_nnlite_kernel_record_t;
+#endif
+
+#if defined(COMPONENT_U55) || \
+    defined(COMPONENT_NNLITE2)
+/**
+ * NPU profiling context of a single model invocation. Handed to the NPU driver
+ * callbacks (Ethos-U user_arg, NNLite profArg) so that concurrently running
+ * models never account each other's NPU time.
+ */
+typedef struct
+{
+    uint64_t npu_cycles;                /**< NPU cycles accumulated during the invocation */
+    uint64_t frame_start;               /**< time stamp of the last NNLite accelerator start */
+#if defined(COMPONENT_U55)
+    mtb_ml_npu_counters_t *counters;    /**< PMU counters of the invocation */
+#endif
+#if defined(COMPONENT_NNLITE2)
+    mtb_ml_nnlite_kernel_record_t *kernels;     /**< ring of kernel records, NULL if layer profiling is disabled */
+    uint32_t kernel_count;                      /**< number of kernel records written to the ring */
+    mtb_ml_nnlite_kernel_record_t current;      /**< record of the kernel in progress */
+    uint64_t accel_done;                        /**< time stamp of the last accelerator done */
+    const char *op_tag;                         /**< TFLM operator being evaluated */
+    uint16_t op_index;                          /**< index of the TFLM operator being evaluated */
+    uint16_t op_seq;                            /**< operators (kernels for TFLM_LESS) evaluated in the frame */
+    uint32_t frame;                             /**< profiled frame counter */
+#endif
+} mtb_ml_npu_prof_ctx_t;
+#endif
+
 /**
  * ML model structure
  */
@@ -101,6 +178,7 @@ typedef struct
     const uint8_t *      model_bin;     /**< the pointer of Tflite model */
     const unsigned int   model_size;    /**< the size of Tflite model */
     const int            arena_size;    /**< the size of arena buffer for Tflite model */
+    void *               owner;         /**< allocation of mtb_ml_model_bin_from_mmap(), NULL if static */
 ///@}
 #endif
 #if defined(COMPONENT_ML_TFLM_LESS)
@@ -113,6 +191,92 @@ typedef struct
 #endif
 } mtb_ml_model_bin_t;
 
+/**
+ * Distance of the input-delta gate between the new and the last inferred input
+ */
+typedef enum
+{
+    MTB_ML_INPUT_DELTA_L1 = 0,          /**< Sum of the absolute differences */
+    MTB_ML_INPUT_DELTA_MAX_ABS,         /**< Largest absolute difference */
+} mtb_ml_input_delta_metric_t;
+
+/**
+ * Input-delta gate configuration
+ */
+typedef struct
+{
+    mtb_ml_input_delta_metric_t metric; /**< Distance of the inputs */
+    float threshold;                    /**< Inference is skipped at or below this distance, in quantized steps
+                                             for int8/int16 inputs and in input values for float inputs */
+    uint32_t refresh_frames;            /**< Inference is forced after this many skipped frames in a row, 0 never */
+} mtb_ml_input_gate_config_t;
+
+/**
+ * Input-delta gate statistics
+ */
+typedef struct
+{
+    uint32_t frames;                    /**< Calls of mtb_ml_model_run() */
+    uint32_t skipped;                   /**< Frames answered with the cached output */
+    uint32_t refreshes;                 /**< Inferences forced by refresh_frames */
+    float skip_ratio;                   /**< skipped / frames */
+} mtb_ml_input_gate_stats_t;
+
+/**
+ * Input-delta gate state of a model object
+ */
+typedef struct
+{
+    bool enabled;                       /**< Gate configured */
+    bool valid;                         /**< reference holds the last inferred input */
+    mtb_ml_input_gate_config_t config;  /**< Configuration */
+    void *reference;                    /**< Copy of the last inferred input */
+    uint32_t skipped_in_row;            /**< Frames skipped since the last inference */
+    mtb_ml_input_gate_stats_t stats;    /**< Statistics */
+} mtb_ml_input_gate_t;
+
+/**
+ * Memory of one tensor of a model
+ */
+typedef struct
+{
+    int32_t index;                      /**< Tensor index in the main subgraph */
+    int32_t offset;                     /**< Offset of the data in the tensor arena, -1 if outside (weights) */
+    uint32_t bytes;                     /**< Size of the data */
+    int32_t first_use;                  /**< First operator using the tensor, -1 if unused */
+    int32_t last_use;                   /**< Last operator using the tensor, -1 if unused */
+} mtb_ml_tensor_memory_t;
+
+/**
+ * Memory report of a model object
+ */
+typedef struct
+{
+    uint32_t arena_size;                /**< Size of the tensor arena */
+    uint32_t arena_used;                /**< Bytes of the tensor arena in use */
+    uint32_t persistent_bytes;          /**< Arena tail, allocations living as long as the model */
+    uint32_t scratch_bytes;             /**< Arena head, planned tensors and kernel scratch buffers */
+    uint32_t tensor_data_bytes;         /**< Tensor structures, quantization data and variable tensor buffers */
+    uint32_t node_metadata_bytes;       /**< Node and registration array */
+    uint32_t op_data_bytes;             /**< Kernel op data and persistent buffers */
+    uint32_t resource_variable_bytes;   /**< Resource variables arena, see TFLM_RESVAR_COUNT */
+    uint32_t wrapper_heap_bytes;        /**< Heap of the middleware: model object, interpreter wrapper, own arena */
+    uint32_t operator_count;            /**< Operators of the main subgraph */
+    uint32_t tensor_count;              /**< Tensors of the main subgraph */
+} mtb_ml_memory_report_t;
+
+/**
+ * Kernels of one tensor data type, resolved once by mtb_ml_model_init()
+ */
+typedef struct
+{
+    int type_size;                      /**< sizeof(data) */
+    cy_rslt_t (*quantize)(const float *in, void *out, int size, float scale, int zero_point); /**< float to data */
+    void (*dequantize)(const void *in, float *out, int size, float scale, int zero_point);    /**< data to float */
+    int (*find_max)(const void *in, int size);  /**< index of the maximum value, -1 if invalid */
+    void (*copy)(void *dst, const void *src, int size); /**< copy of size elements */
+} mtb_ml_type_ops_t;
+
 /**
  * ML model runtime object structure
  */
@@ -132,6 +296,8 @@ typedef struct
     MTB_ML_DATA_T *input;               /**< pointer of ML inference input buffer */
     int input_type_size;                /**< sizeof(input data) */
     int output_type_size;               /**< sizeof(output data) */
+    const mtb_ml_type_ops_t *input_ops; /**< kernels of the input data type */
+    const mtb_ml_type_ops_t *output_ops;/**< kernels of the output data type */
     void *tflm_obj;                     /**< pointer of Tflite-micro runtime object */
     int model_time_steps;               /*< number of model time steps */
     int recurrent_ts_size;              /**< number of data time steps in NN. 0 if non streaming RNN */
@@ -145,7 +311,9 @@ typedef struct
     uint64_t m_cpu_sum_cycles;          /**< CPU profiling total cycles */
     uint32_t m_cpu_peak_frame;          /**< CPU profiling peak frame */
     uint64_t m_cpu_peak_cycles;         /**< CPU profiling peak cycles */
+    uint64_t m_alloc_cycles;            /**< tensor allocation cycles of mtb_ml_model_init() */
     bool is_rnn_streaming;              /**< Is the model an RNN streaming model */
+    mtb_ml_input_gate_t input_gate;     /**< input-delta gate, see mtb_ml_model_input_gate_config() */
 /**@}*/
 #if defined(COMPONENT_U55) || \
     defined(COMPONENT_NNLITE2)
@@ -157,6 +325,16 @@ typedef struct
     uint64_t m_npu_sum_cycles;      /**< NPU total cycles */
     uint32_t m_npu_peak_frame;      /**< NPU profiling peak frame */
     uint64_t m_npu_peak_cycles;     /**< NPU profiling peak cycles */
+    mtb_ml_npu_prof_ctx_t npu_prof; /**< NPU profiling context of the running invocation */
+/**@}*/
+#endif
+#if defined(COMPONENT_U55)
+/** @name COMPONENT_U55
+ *  Model runtime object fields for Ethos-U PMU event counters
+ */
+/**@{*/
+    mtb_ml_npu_counters_t npu_counters;     /**< PMU counters of the last profiled inference */
+    mtb_ml_npu_pmu_sample_t m_npu_sum_pmu;  /**< PMU counters summed over all profiled inferences */
 /**@}*/
 #endif
 #if defined(COMPONENT_ML_TFLM)
@@ -210,6 +388,55 @@ cy_rslt_t mtb_ml_model_init(const mtb_ml_model_bin_t *bin, const mtb_ml_model_bu
  */
 cy_rslt_t mtb_ml_model_deinit(mtb_ml_model_t *object);
 
+#if defined(COMPONENT_ML_TFLM)
+/**
+ * \brief : Wrap a Tflite model that is already in the address space, without copying it: a file
+ *          mapped by the application, or a model in memory-mapped (XIP) external flash on the device.
+ *          The flatbuffer is verified once here, its weights are not read.
+ *
+ * \param[in]  name       : Model name.
+ * \param[in]  data       : Tflite model, must stay mapped until mtb_ml_model_bin_free().
+ * \param[in]  size       : Size of the Tflite model.
+ * \param[in]  arena_size : Size of the tensor arena for the model.
+ * \param[out] bin        : Model binary data for mtb_ml_model_init().
+ *
+ * \return               : MTB_ML_RESULT_SUCCESS - success
+ *                       : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ *                       : MTB_ML_RESULT_ALLOC_ERR - if memory allocation failure.
+ *                       : MTB_ML_RESULT_BAD_MODEL - if the flatbuffer is not a valid Tflite model.
+ */
+cy_rslt_t mtb_ml_model_bin_from_mmap(const char *name, const void *data, size_t size, int arena_size,
+                                     mtb_ml_model_bin_t **bin);
+
+#if defined(COMPONENT_ML_HOST)
+/**
+ * \brief : Map a Tflite model file read-only and wrap it as with mtb_ml_model_bin_from_mmap()
+ *          (host build only). The model is named after the file.
+ *
+ * \param[in]  path       : Tflite model file.
+ * \param[in]  arena_size : Size of the tensor arena for the model.
+ * \param[out] bin        : Model binary data for mtb_ml_model_init().
+ *
+ * \return               : MTB_ML_RESULT_SUCCESS - success
+ *                       : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid or the file cannot be mapped.
+ *                       : otherwise - see mtb_ml_model_bin_from_mmap().
+ */
+cy_rslt_t mtb_ml_model_bin_from_file(const char *path, int arena_size, mtb_ml_model_bin_t **bin);
+#endif
+
+/**
+ * \brief : Free a model binary data of mtb_ml_model_bin_from_mmap() or mtb_ml_model_bin_from_file(),
+ *          after the deinit of its model objects. A mapped file is unmapped.
+ *
+ * \param[in] bin        : Model binary data.
+ *
+ * \return               : MTB_ML_RESULT_SUCCESS - success
+ *                       : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid, or bin was not
+ *                         created by these functions, e.g. a static mtb_ml_model_bin_t.
+ */
+cy_rslt_t mtb_ml_model_bin_free(mtb_ml_model_bin_t *bin);
+#endif
+
 /**
  * \brief : Perform NN model inference
  *
@@ -322,6 +549,49 @@ int mtb_ml_model_profile_get_tsc(uint64_t *val);
  */
 cy_rslt_t mtb_ml_model_profile_config(mtb_ml_model_t *object, mtb_ml_profile_config_t config);
 
+/**
+ * \brief : Configures the input-delta gate of a model. While enabled mtb_ml_model_run() compares
+ *          the new input with the last inferred one and keeps the cached output without
+ *          invoking the model if their distance is within the threshold. Streaming RNN
+ *          models are always invoked.
+ *
+ * \param[in] object     : Pointer of model object.
+ * \param[in] config     : Gate configuration, NULL disables the gate.
+ *
+ * \return               : MTB_ML_RESULT_SUCCESS - success
+ *                       : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ *                       : MTB_ML_RESULT_ALLOC_ERR - if memory allocation failure.
+ */
+cy_rslt_t mtb_ml_model_input_gate_config(mtb_ml_model_t *object, const mtb_ml_input_gate_config_t *config);
+
+/**
+ * \brief : Statistics of the input-delta gate of a model
+ *
+ * \param[in] object     : Pointer of model object.
+ * \param[out] stats     : Statistics record.
+ *
+ * \return               : MTB_ML_RESULT_SUCCESS - success
+ *                       : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ */
+cy_rslt_t mtb_ml_model_input_gate_get_stats(const mtb_ml_model_t *object, mtb_ml_input_gate_stats_t *stats);
+
+#if defined(COMPONENT_ML_TFLM)
+/**
+ * \brief : Memory report of a model object: the split of the tensor arena as recorded by the TFLM
+ *          allocator, the heap of the middleware and the offset, size and lifetime of the tensors.
+ *
+ * \param[in] object      : Pointer of model object.
+ * \param[out] report     : Memory report.
+ * \param[out] tensors    : Memory of the first max_tensors tensors, NULL for the report only.
+ * \param[in] max_tensors : Size of tensors, report->tensor_count gives the required size.
+ *
+ * \return               : MTB_ML_RESULT_SUCCESS - success
+ *                       : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ */
+cy_rslt_t mtb_ml_model_get_memory_report(const mtb_ml_model_t *object, mtb_ml_memory_report_t *report,
+                                         mtb_ml_tensor_memory_t *tensors, uint32_t max_tensors);
+#endif
+
 /**
  * \brief : Generate MTB ML profiling log
  *
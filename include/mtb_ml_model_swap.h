@@ -0,0 +1,212 @@
+/***************************************************************************//**
+* \file mtb_ml_model_swap.h
+*
+* \brief
+* This is the header file of the ModusToolbox ML middleware model hot-swap module
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#if !defined(__MTB_ML_MODEL_SWAP_H__)
+#define __MTB_ML_MODEL_SWAP_H__
+
+#include "mtb_ml_common.h"
+#include "mtb_ml_model.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define MTB_ML_MODEL_SWAP_SLOTS         2
+
+/******************************************************************************
+ * Structures
+******************************************************************************/
+/**
+ * Model slot of a hot-swap context
+ */
+typedef struct
+{
+    mtb_ml_model_t *model;      /**< Model object, NULL if the slot is empty */
+    volatile bool held;         /**< Output of the model handed out by mtb_ml_model_swap_run() and not yet released */
+} mtb_ml_model_swap_slot_t;
+
+/**
+ * Hot-swap statistics, in CPU cycles of mtb_ml_model_profile_get_tsc()
+ */
+typedef struct
+{
+    uint32_t frames;                /**< Frames run */
+    uint32_t dropped_frames;        /**< Frames refused because the previous output was still held */
+    uint32_t swaps;                 /**< Models swapped in */
+    uint64_t prepare_cycles;        /**< Last mtb_ml_model_swap_prepare(), off the inference path */
+    uint64_t swap_frame_cycles;     /**< Last frame that swapped, switch plus first inference of the new model */
+    uint64_t commit_to_live_cycles; /**< Last mtb_ml_model_swap_commit() until the new model ran its first frame */
+} mtb_ml_model_swap_stats_t;
+
+/**
+ * Hot-swap context of two model objects. One thread runs the frames, another one
+ * prepares and commits the next model.
+ */
+typedef struct
+{
+    mtb_ml_model_swap_slot_t slot[MTB_ML_MODEL_SWAP_SLOTS];    /**< Active and standby model */
+    volatile uint32_t active;       /**< Slot running the frames */
+    volatile bool pending;          /**< Standby model committed, swapped in at the next frame */
+    bool prepared;                  /**< Standby model prepared and not yet committed */
+    uint64_t commit_cycles;         /**< Time stamp of the last commit */
+    mtb_ml_model_swap_stats_t stats;/**< Statistics */
+} mtb_ml_model_swap_t;
+
+/*******************************************************************************
+ * Function Prototypes
+*******************************************************************************/
+/**
+ * \addtogroup Model_Swap_API
+ * @{
+ */
+/**
+ * \brief : Initializes a hot-swap context and its first model.
+ *
+ * \param[out]  swap        : Hot-swap context.
+ * \param[in]   bin         : Model binary data of the first model.
+ * \param[in]   buffer      : Working buffer of the first model, see mtb_ml_model_init().
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ *                          : otherwise - error of mtb_ml_model_init().
+ */
+cy_rslt_t mtb_ml_model_swap_init(mtb_ml_model_swap_t *swap, const mtb_ml_model_bin_t *bin,
+                                 const mtb_ml_model_buffer_t *buffer);
+
+/**
+ * \brief : Prepares the next model in the standby slot: deletes the model swapped out
+ *          before and runs mtb_ml_model_init() for the new one. Called outside of the
+ *          inference thread, frames keep running on the active model meanwhile. The
+ *          working buffer must not be the one of the active model.
+ *
+ * \param[in]   swap        : Hot-swap context.
+ * \param[in]   bin         : Model binary data of the next model.
+ * \param[in]   buffer      : Working buffer of the next model, see mtb_ml_model_init().
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ *                          : MTB_ML_RESULT_BUSY - if the last commit is not swapped in yet or
+ *                            the output of the swapped out model is still held.
+ *                          : otherwise - error of mtb_ml_model_init().
+ */
+cy_rslt_t mtb_ml_model_swap_prepare(mtb_ml_model_swap_t *swap, const mtb_ml_model_bin_t *bin,
+                                    const mtb_ml_model_buffer_t *buffer);
+
+/**
+ * \brief : Commits the prepared model. The next mtb_ml_model_swap_run() swaps it in before
+ *          its inference, a frame in progress completes on the previous model.
+ *
+ * \param[in]   swap        : Hot-swap context.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ *                          : MTB_ML_RESULT_BAD_MODEL - if no model is prepared.
+ */
+cy_rslt_t mtb_ml_model_swap_commit(mtb_ml_model_swap_t *swap);
+
+/**
+ * \brief : Runs one frame on the active model, swapping in a committed model first.
+ *          The output of the returned model stays valid until mtb_ml_model_swap_release(),
+ *          also across a swap. A frame is dropped if the output of the active model is
+ *          still held.
+ *
+ * \param[in]   swap        : Hot-swap context.
+ * \param[in]   input       : Input data, see mtb_ml_model_run().
+ * \param[out]  model       : Model that ran the frame, for mtb_ml_model_get_output().
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ *                          : MTB_ML_RESULT_BUSY - if the frame is dropped.
+ *                          : otherwise - error of mtb_ml_model_run().
+ */
+cy_rslt_t mtb_ml_model_swap_run(mtb_ml_model_swap_t *swap, MTB_ML_DATA_T *input, mtb_ml_model_t **model);
+
+/**
+ * \brief : Releases the output of a model returned by mtb_ml_model_swap_run().
+ *
+ * \param[in]   swap        : Hot-swap context.
+ * \param[in]   model       : Model returned by mtb_ml_model_swap_run().
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ */
+cy_rslt_t mtb_ml_model_swap_release(mtb_ml_model_swap_t *swap, const mtb_ml_model_t *model);
+
+/**
+ * \brief : Statistics of the hot-swap context.
+ *
+ * \param[in]   swap        : Hot-swap context.
+ * \param[out]  stats       : Statistics record.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ */
+cy_rslt_t mtb_ml_model_swap_get_stats(const mtb_ml_model_swap_t *swap, mtb_ml_model_swap_stats_t *stats);
+
+/**
+ * \brief : Prints the statistics in one line.
+ *
+ * \param[in]   stats       : Statistics record.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ */
+cy_rslt_t mtb_ml_model_swap_log(const mtb_ml_model_swap_stats_t *stats);
+
+/**
+ * \brief : Deletes both models of a hot-swap context. No frame may run meanwhile.
+ *
+ * \param[in]   swap        : Hot-swap context.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ */
+cy_rslt_t mtb_ml_model_swap_deinit(mtb_ml_model_swap_t *swap);
+
+/**
+ * @} end of Model_Swap_API group
+ */
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __MTB_ML_MODEL_SWAP_H__ */
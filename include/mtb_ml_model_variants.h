@@ -0,0 +1,194 @@
+/***************************************************************************//**
+* \file mtb_ml_model_variants.h
+*
+* \brief
+* This is the header file of the ModusToolbox ML middleware model variants module
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#if !defined(__MTB_ML_MODEL_VARIANTS_H__)
+#define __MTB_ML_MODEL_VARIANTS_H__
+
+#include "mtb_ml_common.h"
+#include "mtb_ml_model.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#ifndef MTB_ML_MODEL_VARIANTS_MAX
+/* Quantization variants of a model, e.g. int16x8, int8x8 and float */
+#define MTB_ML_MODEL_VARIANTS_MAX       (3)
+#endif
+
+#ifndef MTB_ML_MODEL_VARIANTS_EWMA_SHIFT
+/* Weight 1/2^shift of a new inference in the latency estimate */
+#define MTB_ML_MODEL_VARIANTS_EWMA_SHIFT    (3)
+#endif
+
+/******************************************************************************
+ * Structures
+******************************************************************************/
+/**
+ * Quantization variant of a model
+ */
+typedef struct
+{
+    const mtb_ml_model_bin_t *bin;          /**< Model binary data */
+    const mtb_ml_model_buffer_t *buffer;    /**< Working buffer, NULL to allocate, see mtb_ml_model_init() */
+} mtb_ml_model_variant_desc_t;
+
+/**
+ * Variant statistics, in CPU cycles of mtb_ml_model_profile_get_tsc()
+ */
+typedef struct
+{
+    uint32_t frames;                                /**< Frames run */
+    uint32_t switches;                              /**< Variant changes between frames */
+    uint32_t over_budget;                           /**< Frames that took longer than the budget */
+    uint32_t active;                                /**< Variant of the last frame */
+    uint32_t runs[MTB_ML_MODEL_VARIANTS_MAX];       /**< Frames run per variant */
+    uint64_t est_cycles[MTB_ML_MODEL_VARIANTS_MAX]; /**< Latency estimate per variant */
+    uint64_t min_cycles[MTB_ML_MODEL_VARIANTS_MAX]; /**< Lowest latency per variant, its cost without load */
+} mtb_ml_model_variants_stats_t;
+
+/**
+ * Quantization variants of one model, ordered from the most accurate to the cheapest
+ */
+typedef struct
+{
+    mtb_ml_model_t *model[MTB_ML_MODEL_VARIANTS_MAX];   /**< Model object per variant */
+    uint32_t count;                                     /**< Number of variants */
+    uint64_t budget_cycles;                             /**< Latency budget of a frame */
+    void *input;                                        /**< Quantized input of the selected variant */
+    mtb_ml_model_variants_stats_t stats;                /**< Statistics */
+} mtb_ml_model_variants_t;
+
+/*******************************************************************************
+ * Function Prototypes
+*******************************************************************************/
+/**
+ * \addtogroup Model_Variants_API
+ * @{
+ */
+/**
+ * \brief : Creates the model objects of all variants. The variants must have the same input and
+ *          output shapes and are listed from the most accurate to the cheapest. The latency
+ *          estimates start from the model profiling averages if profiling ran before.
+ *
+ * \param[out]  set         : Variant set.
+ * \param[in]   variants    : Variant descriptors.
+ * \param[in]   count       : Number of variants, up to MTB_ML_MODEL_VARIANTS_MAX.
+ * \param[in]   budget_cycles : Latency budget of a frame, see mtb_ml_model_profile_get_tsc().
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid, or in a build with
+ *                            a COMPONENT_ML_<type> if a variant is not of that type.
+ *                          : MTB_ML_RESULT_ALLOC_ERR - if memory allocation failure.
+ *                          : MTB_ML_RESULT_INPUT_ERROR - if the variant shapes differ.
+ *                          : otherwise - error of mtb_ml_model_init().
+ */
+cy_rslt_t mtb_ml_model_variants_init(mtb_ml_model_variants_t *set, const mtb_ml_model_variant_desc_t *variants,
+                                     uint32_t count, uint64_t budget_cycles);
+
+/**
+ * \brief : Changes the latency budget, it applies from the next frame.
+ *
+ * \param[in]   set         : Variant set.
+ * \param[in]   budget_cycles : Latency budget of a frame.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ */
+cy_rslt_t mtb_ml_model_variants_set_budget(mtb_ml_model_variants_t *set, uint64_t budget_cycles);
+
+/**
+ * \brief : Runs one frame on the most accurate variant expected to meet the budget. The
+ *          expectation scales the unloaded cost of each variant with the current load, as
+ *          measured on the variant in use. The variant only changes between frames.
+ *
+ * \param[in]   set         : Variant set.
+ * \param[in]   input       : Float input, quantized with the scale and zero point of the variant.
+ * \param[out]  model       : Model that ran the frame. Optional.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ *                          : otherwise - error of mtb_ml_model_run().
+ */
+cy_rslt_t mtb_ml_model_variants_run(mtb_ml_model_variants_t *set, const float *input, mtb_ml_model_t **model);
+
+/**
+ * \brief : Output of the last frame, dequantized with the scale and zero point of the
+ *          variant that ran it, so that post-processing does not depend on the variant.
+ *
+ * \param[in]   set         : Variant set.
+ * \param[out]  output      : output_size float values.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ */
+cy_rslt_t mtb_ml_model_variants_get_output(const mtb_ml_model_variants_t *set, float *output);
+
+/**
+ * \brief : Statistics of the variant set.
+ *
+ * \param[in]   set         : Variant set.
+ * \param[out]  stats       : Statistics record.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ */
+cy_rslt_t mtb_ml_model_variants_get_stats(const mtb_ml_model_variants_t *set, mtb_ml_model_variants_stats_t *stats);
+
+/**
+ * \brief : Deletes the model objects of all variants.
+ *
+ * \param[in]   set         : Variant set.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ */
+cy_rslt_t mtb_ml_model_variants_deinit(mtb_ml_model_variants_t *set);
+
+/**
+ * @} end of Model_Variants_API group
+ */
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __MTB_ML_MODEL_VARIANTS_H__ */
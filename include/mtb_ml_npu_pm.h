@@ -0,0 +1,187 @@
+/***************************************************************************//**
+* \file mtb_ml_npu_pm.h
+*
+* \brief
+* This is the header file of ModusToolbox ML middleware NPU power manager
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#if !defined(__MTB_ML_NPU_PM_H__)
+#define __MTB_ML_NPU_PM_H__
+
+#include "mtb_ml_common.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Idle timeout disabling power gating, the NPU stays powered between inferences */
+#define MTB_ML_NPU_PM_ALWAYS_ON     (0)
+
+/******************************************************************************
+ * Typedefs
+ *****************************************************************************/
+/**
+ * NPU power states
+ */
+typedef enum
+{
+    MTB_ML_NPU_PM_OFF = 0,      /**< NPU is powered down */
+    MTB_ML_NPU_PM_IDLE,         /**< NPU is powered, no inference in progress */
+    MTB_ML_NPU_PM_ACTIVE        /**< NPU is powered, at least one user holds it */
+} mtb_ml_npu_pm_state_t;
+
+/**
+ * Power controller operations. The state machine has no hardware
+ * dependencies, so a simulated controller can drive it on the host.
+ */
+typedef struct
+{
+    cy_rslt_t (*power_on)(void *arg);       /**< Power the NPU up and restore its driver state */
+    void (*power_off)(void *arg);           /**< Power the NPU down */
+    uint32_t (*get_time_ms)(void *arg);     /**< Time base of the idle timeout, NULL disables power gating */
+    uint64_t (*get_cycles)(void *arg);      /**< Optional time base of the wake latency */
+    void (*lock)(void *arg);                /**< Optional lock of the state machine */
+    void (*unlock)(void *arg);              /**< Optional unlock of the state machine */
+    bool (*try_lock)(void *arg);            /**< Optional non-blocking lock of mtb_ml_npu_pm_process(), false if held */
+    void *arg;                              /**< Argument passed to all operations */
+} mtb_ml_npu_pm_ops_t;
+
+/**
+ * Power manager statistics
+ */
+typedef struct
+{
+    uint32_t wake_count;        /**< Power ups on acquire */
+    uint32_t off_count;         /**< Power downs after the idle timeout */
+    uint64_t last_wake_cycles;  /**< Latency added by the last power up */
+    uint64_t max_wake_cycles;   /**< Largest power up latency */
+    uint64_t sum_wake_cycles;   /**< Sum of power up latencies */
+} mtb_ml_npu_pm_stats_t;
+
+/**
+ * NPU power manager object
+ */
+typedef struct
+{
+    const mtb_ml_npu_pm_ops_t *ops;
+    mtb_ml_npu_pm_state_t state;
+    uint32_t idle_timeout_ms;
+    uint32_t users;
+    uint32_t idle_since_ms;
+    mtb_ml_npu_pm_stats_t stats;
+} mtb_ml_npu_pm_t;
+
+/******************************************************************************
+ * Public definitions
+ *****************************************************************************/
+
+/**
+ * \addtogroup NPU_PM_API
+ * @{
+ */
+
+/**
+ * \brief : Initialize the power manager of an NPU that is already powered
+ *
+ * \param[out] pm        : Pointer of power manager object
+ * \param[in] ops        : Power controller operations
+ * \param[in] idle_timeout_ms : Idle time before the NPU is powered down, MTB_ML_NPU_PM_ALWAYS_ON to keep it powered
+ *
+ * \return               : MTB_ML_RESULT_SUCCESS - success
+ *                       : MTB_ML_RESULT_BAD_ARG - if an input parameter is invalid.
+ */
+cy_rslt_t mtb_ml_npu_pm_init(mtb_ml_npu_pm_t *pm, const mtb_ml_npu_pm_ops_t *ops, uint32_t idle_timeout_ms);
+
+/**
+ * \brief : Change the idle timeout
+ *
+ * \param[in] pm         : Pointer of power manager object
+ * \param[in] idle_timeout_ms : Idle time before the NPU is powered down, MTB_ML_NPU_PM_ALWAYS_ON to keep it powered
+ */
+void mtb_ml_npu_pm_set_idle_timeout(mtb_ml_npu_pm_t *pm, uint32_t idle_timeout_ms);
+
+/**
+ * \brief : Take the NPU for an inference, powering it up if needed
+ *
+ * \param[in] pm         : Pointer of power manager object
+ *
+ * \return               : MTB_ML_RESULT_SUCCESS - success
+ *                       : MTB_ML_RESULT_BAD_ARG - if an input parameter is invalid.
+ *                       : MTB_ML_RESULT_NPU_INIT_ERROR - if the NPU failed to power up.
+ */
+cy_rslt_t mtb_ml_npu_pm_acquire(mtb_ml_npu_pm_t *pm);
+
+/**
+ * \brief : Return the NPU after an inference and start its idle period
+ *
+ * \param[in] pm         : Pointer of power manager object
+ */
+void mtb_ml_npu_pm_release(mtb_ml_npu_pm_t *pm);
+
+/**
+ * \brief : Power the NPU down if its idle timeout has expired. With a try_lock operation the call
+ *          never blocks: if the state machine is held it returns false and the caller retries on
+ *          its next tick. Without one it takes the blocking lock, so it must then be called from a
+ *          context that may block, e.g. a task and not an RTOS timer callback.
+ *
+ * \param[in] pm         : Pointer of power manager object
+ * \param[out] idle_left_ms : Optional, idle time left before the power down when it is deferred,
+ *                         e.g. by a timer firing early on tick rounding, 0 otherwise
+ *
+ * \return               : true if the NPU was powered down by this call
+ */
+bool mtb_ml_npu_pm_process(mtb_ml_npu_pm_t *pm, uint32_t *idle_left_ms);
+
+/**
+ * \brief : Power the NPU down unconditionally, e.g. before deinitialization
+ *
+ * \param[in] pm         : Pointer of power manager object
+ *
+ * \return               : MTB_ML_RESULT_SUCCESS - success
+ *                       : MTB_ML_RESULT_BAD_ARG - if the NPU is in use.
+ */
+cy_rslt_t mtb_ml_npu_pm_suspend(mtb_ml_npu_pm_t *pm);
+
+/**
+ * @} end of NPU_PM_API group
+ */
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __MTB_ML_NPU_PM_H__ */
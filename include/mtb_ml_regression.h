@@ -0,0 +1,189 @@
+/***************************************************************************//**
+* \file mtb_ml_regression.h
+*
+* \brief
+* This is the header file of the ModusToolbox ML middleware regression module
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#if !defined(__MTB_ML_REGRESSION_H__)
+#define __MTB_ML_REGRESSION_H__
+
+#include "mtb_ml_common.h"
+#include "mtb_ml_dataset.h"
+#include "mtb_ml_dataset_reader.h"
+#include "mtb_ml_model.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Typedefs
+ *****************************************************************************/
+
+/******************************************************************************
+ * Structures
+******************************************************************************/
+/**
+ * Regression summary, errors in the dequantized output domain
+ */
+typedef struct
+{
+    uint32_t samples;           /**< Samples evaluated */
+    uint32_t correct;           /**< Samples whose top-1 output matches the reference */
+    float accuracy;             /**< correct / samples */
+    float max_abs_error;        /**< Largest absolute error of any output */
+    float mean_abs_error;       /**< Mean absolute error over all outputs */
+    uint32_t max_error_sample;  /**< Sample of max_abs_error */
+    uint64_t infer_cycles;      /**< Inference cycles, see mtb_ml_model_profile_get_tsc() */
+} mtb_ml_regression_summary_t;
+
+/**
+ * Regression context, accumulates the samples added in chunks
+ */
+typedef struct
+{
+    mtb_ml_model_t *model;              /**< Model under test */
+    mtb_ml_x_data_type_t y_type;        /**< MTB_ML_X_DATA_FLOAT32 for dequantized references, else the model output type */
+    double abs_error_sum;               /**< Sum of the absolute errors */
+    uint64_t outputs;                   /**< Outputs compared */
+    mtb_ml_regression_summary_t summary;/**< Running summary */
+} mtb_ml_regression_t;
+
+/*******************************************************************************
+ * Function Prototypes
+*******************************************************************************/
+/**
+ * \addtogroup Regression_API
+ * @{
+ */
+/**
+ * \brief : Starts a regression of a model against reference outputs.
+ *
+ * \param[out]  ctx         : Regression context.
+ * \param[in]   model       : Initialized model object.
+ * \param[in]   y_type      : Type of the reference outputs, MTB_ML_X_DATA_FLOAT32 for dequantized
+ *                            values or the quantized model output type.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ *                          : MTB_ML_RESULT_MISMATCH_DATA_TYPE - if a quantized y_type does not have
+ *                            the element size of the model output.
+ */
+cy_rslt_t mtb_ml_regression_init(mtb_ml_regression_t *ctx, mtb_ml_model_t *model, mtb_ml_x_data_type_t y_type);
+
+/**
+ * \brief : Runs a chunk of samples, e.g. received in bulk from the host, and compares their
+ *          outputs with the references. Streaming RNN samples are run slice by slice from a
+ *          reset state and compared after the last slice.
+ *
+ * \param[in]   ctx         : Regression context.
+ * \param[in]   x_info      : Header of the x data the samples belong to.
+ * \param[in]   x_samples   : count samples of x_info->input_size values each.
+ * \param[in]   y_samples   : count references of model->output_size values each.
+ * \param[in]   count       : Number of samples.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ *                          : MTB_ML_RESULT_INPUT_ERROR - if the x data does not match the model.
+ *                          : otherwise - error of mtb_ml_model_run().
+ */
+cy_rslt_t mtb_ml_regression_add(mtb_ml_regression_t *ctx, const mtb_ml_x_file_header_t *x_info,
+                                const void *x_samples, const void *y_samples, uint32_t count);
+
+/**
+ * \brief : Summary of the samples added so far.
+ *
+ * \param[in]   ctx         : Regression context.
+ * \param[out]  summary     : Summary record.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ */
+cy_rslt_t mtb_ml_regression_get_summary(const mtb_ml_regression_t *ctx, mtb_ml_regression_summary_t *summary);
+
+/**
+ * \brief : Runs a whole dataset, e.g. the embedded MTB_ML_MODEL_X_DATA_BIN and
+ *          MTB_ML_MODEL_Y_DATA_BIN blobs, and returns its summary.
+ *
+ * \param[in]   model       : Initialized model object.
+ * \param[in]   x_data      : x data blob, a mtb_ml_x_file_header_t followed by the samples.
+ * \param[in]   x_size      : Bytes of x_data.
+ * \param[in]   y_data      : Reference results of all samples, optionally starting with a
+ *                            mtb_ml_y_file_header_t.
+ * \param[in]   y_size      : Bytes of y_data.
+ * \param[in]   y_type      : Type of reference results without header, see mtb_ml_regression_init().
+ * \param[out]  summary     : Summary record.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ *                          : otherwise - see mtb_ml_dataset_open() and mtb_ml_regression_run_dataset().
+ */
+cy_rslt_t mtb_ml_regression_run(mtb_ml_model_t *model, const void *x_data, size_t x_size,
+                                const void *y_data, size_t y_size, mtb_ml_x_data_type_t y_type,
+                                mtb_ml_regression_summary_t *summary);
+
+/**
+ * \brief : Runs an opened dataset with reference results and returns its summary.
+ *
+ * \param[in]   model       : Initialized model object.
+ * \param[in]   dataset     : Dataset, validated against the model first.
+ * \param[out]  summary     : Summary record.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ *                          : otherwise - see mtb_ml_dataset_validate() and mtb_ml_regression_add().
+ */
+cy_rslt_t mtb_ml_regression_run_dataset(mtb_ml_model_t *model, mtb_ml_dataset_t *dataset,
+                                        mtb_ml_regression_summary_t *summary);
+
+/**
+ * \brief : Prints a summary record in one line.
+ *
+ * \param[in]   summary     : Summary record.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ */
+cy_rslt_t mtb_ml_regression_log(const mtb_ml_regression_summary_t *summary);
+
+/**
+ * @} end of Regression_API group
+ */
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __MTB_ML_REGRESSION_H__ */
@@ -0,0 +1,190 @@
+/***************************************************************************//**
+* \file mtb_ml_scheduler.h
+*
+* \brief
+* This is the header file of the ModusToolbox ML middleware deadline scheduler module
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#if !defined(__MTB_ML_SCHEDULER_H__)
+#define __MTB_ML_SCHEDULER_H__
+
+#include "mtb_ml_common.h"
+#include "mtb_ml_model.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#ifndef MTB_ML_SCHEDULER_EWMA_SHIFT
+/* Weight 1/2^shift of a new inference in the latency estimate */
+#define MTB_ML_SCHEDULER_EWMA_SHIFT     (3)
+#endif
+
+/******************************************************************************
+ * Typedefs
+ *****************************************************************************/
+/**
+ * Outcome of a frame submitted to the scheduler
+ */
+typedef enum
+{
+    MTB_ML_SCHEDULER_RUN = 0,           /**< Primary model ran */
+    MTB_ML_SCHEDULER_RUN_FALLBACK,      /**< Fallback model ran, the primary would miss the deadline */
+    MTB_ML_SCHEDULER_DROPPED_LATE,      /**< Dropped, no model could finish before the deadline */
+    MTB_ML_SCHEDULER_DECIMATED,         /**< Dropped by the decimation of an overloaded system */
+} mtb_ml_scheduler_decision_t;
+
+/******************************************************************************
+ * Structures
+******************************************************************************/
+/**
+ * Scheduler configuration, times in CPU cycles of mtb_ml_model_profile_get_tsc()
+ */
+typedef struct
+{
+    uint64_t deadline_cycles;           /**< Bound of the latency from the frame arrival to its output */
+    mtb_ml_model_t *fallback;           /**< Cheaper model with the same input size and type, NULL if none */
+    uint32_t max_decimation;            /**< Largest decimation factor, 0 or 1 never decimates */
+    uint32_t recover_frames;            /**< Frames in time before the decimation factor is halved */
+} mtb_ml_scheduler_config_t;
+
+/**
+ * Scheduler statistics, in CPU cycles of mtb_ml_model_profile_get_tsc()
+ */
+typedef struct
+{
+    uint32_t frames;                    /**< Frames submitted */
+    uint32_t runs;                      /**< Frames run by the primary model */
+    uint32_t fallback_runs;             /**< Frames run by the fallback model */
+    uint32_t dropped_late;              /**< Frames dropped because of the deadline */
+    uint32_t decimated;                 /**< Frames dropped by the decimation */
+    uint32_t deadline_misses;           /**< Frames run that completed after the deadline */
+    uint32_t decimation;                /**< Current decimation factor */
+    uint64_t est_cycles;                /**< Latency estimate of the primary model */
+    uint64_t est_fallback_cycles;       /**< Latency estimate of the fallback model */
+    uint64_t max_latency_cycles;        /**< Largest latency of a frame run */
+} mtb_ml_scheduler_stats_t;
+
+/**
+ * Deadline-aware scheduler of one model with an optional fallback
+ */
+typedef struct
+{
+    mtb_ml_model_t *model;              /**< Primary model */
+    mtb_ml_scheduler_config_t config;   /**< Configuration */
+    uint32_t phase;                     /**< Frame counter of the decimation */
+    uint32_t in_time;                   /**< Frames in time since the last overload */
+    uint64_t min_cycles;                /**< Fastest latency of the primary model, floor of its estimate */
+    uint64_t min_fallback_cycles;       /**< Fastest latency of the fallback model */
+    mtb_ml_scheduler_stats_t stats;     /**< Statistics */
+} mtb_ml_scheduler_t;
+
+/*******************************************************************************
+ * Function Prototypes
+*******************************************************************************/
+/**
+ * \addtogroup Scheduler_API
+ * @{
+ */
+/**
+ * \brief : Initializes a scheduler. The latency estimates start from the model profiling
+ *          averages if profiling ran before, see mtb_ml_model_profile_config().
+ *
+ * \param[out]  sched       : Scheduler context.
+ * \param[in]   model       : Primary model object.
+ * \param[in]   config      : Configuration.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ *                          : MTB_ML_RESULT_INPUT_ERROR - if the input of the fallback model differs
+ *                            in size or type from the input of the primary model.
+ */
+cy_rslt_t mtb_ml_scheduler_init(mtb_ml_scheduler_t *sched, mtb_ml_model_t *model,
+                                const mtb_ml_scheduler_config_t *config);
+
+/**
+ * \brief : Submits a frame. It runs on the primary model if the estimated completion is
+ *          within the deadline, else on the fallback model if that one makes it, else it is
+ *          dropped. Dropped frames and deadline misses raise the decimation factor, frames
+ *          in time lower it again. The estimate of a model skipped for a frame decays toward
+ *          its fastest latency, so that a transient spike does not keep it out. Frames
+ *          skipped by the input gate of the model, see mtb_ml_model_input_gate_config(),
+ *          count as run but leave the latency estimate unchanged.
+ *
+ * \param[in]   sched       : Scheduler context.
+ * \param[in]   input       : Input data of the frame.
+ * \param[in]   arrival     : Time stamp of the frame arrival, see mtb_ml_model_profile_get_tsc().
+ * \param[out]  decision    : Outcome of the frame.
+ * \param[out]  model       : Model that ran the frame, NULL if dropped. Optional.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success, also for dropped frames
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ *                          : otherwise - error of mtb_ml_model_run().
+ */
+cy_rslt_t mtb_ml_scheduler_submit(mtb_ml_scheduler_t *sched, MTB_ML_DATA_T *input, uint64_t arrival,
+                                  mtb_ml_scheduler_decision_t *decision, mtb_ml_model_t **model);
+
+/**
+ * \brief : Statistics of the scheduler.
+ *
+ * \param[in]   sched       : Scheduler context.
+ * \param[out]  stats       : Statistics record.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ */
+cy_rslt_t mtb_ml_scheduler_get_stats(const mtb_ml_scheduler_t *sched, mtb_ml_scheduler_stats_t *stats);
+
+/**
+ * \brief : Prints the statistics in one line.
+ *
+ * \param[in]   stats       : Statistics record.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ */
+cy_rslt_t mtb_ml_scheduler_log(const mtb_ml_scheduler_stats_t *stats);
+
+/**
+ * @} end of Scheduler_API group
+ */
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __MTB_ML_SCHEDULER_H__ */
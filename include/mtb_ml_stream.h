@@ -49,7 +49,9 @@
 extern "C" {
 #endif
 
-#if !defined(COMPONENT_MTB_HAL)
+#if defined(COMPONENT_ML_HOST)
+/* Linux host build, transports are file descriptor based */
+#elif !defined(COMPONENT_MTB_HAL)
 #include "cyhal.h"
 #else
 #include "mtb_hal.h"
@@ -66,6 +68,40 @@ extern "C" {
 /******************************************************************************
 * Macros
 *****************************************************************************/
+#ifndef MTB_ML_STREAM_UART_ASYNC
+/* 1 - UART transfers use HAL async transfers completing through mtb_ml_stream_cb(),
+ * on the dedicated UART of mtb_ml_stream_config_t,
+ * 0 - UART is polled. Ignored with COMPONENT_MTB_HAL, which is always polled. */
+#define MTB_ML_STREAM_UART_ASYNC        (0)
+#endif
+
+#ifndef MTB_ML_STREAM_UART_DMA
+/* 1 - async UART transfers use DMA instead of the UART interrupt */
+#define MTB_ML_STREAM_UART_DMA          (0)
+#endif
+
+#ifndef MTB_ML_STREAM_UART_IRQ_PRIORITY
+#define MTB_ML_STREAM_UART_IRQ_PRIORITY (3)
+#endif
+
+/* Frame payload codecs of protocol v2, see mtb_ml_stream_config_t */
+#define MTB_ML_STREAM_CODEC_DELTA16     (1UL << 0)  /**< Delta and zig-zag varint of int16 samples */
+#define MTB_ML_STREAM_CODEC_LZ4         (1UL << 1)  /**< LZ4 block format */
+
+/* Result reductions of protocol v2, see mtb_ml_stream_config_t */
+#define MTB_ML_STREAM_OUTPUT_FULL       (0)         /**< Whole output tensor of each frame */
+#define MTB_ML_STREAM_OUTPUT_TOPK       (1)         /**< Indices and scores of the top_k largest outputs */
+#define MTB_ML_STREAM_OUTPUT_HASH       (2)         /**< 64-bit FNV-1a hash of the output tensor, for bit-exact regression */
+
+#ifndef MTB_ML_STREAM_CODEC_MARGIN
+/* Bytes kept past a batch in the receive buffer so that coded frames decode in place */
+#define MTB_ML_STREAM_CODEC_MARGIN  (32)
+#endif
+
+#ifndef MTB_ML_STREAM_V2_RETRIES
+/* Resend requests of a v2 batch failing its CRC check */
+#define MTB_ML_STREAM_V2_RETRIES    (3)
+#endif
 
 /*******************************************************************************
 * extern variables
@@ -99,12 +135,22 @@ typedef cy_rslt_t (* mtb_data_streaming_receive_t)(mtb_data_streaming_vcontext_t
 */
 typedef void (* mtb_data_streaming_xfer_done_t)(void* tag, cy_rslt_t rslt);
 
+/**
+ * Streaming wait, blocks until the async transfer of tag (mtb_ml_stream_tag_t) in direction tx
+ * completes, a timeout of 0 waits forever. Returns MTB_ML_RESULT_TIMEOUT if it did not complete.
+*/
+typedef cy_rslt_t (* mtb_data_streaming_wait_t)(mtb_data_streaming_vcontext_t* context,
+                                                void* tag, bool tx, uint32_t timeout_ms);
+
 /**
  * Streaming obj
 */
 typedef struct
 {
-#if !defined(COMPONENT_MTB_HAL)
+#if defined(COMPONENT_ML_HOST)
+    int                                 fd;      /**< socket or pty master descriptor */
+    int                                 peer_fd; /**< pty slave kept open while the host peer attaches */
+#elif !defined(COMPONENT_MTB_HAL)
     cyhal_uart_t*                       uart; /**< uart handle */
 #else
     mtb_hal_uart_t*                     uart; /**< uart handle */
@@ -129,10 +175,26 @@ typedef struct
 {
     mtb_data_streaming_send_t send;         /**< Function to send data to a host device. */
     mtb_data_streaming_receive_t receive;   /**< Function to receive data from a host device. */
+    mtb_data_streaming_send_t send_async;   /**< Optional, starts sending, tag (mtb_ml_stream_tag_t) completes through the context callback */
+    mtb_data_streaming_receive_t receive_async; /**< Optional, starts receiving, tag (mtb_ml_stream_tag_t) completes through the context callback */
+    mtb_data_streaming_wait_t wait;         /**< Optional, blocks until an async transfer completes, polled without */
     mtb_data_streaming_vcontext_t context;  /**< Context data for performing operations. */
 } mtb_data_streaming_interface_t;
 
 
+/**
+ * Stream transport
+*/
+typedef struct
+{
+    const char *name;                       /**< Transport name reported in statistics */
+    mtb_data_streaming_send_t send;         /**< Function to send data to a host device. */
+    mtb_data_streaming_receive_t receive;   /**< Function to receive data from a host device. */
+    mtb_data_streaming_send_t send_async;   /**< Optional function to start sending data to a host device. */
+    mtb_data_streaming_receive_t receive_async; /**< Optional function to start receiving data from a host device. */
+    mtb_data_streaming_wait_t wait;         /**< Optional function to wait for the completion of an async transfer. */
+} mtb_ml_stream_transport_t;
+
 /**
  * Stream tag
 */
@@ -140,9 +202,50 @@ typedef struct
 {
     bool stream_done;           /**< Flag set/reset to track status of stream */
     cy_rslt_t stream_status;    /**< Status of stream event */
+    uint64_t done_cycles;       /**< Completion time, see mtb_ml_model_profile_get_tsc() */
 } mtb_ml_stream_tag_t;
 
 
+/**
+ * Stream transfer statistics
+ */
+typedef struct
+{
+    uint64_t tx_bytes;          /**< Bytes sent to host */
+    uint64_t tx_cycles;         /**< CPU cycles spent sending, see mtb_ml_model_profile_get_tsc() */
+    uint64_t rx_bytes;          /**< Bytes received from host */
+    uint64_t rx_cycles;         /**< CPU cycles spent receiving, including waiting for the host */
+} mtb_ml_stream_stats_t;
+
+/**
+ * Stream runner statistics, in CPU cycles of mtb_ml_model_profile_get_tsc()
+ */
+typedef struct
+{
+    uint32_t frames;            /**< Frames inferred */
+    uint64_t wall_cycles;       /**< Whole run */
+    uint64_t infer_cycles;      /**< Spent in mtb_ml_model_run() */
+    uint64_t rx_busy_cycles;    /**< Link busy receiving frames, overlapping inference */
+    uint64_t tx_busy_cycles;    /**< Link busy sending results, overlapping inference */
+    uint64_t stall_cycles;      /**< CPU waiting for the link */
+} mtb_ml_stream_runner_stats_t;
+
+/**
+ * Stream configuration
+ */
+typedef struct
+{
+    uint32_t batch_frames;      /**< Frames per request of protocol v2, 0 or 1 keeps protocol v1 unless output_mode is reduced */
+    size_t rx_buffer_size;      /**< Bytes available for a batch of input frames, limits batch_frames */
+    const mtb_ml_stream_transport_t *transport; /**< Transport registered on interface_obj, NULL selects the retarget-io UART */
+    uint32_t codecs;            /**< MTB_ML_STREAM_CODEC_* offered to the host for input frames (protocol v2), 0 keeps raw frames */
+    uint32_t output_mode;       /**< MTB_ML_STREAM_OUTPUT_* offered to the host for results (protocol v2) */
+    uint32_t top_k;             /**< Results per frame of MTB_ML_STREAM_OUTPUT_TOPK, up to 32 */
+#if MTB_ML_STREAM_UART_ASYNC && !defined(COMPONENT_ML_HOST) && !defined(COMPONENT_MTB_HAL)
+    cyhal_uart_t *uart;         /**< UART of the async transport, initialized by the application, not the retarget-io one */
+#endif
+} mtb_ml_stream_config_t;
+
 /**
  * Stream interface
  */
@@ -153,6 +256,20 @@ typedef struct
     mtb_ml_x_file_header_t x_data_info;             /**< x data info retrieved from host */
     size_t input_size;                              /**< Size of input data buffer, set to model object input size */
     size_t output_size;                             /**< Size of output data buffer, set to model object output size */
+    mtb_ml_x_data_type_t output_data_type;          /**< Element type of the results, from the model output */
+    size_t output_type_bytes;                       /**< Bytes of one result element, from the model output */
+    uint32_t protocol_version;                      /**< Negotiated protocol, 1 or 2 */
+    uint32_t batch_frames;                          /**< Negotiated frames per batch (protocol v2) */
+    uint32_t seq;                                   /**< Sequence number of the next batch (protocol v2) */
+    uint32_t codec;                                 /**< Negotiated MTB_ML_STREAM_CODEC_* of input frames, 0 for raw frames */
+    uint32_t rx_slack;                              /**< Bytes of the receive buffer past a full batch (protocol v2) */
+    uint32_t output_mode;                           /**< Negotiated MTB_ML_STREAM_OUTPUT_* of results */
+    uint32_t top_k;                                 /**< Negotiated results per frame of MTB_ML_STREAM_OUTPUT_TOPK */
+    const void *sent_results;                       /**< Full results of the last reduced batch, resent on request of the host */
+    uint32_t sent_results_seq;                      /**< Sequence number of sent_results */
+    uint32_t sent_results_frames;                   /**< Frames of sent_results */
+    const char *transport_name;                     /**< Name of the transport in use */
+    mtb_ml_stream_stats_t stats;                    /**< Transfer statistics */
 } mtb_ml_stream_interface_t;
 
 /*******************************************************************************
@@ -177,11 +294,28 @@ typedef struct
  */
 cy_rslt_t mtb_ml_stream_init(mtb_ml_stream_interface_t *interface,
                             const mtb_ml_model_t *model_object);
+/**
+ * \brief : Prepare for data streaming as mtb_ml_stream_init() and negotiate the batched
+ *          protocol v2 with the host.
+ *
+ * \param[in]   interface       :   Stream interface provided by user.
+ * \param[in]   model_object    :   Model object associated with interface.
+ * \param[in]   config          :   Stream configuration, NULL keeps protocol v1. The batch size
+ *                                  is limited to the frames fitting into config->rx_buffer_size
+ *                                  and could be lowered by the host. interface->batch_frames
+ *                                  holds the negotiated value.
+ * \return                      :   MTB_ML_RESULT_SUCCESS - success
+ *                              :   otherwise - check the return value for detail.
+ */
+cy_rslt_t mtb_ml_stream_init_ex(mtb_ml_stream_interface_t *interface,
+                                const mtb_ml_model_t *model_object,
+                                const mtb_ml_stream_config_t *config);
 /**
  * \brief : Streams output test data via interface.
  *
  * \param[in]   interface   :   Stream interface provided by user. Used to stream output data.
- * \param[in]   tx_buf      :   Transmit buffer. Assumed to be of size interface->output_size.
+ * \param[in]   tx_buf      :   Transmit buffer. Assumed to hold interface->output_size elements of
+ *                              interface->output_type_bytes.
  * \param[in]   timeout_ms  :   Timeout in milliseconds. Value of 0 means attempt to transmit data
  *                              forever.
  * \return                  :   MTB_ML_RESULT_SUCCESS - success
@@ -203,6 +337,75 @@ cy_rslt_t mtb_ml_stream_output_data(mtb_ml_stream_interface_t *interface,
 cy_rslt_t mtb_ml_stream_input_data( mtb_ml_stream_interface_t *interface,
                                     void *rx_buf,
                                     uint32_t timeout_ms);
+/**
+ * \brief : Streams a batch of input frames via interface (protocol v2).
+ *
+ * \param[in]   interface   :   Stream interface provided by user.
+ * \param[in]   rx_buf      :   Receive buffer. Assumed to hold interface->batch_frames frames.
+ * \param[out]  frames      :   Number of frames received, lower than interface->batch_frames
+ *                              at the end of the dataset.
+ * \param[in]   timeout_ms  :   Timeout in milliseconds. Value of 0 means attempt to receive data
+ *                              forever.
+ * \return                  :   MTB_ML_RESULT_SUCCESS - success
+ *                          :   MTB_ML_RESULT_COMM_ERROR - protocol error or CRC still failing after
+ *                              MTB_ML_STREAM_V2_RETRIES resends.
+ *                          :   otherwise - check the return value for detail.
+ */
+cy_rslt_t mtb_ml_stream_input_batch(mtb_ml_stream_interface_t *interface,
+                                    void *rx_buf,
+                                    uint32_t *frames,
+                                    uint32_t timeout_ms);
+/**
+ * \brief : Streams a batch of output results via interface (protocol v2). With a reduced
+ *          interface->output_mode only the top-k or the hash of each result is sent, the host
+ *          asks for the full results of a mismatching batch with the next frame request.
+ *
+ * \param[in]   interface   :   Stream interface provided by user.
+ * \param[in]   tx_buf      :   Transmit buffer holding frames results of interface->output_size elements
+ *                              of interface->output_type_bytes each.
+ *                              With a reduced output mode it must stay unchanged up to the next
+ *                              mtb_ml_stream_input_batch() or mtb_ml_stream_input_data().
+ * \param[in]   frames      :   Number of results in tx_buf.
+ * \param[in]   timeout_ms  :   Timeout in milliseconds. Value of 0 means attempt to transmit data
+ *                              forever.
+ * \return                  :   MTB_ML_RESULT_SUCCESS - success
+ *                          :   otherwise - check the return value for detail.
+ */
+cy_rslt_t mtb_ml_stream_output_batch(mtb_ml_stream_interface_t *interface,
+                                     const void *tx_buf,
+                                     uint32_t frames,
+                                     uint32_t timeout_ms);
+/**
+ * \brief : Streams the whole dataset through the model. With protocol v2 the next frames
+ *          are received into a second buffer while the current ones are inferred and the
+ *          results are sent while the next frames arrive. Protocol v1 keeps its strict order
+ *          of frame request, frame and result. With a transport lacking async operations the
+ *          transfers are done in order as mtb_ml_stream_input_data() and mtb_ml_stream_output_data().
+ *
+ * \param[in]   interface       :   Stream interface initialized by mtb_ml_stream_init() or
+ *                                  mtb_ml_stream_init_ex(). Protocol v2 receives batches of
+ *                                  interface->batch_frames frames.
+ * \param[in]   model_object    :   Model object to run the frames.
+ * \param[in]   timeout_ms      :   Timeout of each transfer in milliseconds. Value of 0 means
+ *                                  wait forever.
+ * \param[out]  stats           :   Runner statistics, could be NULL.
+ * \return                      :   MTB_ML_RESULT_SUCCESS - success
+ *                              :   MTB_ML_RESULT_BAD_ARG - invalid parameter or streaming RNN dataset.
+ *                              :   MTB_ML_RESULT_ALLOC_ERR - buffers could not be allocated.
+ *                              :   otherwise - check the return value for detail.
+ */
+cy_rslt_t mtb_ml_stream_run(mtb_ml_stream_interface_t *interface,
+                            mtb_ml_model_t *model_object,
+                            uint32_t timeout_ms,
+                            mtb_ml_stream_runner_stats_t *stats);
+/**
+ * \brief : Print the runner statistics, with inference and link busy time as share of the run.
+ *
+ * \param[in]   stats       :   Statistics of mtb_ml_stream_run().
+ * \return                  :   MTB_ML_RESULT_SUCCESS - success
+ *                          :   MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ */
+cy_rslt_t mtb_ml_stream_runner_log(const mtb_ml_stream_runner_stats_t *stats);
 /**
  * \brief : API to inform host application when the device task is complete
  *
@@ -214,9 +417,79 @@ cy_rslt_t mtb_ml_stream_input_data( mtb_ml_stream_interface_t *interface,
  */
 cy_rslt_t mtb_ml_inform_host_done( mtb_ml_stream_interface_t *interface, uint32_t timeout_ms);
 /**
- * \brief : TX/RX callback function.
+ * \brief : Register a transport on a streaming interface object. The transport context
+ *          (interface_obj->context) is initialized by the transport, e.g. mtb_ml_stream_tcp_connect().
+ *
+ * \param[in]   interface_obj   :   Streaming interface object.
+ * \param[in]   transport       :   Transport send and receive functions.
+ * \return                      :   MTB_ML_RESULT_SUCCESS - success
+ *                              :   MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ */
+cy_rslt_t mtb_ml_stream_register_transport(mtb_data_streaming_interface_t *interface_obj,
+                                           const mtb_ml_stream_transport_t *transport);
+
+#if defined(COMPONENT_ML_HOST)
+/**
+ * File descriptor transport of the Linux host build, used by the TCP socket,
+ * Unix socket and pty connections below.
+ */
+extern const mtb_ml_stream_transport_t mtb_ml_stream_fd_transport;
+
+/**
+ * \brief : Connect the interface object to a host peer listening on a TCP socket.
+ *
+ * \param[in]   interface_obj   :   Streaming interface object.
+ * \param[in]   host            :   Host name or address of the peer.
+ * \param[in]   port            :   TCP port of the peer.
+ * \return                      :   MTB_ML_RESULT_SUCCESS - success
+ *                              :   MTB_ML_RESULT_COMM_ERROR - connection failed.
+ */
+cy_rslt_t mtb_ml_stream_tcp_connect(mtb_data_streaming_interface_t *interface_obj,
+                                    const char *host, uint16_t port);
+
+/**
+ * \brief : Connect the interface object to a host peer listening on a Unix socket.
+ *
+ * \param[in]   interface_obj   :   Streaming interface object.
+ * \param[in]   path            :   Socket path of the peer.
+ * \return                      :   MTB_ML_RESULT_SUCCESS - success
+ *                              :   MTB_ML_RESULT_COMM_ERROR - connection failed.
+ */
+cy_rslt_t mtb_ml_stream_unix_connect(mtb_data_streaming_interface_t *interface_obj,
+                                     const char *path);
+
+/**
+ * \brief : Open a pseudo terminal, the host peer attaches to its slave side as to a serial port.
+ *
+ * \param[in]   interface_obj   :   Streaming interface object.
+ * \param[out]  slave_name      :   Path of the pty slave.
+ * \param[in]   size            :   Size of slave_name buffer.
+ * \return                      :   MTB_ML_RESULT_SUCCESS - success
+ *                              :   MTB_ML_RESULT_COMM_ERROR - pty could not be opened.
+ */
+cy_rslt_t mtb_ml_stream_pty_open(mtb_data_streaming_interface_t *interface_obj,
+                                 char *slave_name, size_t size);
+
+/**
+ * \brief : Close the connection opened by one of the host transports.
+ *
+ * \param[in]   interface_obj   :   Streaming interface object.
+ */
+void mtb_ml_stream_host_close(mtb_data_streaming_interface_t *interface_obj);
+#endif
+
+/**
+ * \brief : Print transfer statistics of the stream, throughput is computed with the CPU clock.
+ *
+ * \param[in]   interface   :   Stream interface provided by user.
+ * \return                  :   MTB_ML_RESULT_SUCCESS - success
+ *                          :   MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ */
+cy_rslt_t mtb_ml_stream_log_stats(const mtb_ml_stream_interface_t *interface);
+/**
+ * \brief : TX/RX callback function. Completes the transfer tracked by the mtb_ml_stream_tag_t.
  *
- * \param[in]   tag     :   Used to store arbitrary caller information.
+ * \param[in]   tag     :   Pointer to mtb_ml_stream_tag_t of the stream interface.
  * \param[in]   rslt    :   Result of TX/RX parent callback.
  * \return              :   None
  */
@@ -116,6 +116,52 @@ int mtb_ml_utils_find_max_int16(const int16_t* in, int size);
  */
 int mtb_ml_utils_find_max_int8(const int8_t* in, int size);
 
+/**
+ * \brief : Distance of two int8_t arrays, e.g. of consecutive model inputs. The distance is
+ *          accumulated in blocks and returned early once it exceeds limit.
+ *
+ * \param[in]   a           : Pointer of the first array
+ * \param[in]   b           : Pointer of the second array
+ * \param[in]   size        : size of the arrays
+ * \param[in]   metric      : L1 or max-abs distance
+ * \param[in]   limit       : Distance above which the comparison may stop
+ *
+ * \return                  : The distance, only exact if it is within limit
+ *                          : UINT32_MAX if input parameter is invalid.
+ */
+uint32_t mtb_ml_utils_input_delta_int8(const int8_t* a, const int8_t* b, int size,
+                                       mtb_ml_input_delta_metric_t metric, uint32_t limit);
+
+/**
+ * \brief : Distance of two int16_t arrays, see mtb_ml_utils_input_delta_int8().
+ *
+ * \param[in]   a           : Pointer of the first array
+ * \param[in]   b           : Pointer of the second array
+ * \param[in]   size        : size of the arrays
+ * \param[in]   metric      : L1 or max-abs distance
+ * \param[in]   limit       : Distance above which the comparison may stop
+ *
+ * \return                  : The distance, only exact if it is within limit
+ *                          : UINT32_MAX if input parameter is invalid.
+ */
+uint32_t mtb_ml_utils_input_delta_int16(const int16_t* a, const int16_t* b, int size,
+                                        mtb_ml_input_delta_metric_t metric, uint32_t limit);
+
+/**
+ * \brief : Distance of two float arrays, see mtb_ml_utils_input_delta_int8().
+ *
+ * \param[in]   a           : Pointer of the first array
+ * \param[in]   b           : Pointer of the second array
+ * \param[in]   size        : size of the arrays
+ * \param[in]   metric      : L1 or max-abs distance
+ * \param[in]   limit       : Distance above which the comparison may stop
+ *
+ * \return                  : The distance, only exact if it is within limit
+ *                          : INFINITY if input parameter is invalid.
+ */
+float mtb_ml_utils_input_delta_flt(const float* a, const float* b, int size,
+                                   mtb_ml_input_delta_metric_t metric, float limit);
+
 /**
  * \brief : Print detailed model info
  *
@@ -151,6 +197,48 @@ cy_rslt_t mtb_ml_utils_model_quantize(const mtb_ml_model_t *obj, const float* in
  */
 cy_rslt_t mtb_ml_utils_model_dequantize(const mtb_ml_model_t *obj, float* dequantized_values);
 
+/**
+ * \brief : Finds the maximum value of the model output, of the model output type whatever MTB_ML_DATA_T is,
+ *          and returns its index.
+ *
+ * \param[in]   obj         : Pointer of model object
+ *
+ * \return                  : The index of maximum value
+ *                          : -1 if input parameter is invalid.
+ */
+int mtb_ml_utils_model_find_max(const mtb_ml_model_t *obj);
+
+/**
+ * \brief : Prints a memory report of mtb_ml_model_get_memory_report()
+ *
+ * \param[in] report     : Memory report.
+ * \param[in] tensors    : Memory of the tensors, NULL for the report only.
+ * \param[in] count      : Number of tensors.
+ *
+ * \return               : MTB_ML_RESULT_SUCCESS - success
+ *                       : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ */
+cy_rslt_t mtb_ml_utils_print_memory_report(const mtb_ml_memory_report_t *report,
+                                           const mtb_ml_tensor_memory_t *tensors, uint32_t count);
+
+#if defined(COMPONENT_ML_HOST)
+/**
+ * \brief : Saves a memory report of mtb_ml_model_get_memory_report() (host build only). A path
+ *          ending in .csv gets the tensor table as CSV, any other path the report and the
+ *          tensors as JSON.
+ *
+ * \param[in] path       : Output file.
+ * \param[in] report     : Memory report.
+ * \param[in] tensors    : Memory of the tensors, NULL for the report only.
+ * \param[in] count      : Number of tensors.
+ *
+ * \return               : MTB_ML_RESULT_SUCCESS - success
+ *                       : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid or the file cannot be written.
+ */
+cy_rslt_t mtb_ml_utils_save_memory_report(const char *path, const mtb_ml_memory_report_t *report,
+                                          const mtb_ml_tensor_memory_t *tensors, uint32_t count);
+#endif
+
 /**
  * @} end of Utils_API group
  */
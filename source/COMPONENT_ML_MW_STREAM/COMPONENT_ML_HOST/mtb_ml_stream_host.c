@@ -0,0 +1,552 @@
+/***************************************************************************//**
+* \file mtb_ml_stream_host.c
+*
+* \brief
+* This file contains Linux host transports of ML validation data streaming feature
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <termios.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include "mtb_ml_common.h"
+#include "mtb_ml_stream.h"
+
+/*******************************************************************************
+ * Macros
+*******************************************************************************/
+/* Connection attempts while the host peer is starting up, 100 ms apart */
+#ifndef MTB_ML_STREAM_HOST_CONNECT_RETRIES
+#define MTB_ML_STREAM_HOST_CONNECT_RETRIES  (50)
+#endif
+
+/* Async transfers poll in steps, so closing the connection stops them */
+#define STREAM_HOST_POLL_STEP_MS            (100)
+
+/*******************************************************************************
+ * Typedefs
+*******************************************************************************/
+/* Runs the async transfers of one direction, blocking I/O on its own thread */
+typedef struct
+{
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    mtb_data_streaming_context_t *context;
+    bool tx;
+    volatile bool quit;
+    uint8_t *data;
+    size_t count;
+    mtb_ml_stream_tag_t *tag;       /* Transfer in flight, NULL when idle */
+} stream_host_worker_t;
+
+/* Async state of a connection, kept in the call_tag of the context */
+typedef struct
+{
+    stream_host_worker_t worker[2]; /* RX and TX */
+} stream_host_async_t;
+
+/*******************************************************************************
+ * Private Function Prototypes
+*******************************************************************************/
+static cy_rslt_t stream_fd_send     (mtb_data_streaming_vcontext_t* vcontext,
+                                    void* data,
+                                    size_t count,
+                                    void* tag);
+static cy_rslt_t stream_fd_get      (mtb_data_streaming_vcontext_t* vcontext,
+                                    uint8_t* data,
+                                    size_t count,
+                                    void* tag);
+static cy_rslt_t stream_fd_send_start(mtb_data_streaming_vcontext_t* vcontext,
+                                     void* data,
+                                     size_t count,
+                                     void* tag);
+static cy_rslt_t stream_fd_get_start(mtb_data_streaming_vcontext_t* vcontext,
+                                    uint8_t* data,
+                                    size_t count,
+                                    void* tag);
+static cy_rslt_t stream_fd_xfer_wait(mtb_data_streaming_vcontext_t* vcontext,
+                                    void* tag,
+                                    bool tx,
+                                    uint32_t timeout_ms);
+
+/*******************************************************************************
+ * Public variables
+*******************************************************************************/
+const mtb_ml_stream_transport_t mtb_ml_stream_fd_transport =
+{
+    .name       = "fd",
+    .send       = stream_fd_send,
+    .receive    = stream_fd_get,
+    .send_async     = stream_fd_send_start,
+    .receive_async  = stream_fd_get_start,
+    .wait           = stream_fd_xfer_wait,
+};
+
+/*******************************************************************************
+ * Private Functions
+*******************************************************************************/
+static mtb_data_streaming_context_t *stream_host_context(mtb_data_streaming_interface_t *interface_obj)
+{
+    return (mtb_data_streaming_context_t *)&(interface_obj->context);
+}
+
+static cy_rslt_t stream_host_attach(mtb_data_streaming_interface_t *interface_obj, int fd, int peer_fd)
+{
+    mtb_data_streaming_context_t *context = stream_host_context(interface_obj);
+
+    context->obj_inst.fd = fd;
+    context->obj_inst.peer_fd = peer_fd;
+    context->callback = mtb_ml_stream_cb;
+    context->call_tag = NULL;
+    return mtb_ml_stream_register_transport(interface_obj, &mtb_ml_stream_fd_transport);
+}
+
+/* Waits until fd is ready for events, timeout of 0 means wait forever */
+static cy_rslt_t stream_fd_wait(int fd, short events, uint32_t timeout_ms)
+{
+    struct pollfd pfd = { .fd = fd, .events = events, .revents = 0 };
+    int ret;
+
+    do
+    {
+        ret = poll(&pfd, 1, (timeout_ms == 0) ? -1 : (int)timeout_ms);
+    } while((ret < 0) && (errno == EINTR));
+
+    if(ret == 0)
+    {
+        return MTB_ML_RESULT_TIMEOUT;
+    }
+    if((ret < 0) || ((pfd.revents & events) == 0))
+    {
+        return MTB_ML_RESULT_COMM_ERROR;
+    }
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+/* Transfers count bytes, with quit set the wait is done in steps until quit is raised */
+static cy_rslt_t stream_fd_io(int fd, bool tx, uint8_t *data, size_t count, uint32_t timeout_ms,
+                              const volatile bool *quit)
+{
+    while(count > 0)
+    {
+        cy_rslt_t result = stream_fd_wait(fd, tx ? POLLOUT : POLLIN,
+                                          (quit != NULL) ? STREAM_HOST_POLL_STEP_MS : timeout_ms);
+        if((result == MTB_ML_RESULT_TIMEOUT) && (quit != NULL) && !*quit)
+        {
+            continue;
+        }
+        if(result != MTB_ML_RESULT_SUCCESS)
+        {
+            return result;
+        }
+        ssize_t done = tx ? write(fd, data, count) : read(fd, data, count);
+        if(done < 0)
+        {
+            if((errno == EINTR) || (errno == EAGAIN))
+            {
+                continue;
+            }
+            return MTB_ML_RESULT_COMM_ERROR;
+        }
+        if(done == 0)
+        {
+            /* Peer closed the connection */
+            return MTB_ML_RESULT_COMM_ERROR;
+        }
+        data += done;
+        count -= (size_t)done;
+    }
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+static cy_rslt_t stream_fd_send(mtb_data_streaming_vcontext_t* vcontext,
+                                void* data, size_t count, void* tag)
+{
+    mtb_data_streaming_context_t *context = (mtb_data_streaming_context_t *)vcontext;
+    /* tag is the timeout in ms */
+    uint32_t timeout_ms = *((uint32_t *)tag);
+
+    return stream_fd_io(context->obj_inst.fd, true, (uint8_t *)data, count, timeout_ms, NULL);
+}
+
+static cy_rslt_t stream_fd_get(mtb_data_streaming_vcontext_t* vcontext,
+                               uint8_t* data, size_t count, void* tag)
+{
+    mtb_data_streaming_context_t *context = (mtb_data_streaming_context_t *)vcontext;
+    /* tag is the timeout in ms */
+    uint32_t timeout_ms = *((uint32_t *)tag);
+
+    return stream_fd_io(context->obj_inst.fd, false, data, count, timeout_ms, NULL);
+}
+
+static void *stream_host_worker(void *arg)
+{
+    stream_host_worker_t *worker = (stream_host_worker_t *)arg;
+
+    pthread_mutex_lock(&worker->lock);
+    for(;;)
+    {
+        /* The condition is shared with the tasks waiting for the completion */
+        while(!worker->quit && (worker->tag == NULL))
+        {
+            pthread_cond_wait(&worker->cond, &worker->lock);
+        }
+        if(worker->quit)
+        {
+            break;
+        }
+        mtb_ml_stream_tag_t *tag = worker->tag;
+        pthread_mutex_unlock(&worker->lock);
+
+        cy_rslt_t result = stream_fd_io(worker->context->obj_inst.fd, worker->tx,
+                                        worker->data, worker->count, 0, &worker->quit);
+
+        pthread_mutex_lock(&worker->lock);
+        /* Idle before completing, the next transfer may be started from the callback on */
+        worker->tag = NULL;
+        worker->context->callback(tag, result);
+        pthread_cond_broadcast(&worker->cond);
+    }
+    pthread_mutex_unlock(&worker->lock);
+    return NULL;
+}
+
+/* Stops and frees the first count workers */
+static void stream_host_workers_stop(stream_host_async_t *async, int count)
+{
+    for(int i = 0; i < count; i++)
+    {
+        stream_host_worker_t *worker = &async->worker[i];
+
+        pthread_mutex_lock(&worker->lock);
+        worker->quit = true;
+        pthread_cond_signal(&worker->cond);
+        pthread_mutex_unlock(&worker->lock);
+        pthread_join(worker->thread, NULL);
+        pthread_cond_destroy(&worker->cond);
+        pthread_mutex_destroy(&worker->lock);
+    }
+    free(async);
+}
+
+static stream_host_async_t *stream_host_async(mtb_data_streaming_context_t *context)
+{
+    stream_host_async_t *async = (stream_host_async_t *)context->call_tag;
+
+    if(async != NULL)
+    {
+        return async;
+    }
+
+    /* Workers are started with the first async transfer */
+    async = (stream_host_async_t *)calloc(1, sizeof(*async));
+    if(async == NULL)
+    {
+        return NULL;
+    }
+    for(int i = 0; i < 2; i++)
+    {
+        stream_host_worker_t *worker = &async->worker[i];
+
+        pthread_mutex_init(&worker->lock, NULL);
+        pthread_cond_init(&worker->cond, NULL);
+        worker->context = context;
+        worker->tx = (i == 1);
+        if(pthread_create(&worker->thread, NULL, stream_host_worker, worker) != 0)
+        {
+            printf("ERROR: cannot start stream worker thread\r\n");
+            pthread_cond_destroy(&worker->cond);
+            pthread_mutex_destroy(&worker->lock);
+            stream_host_workers_stop(async, i);
+            return NULL;
+        }
+    }
+    context->call_tag = async;
+    return async;
+}
+
+static void stream_host_async_stop(mtb_data_streaming_context_t *context)
+{
+    stream_host_async_t *async = (stream_host_async_t *)context->call_tag;
+
+    if(async != NULL)
+    {
+        stream_host_workers_stop(async, 2);
+        context->call_tag = NULL;
+    }
+}
+
+static cy_rslt_t stream_fd_start(mtb_data_streaming_vcontext_t* vcontext, bool tx,
+                                 uint8_t* data, size_t count, void* tag)
+{
+    mtb_data_streaming_context_t *context = (mtb_data_streaming_context_t *)vcontext;
+    stream_host_async_t *async = stream_host_async(context);
+    stream_host_worker_t *worker;
+    cy_rslt_t result = MTB_ML_RESULT_SUCCESS;
+
+    if((async == NULL) || (tag == NULL))
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    worker = &async->worker[tx ? 1 : 0];
+    pthread_mutex_lock(&worker->lock);
+    if(worker->tag != NULL)
+    {
+        /* One transfer in flight per direction */
+        result = MTB_ML_RESULT_BAD_ARG;
+    }
+    else
+    {
+        ((mtb_ml_stream_tag_t *)tag)->stream_done = false;
+        worker->data = data;
+        worker->count = count;
+        worker->tag = (mtb_ml_stream_tag_t *)tag;
+        pthread_cond_broadcast(&worker->cond);
+    }
+    pthread_mutex_unlock(&worker->lock);
+    return result;
+}
+
+static cy_rslt_t stream_fd_send_start(mtb_data_streaming_vcontext_t* vcontext,
+                                      void* data, size_t count, void* tag)
+{
+    return stream_fd_start(vcontext, true, (uint8_t *)data, count, tag);
+}
+
+static cy_rslt_t stream_fd_get_start(mtb_data_streaming_vcontext_t* vcontext,
+                                     uint8_t* data, size_t count, void* tag)
+{
+    return stream_fd_start(vcontext, false, data, count, tag);
+}
+
+/* Blocks until the worker completes the transfer of tag */
+static cy_rslt_t stream_fd_xfer_wait(mtb_data_streaming_vcontext_t* vcontext, void* tag, bool tx,
+                                     uint32_t timeout_ms)
+{
+    mtb_data_streaming_context_t *context = (mtb_data_streaming_context_t *)vcontext;
+    stream_host_async_t *async = (stream_host_async_t *)context->call_tag;
+    volatile mtb_ml_stream_tag_t *stream_tag = (volatile mtb_ml_stream_tag_t *)tag;
+    stream_host_worker_t *worker;
+    struct timespec deadline;
+    int err = 0;
+    bool done;
+
+    if((async == NULL) || (tag == NULL))
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += (time_t)(timeout_ms / 1000);
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if(deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    worker = &async->worker[tx ? 1 : 0];
+    pthread_mutex_lock(&worker->lock);
+    while(!stream_tag->stream_done && (err != ETIMEDOUT))
+    {
+        /* Timeout of 0 means wait forever */
+        err = (timeout_ms == 0) ? pthread_cond_wait(&worker->cond, &worker->lock) :
+                                  pthread_cond_timedwait(&worker->cond, &worker->lock, &deadline);
+    }
+    done = stream_tag->stream_done;
+    pthread_mutex_unlock(&worker->lock);
+    return done ? MTB_ML_RESULT_SUCCESS : MTB_ML_RESULT_TIMEOUT;
+}
+
+/* Connects with retries, so the device side may be started before the peer */
+static int stream_host_connect(int domain, const struct sockaddr *addr, socklen_t addr_len)
+{
+    for(int attempt = 0; attempt < MTB_ML_STREAM_HOST_CONNECT_RETRIES; attempt++)
+    {
+        int fd = socket(domain, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if(fd < 0)
+        {
+            return -1;
+        }
+        if(connect(fd, addr, addr_len) == 0)
+        {
+            return fd;
+        }
+        close(fd);
+        usleep(100 * 1000);
+    }
+    return -1;
+}
+
+/*******************************************************************************
+ * Public Functions
+*******************************************************************************/
+cy_rslt_t mtb_ml_stream_tcp_connect(mtb_data_streaming_interface_t *interface_obj,
+                                    const char *host, uint16_t port)
+{
+    struct addrinfo hints;
+    struct addrinfo *res = NULL;
+    char port_str[8];
+    int fd = -1;
+    int one = 1;
+
+    if(!interface_obj || !host)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    snprintf(port_str, sizeof(port_str), "%u", (unsigned)port);
+    if(getaddrinfo(host, port_str, &hints, &res) != 0)
+    {
+        printf("ERROR: cannot resolve %s\r\n", host);
+        return MTB_ML_RESULT_COMM_ERROR;
+    }
+    for(struct addrinfo *ai = res; (ai != NULL) && (fd < 0); ai = ai->ai_next)
+    {
+        fd = stream_host_connect(ai->ai_family, ai->ai_addr, ai->ai_addrlen);
+    }
+    freeaddrinfo(res);
+    if(fd < 0)
+    {
+        printf("ERROR: cannot connect to %s:%u\r\n", host, (unsigned)port);
+        return MTB_ML_RESULT_COMM_ERROR;
+    }
+
+    /* Small protocol messages must not wait for Nagle coalescing */
+    (void)setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return stream_host_attach(interface_obj, fd, -1);
+}
+
+cy_rslt_t mtb_ml_stream_unix_connect(mtb_data_streaming_interface_t *interface_obj,
+                                     const char *path)
+{
+    struct sockaddr_un addr;
+    int fd;
+
+    if(!interface_obj || !path || (strlen(path) >= sizeof(addr.sun_path)))
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    fd = stream_host_connect(AF_UNIX, (const struct sockaddr *)&addr, sizeof(addr));
+    if(fd < 0)
+    {
+        printf("ERROR: cannot connect to %s\r\n", path);
+        return MTB_ML_RESULT_COMM_ERROR;
+    }
+    return stream_host_attach(interface_obj, fd, -1);
+}
+
+cy_rslt_t mtb_ml_stream_pty_open(mtb_data_streaming_interface_t *interface_obj,
+                                 char *slave_name, size_t size)
+{
+    struct termios tio;
+    int fd;
+    int peer_fd;
+
+    if(!interface_obj || !slave_name || (size == 0))
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    fd = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if((fd < 0) || (grantpt(fd) != 0) || (unlockpt(fd) != 0) ||
+       (ptsname_r(fd, slave_name, size) != 0))
+    {
+        if(fd >= 0)
+        {
+            close(fd);
+        }
+        return MTB_ML_RESULT_COMM_ERROR;
+    }
+
+    /* Keeping the slave open avoids hang-ups on the master until the peer attaches */
+    peer_fd = open(slave_name, O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if(peer_fd < 0)
+    {
+        close(fd);
+        return MTB_ML_RESULT_COMM_ERROR;
+    }
+
+    /* Binary protocol, no line discipline */
+    if(tcgetattr(peer_fd, &tio) == 0)
+    {
+        cfmakeraw(&tio);
+        (void)tcsetattr(peer_fd, TCSANOW, &tio);
+    }
+    return stream_host_attach(interface_obj, fd, peer_fd);
+}
+
+void mtb_ml_stream_host_close(mtb_data_streaming_interface_t *interface_obj)
+{
+    mtb_data_streaming_context_t *context;
+
+    if(!interface_obj)
+    {
+        return;
+    }
+    context = stream_host_context(interface_obj);
+    stream_host_async_stop(context);
+    if(context->obj_inst.fd >= 0)
+    {
+        close(context->obj_inst.fd);
+        context->obj_inst.fd = -1;
+    }
+    if(context->obj_inst.peer_fd >= 0)
+    {
+        close(context->obj_inst.peer_fd);
+        context->obj_inst.peer_fd = -1;
+    }
+}
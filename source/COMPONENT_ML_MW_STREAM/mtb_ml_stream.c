@@ -41,12 +41,20 @@
 #include <string.h>
 #include <inttypes.h>
 
+#if !defined(COMPONENT_ML_HOST)
 #include "cy_retarget_io.h"
+#if MTB_ML_STREAM_UART_ASYNC && defined(CY_RTOS_AWARE) && !defined(COMPONENT_MTB_HAL)
+#include "cyabs_rtos.h"
+#endif
+#else
+#include <unistd.h>
+#endif
 
 #include "mtb_ml_common.h"
 #include "mtb_ml_utils.h"
 #include "mtb_ml_stream.h"
 #include "mtb_ml_model.h"
+#include "mtb_ml_stream_impl.h"
 
 /*******************************************************************************
  * Macros
@@ -62,21 +70,11 @@
  */
 #define DEFAULT_RX_BUFFER  25
 
-/* NOTE: Must match mtb_ml_regression_info_t in streaming application */
-#define ML_PROFILE_FRAME_STRING         "Frame "
-#define ML_PROFILE_OUTPUT_STRING        " output:"
-#define ML_PROFILE_INFO_STRING          "PROFILE_INFO,"
-
-#define ML_TC_START_STRING              "ML_START"
-#define ML_CT_READY_STRING              "ML_READY"
-#define ML_TC_MODEL_DATA_REQ_STRING     "ML_MODEL_DATA_REQ"
-#define ML_CT_MODEL_DATA_STRING         "ML_MODEL_DATA"
-#define ML_TC_DATASET_REQ_SEND_STRING   "ML_DATASET_SENDREQ"
-#define ML_CT_FRAME_REQ_STRING          "ML_FRAME"
-#define ML_CT_RESULT_STRING             "ML_RESULT"
-#define ML_TC_DONE_STRING               "ML_COMPLETED"
-#define ML_CT_DONE_STRING               "ML_DONE"
-#define ML_ERROR_STRING                 "ERROR"
+#if MTB_ML_STREAM_UART_ASYNC && !defined(COMPONENT_MTB_HAL)
+#define STREAM_TRANSPORT_NAME "async"
+#else
+#define STREAM_TRANSPORT_NAME "polling"
+#endif
 
 /*******************************************************************************
  * Private Function Prototypes
@@ -87,7 +85,10 @@ static inline cy_rslt_t mtb_data_streaming_send(mtb_data_streaming_interface_t*
                                                 uint8_t *data, size_t count, void* tag);
 
 static cy_rslt_t stream_verify_test_data(mtb_ml_stream_interface_t *iface,
-                                         const mtb_ml_model_t *model_object);
+                                         const mtb_ml_model_t *model_object,
+                                         const mtb_ml_stream_config_t *config);
+static cy_rslt_t stream_negotiate_v2(mtb_ml_stream_interface_t *iface,
+                                     const mtb_ml_stream_config_t *config);
 static cy_rslt_t send_model_regr_info   (mtb_ml_stream_interface_t *iface,
                                          const mtb_ml_model_t *model_object);
 static cy_rslt_t stream_send_data   (mtb_ml_stream_interface_t *iface,
@@ -102,7 +103,18 @@ static cy_rslt_t stream_get_string  (mtb_ml_stream_interface_t *iface,
                                     const char *string,
                                     size_t size,
                                     uint32_t timeout_ms);
-static cy_rslt_t stream_setup       (mtb_data_streaming_interface_t* iface);
+static cy_rslt_t stream_setup       (mtb_ml_stream_interface_t *iface,
+                                    const mtb_ml_stream_config_t *config);
+static cy_rslt_t stream_send_reduced(mtb_ml_stream_interface_t *iface,
+                                    const void *tx_buf,
+                                    uint32_t frames,
+                                    uint32_t *crc,
+                                    uint32_t timeout_ms);
+static cy_rslt_t stream_resend_results(mtb_ml_stream_interface_t *iface,
+                                    const mtb_ml_stream_v2_hdr_t *hdr,
+                                    uint32_t timeout_ms);
+static void stream_delay_us         (uint32_t us);
+#if !defined(COMPONENT_ML_HOST)
 static cy_rslt_t stream_uart_send   (mtb_data_streaming_vcontext_t* vcontext,
                                     void* data,
                                     size_t count,
@@ -111,36 +123,66 @@ static cy_rslt_t stream_uart_get    (mtb_data_streaming_vcontext_t* vcontext,
                                     uint8_t* data,
                                     size_t count,
                                     void* tag);
+#if MTB_ML_STREAM_UART_ASYNC && !defined(COMPONENT_MTB_HAL)
+#if defined(CY_RTOS_AWARE)
+static cy_rslt_t stream_uart_sem_init(void);
+#endif
+static void stream_uart_event_cb    (void *callback_arg,
+                                    cyhal_uart_event_t event);
+static cy_rslt_t stream_uart_send_async(mtb_data_streaming_vcontext_t* vcontext,
+                                        void* data,
+                                        size_t count,
+                                        void* tag);
+static cy_rslt_t stream_uart_get_async(mtb_data_streaming_vcontext_t* vcontext,
+                                       uint8_t* data,
+                                       size_t count,
+                                       void* tag);
+static cy_rslt_t stream_uart_send_start(mtb_data_streaming_vcontext_t* vcontext,
+                                        void* data,
+                                        size_t count,
+                                        void* tag);
+static cy_rslt_t stream_uart_get_start(mtb_data_streaming_vcontext_t* vcontext,
+                                       uint8_t* data,
+                                       size_t count,
+                                       void* tag);
+static cy_rslt_t stream_uart_async_wait(mtb_data_streaming_vcontext_t* vcontext,
+                                        void* tag,
+                                        bool tx,
+                                        uint32_t timeout_ms);
+#endif
+#endif /* !defined(COMPONENT_ML_HOST) */
 
-#if !defined(COMPONENT_MTB_HAL)
+extern uint32_t mtb_ml_cpu_clk_freq;
+#if !defined(COMPONENT_ML_HOST) && !defined(COMPONENT_MTB_HAL)
 extern cyhal_uart_t cy_retarget_io_uart_obj;
 #endif
-/*******************************************************************************
- * Private Typedef's/Enumerations
-*******************************************************************************/
-/* NOTE: Must match mtb_ml_regression_info_t in streaming application */
-typedef struct
-{
-    uint32_t output_size;       /* NN model inference classification output size */
-    uint32_t buffer_size;       /* Runtime buffer size required for inference */
-    uint32_t model_size;        /* Model's weights & biases */
-    uint32_t model_time_steps;  /* Number of model time steps */
-    int output_zero_point;      /* Model's output data zero point */
-    float output_scale;         /* Model's output data */
-} mtb_ml_regression_info_t;
-
 /*******************************************************************************
  * Public Functions
 *******************************************************************************/
 void mtb_ml_stream_cb(void* tag, cy_rslt_t rslt)
 {
-    /* Currently unused */
-    (void)tag;
-    (void)rslt;
+    volatile mtb_ml_stream_tag_t *stream_tag = (volatile mtb_ml_stream_tag_t *)tag;
+
+    if(stream_tag != NULL)
+    {
+        uint64_t now = 0;
+
+        mtb_ml_model_profile_get_tsc(&now);
+        stream_tag->done_cycles = now;
+        stream_tag->stream_status = rslt;
+        stream_tag->stream_done = true;
+    }
 }
 
 cy_rslt_t mtb_ml_stream_init(mtb_ml_stream_interface_t *interface,
                             const mtb_ml_model_t *model_object)
+{
+    return mtb_ml_stream_init_ex(interface, model_object, NULL);
+}
+
+cy_rslt_t mtb_ml_stream_init_ex(mtb_ml_stream_interface_t *interface,
+                                const mtb_ml_model_t *model_object,
+                                const mtb_ml_stream_config_t *config)
 {
     if(!interface || !model_object)
     {
@@ -149,10 +191,14 @@ cy_rslt_t mtb_ml_stream_init(mtb_ml_stream_interface_t *interface,
     }
 
     /* Initialize comm */
-    stream_setup(interface->interface_obj);
+    cy_rslt_t result = stream_setup(interface, config);
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        return result;
+    }
 
     /* Verify test data */
-    return stream_verify_test_data(interface, model_object);
+    return stream_verify_test_data(interface, model_object, config);
 }
 
 cy_rslt_t mtb_ml_stream_output_data(mtb_ml_stream_interface_t *iface, void *tx_buf, uint32_t timeout_ms)
@@ -163,6 +209,11 @@ cy_rslt_t mtb_ml_stream_output_data(mtb_ml_stream_interface_t *iface, void *tx_b
         return MTB_ML_RESULT_BAD_ARG;
     }
 
+    if(iface->protocol_version == MTB_ML_STREAM_V2_VERSION)
+    {
+        return mtb_ml_stream_output_batch(iface, tx_buf, 1, timeout_ms);
+    }
+
     /* Send "result" string to host */
     cy_rslt_t result = stream_send_data(iface, ML_CT_RESULT_STRING, sizeof(ML_CT_RESULT_STRING), timeout_ms);
     if(result != MTB_ML_RESULT_SUCCESS)
@@ -172,7 +223,7 @@ cy_rslt_t mtb_ml_stream_output_data(mtb_ml_stream_interface_t *iface, void *tx_b
     }
 
     /* Send output data */
-    return stream_send_data(iface, tx_buf, iface->output_size * sizeof(MTB_ML_DATA_T), timeout_ms);
+    return stream_send_data(iface, tx_buf, iface->output_size * iface->output_type_bytes, timeout_ms);
 }
 
 cy_rslt_t mtb_ml_stream_input_data(mtb_ml_stream_interface_t *iface, void *rx_buf, uint32_t timeout_ms)
@@ -183,6 +234,25 @@ cy_rslt_t mtb_ml_stream_input_data(mtb_ml_stream_interface_t *iface, void *rx_bu
         return MTB_ML_RESULT_BAD_ARG;
     }
 
+    if(iface->protocol_version == MTB_ML_STREAM_V2_VERSION)
+    {
+        uint32_t frames = 0;
+        uint32_t batch_frames = iface->batch_frames;
+        uint32_t rx_slack = iface->rx_slack;
+
+        /* Single frame request within the batched protocol, rx_buf holds just the frame */
+        iface->batch_frames = 1;
+        iface->rx_slack = 0;
+        cy_rslt_t result = mtb_ml_stream_input_batch(iface, rx_buf, &frames, timeout_ms);
+        iface->batch_frames = batch_frames;
+        iface->rx_slack = rx_slack;
+        if((result == MTB_ML_RESULT_SUCCESS) && (frames != 1))
+        {
+            result = MTB_ML_RESULT_COMM_ERROR;
+        }
+        return result;
+    }
+
     /* Send frame request string to host. */
     cy_rslt_t result = stream_send_data(iface, ML_CT_FRAME_REQ_STRING, sizeof(ML_CT_FRAME_REQ_STRING), timeout_ms);
     if(result != MTB_ML_RESULT_SUCCESS)
@@ -190,16 +260,190 @@ cy_rslt_t mtb_ml_stream_input_data(mtb_ml_stream_interface_t *iface, void *rx_bu
         printf("ERROR: failed to send frame request to host.\r\n");
         return result;
     }
-    /* If recurrent_ts_size is greater than 1, it indicates a streaming RNN
-    * model where data slicing is required. Otherwise, no slicing is required.
-    * (if recurrent_ts_size is -1, it indicates a non-RNN model, and if
-    * recurrent_ts_size 1, it indicates a non-streaming RNN model where no data
-    * slicing is required.
-    */
-    uint32_t slice_data_into = (iface->x_data_info.recurrent_ts_size < 0) ? 1 : iface->x_data_info.recurrent_ts_size;
 
-    /* Get input data */
-    return stream_get_data(iface, rx_buf, (iface->input_size * sizeof(MTB_ML_DATA_T)) / slice_data_into, timeout_ms);
+    /* Get input data, a time step slice for streaming RNN models */
+    return stream_get_data(iface, rx_buf, mtb_ml_stream_frame_bytes(iface), timeout_ms);
+}
+
+cy_rslt_t mtb_ml_stream_input_batch(mtb_ml_stream_interface_t *iface, void *rx_buf, uint32_t *frames, uint32_t timeout_ms)
+{
+    cy_rslt_t result;
+    mtb_ml_stream_v2_hdr_t hdr;
+    mtb_ml_stream_v2_hdr_t req;
+    uint8_t *payload;
+
+    if(!iface || !rx_buf || !frames || (iface->protocol_version != MTB_ML_STREAM_V2_VERSION))
+    {
+        printf("ERROR: mtb_ml_stream_input_batch invalid parameters\r\n");
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    *frames = 0;
+
+    /* Request up to batch_frames frames, the host sends fewer at the end of the dataset */
+    req.magic = MTB_ML_STREAM_V2_MAGIC;
+    req.type = MTB_ML_STREAM_V2_FRAME_REQ;
+    req.count = (uint16_t)iface->batch_frames;
+    req.seq = iface->seq;
+    req.length = (iface->codec != 0) ? iface->rx_slack : 0;
+    req.crc = 0;
+    hdr = req;
+    result = stream_send_data(iface, &hdr, sizeof(hdr), timeout_ms);
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        printf("ERROR: failed to send batch request to host.\r\n");
+        return result;
+    }
+
+    for(uint32_t attempt = 0; ; attempt++)
+    {
+        result = stream_get_data(iface, &hdr, sizeof(hdr), timeout_ms);
+        /* The host asks for the full results of a mismatching batch ahead of the frames */
+        while((result == MTB_ML_RESULT_SUCCESS) && (hdr.magic == MTB_ML_STREAM_V2_MAGIC) &&
+              (hdr.type == MTB_ML_STREAM_V2_RESULT_REQ))
+        {
+            result = stream_resend_results(iface, &hdr, timeout_ms);
+            if(result == MTB_ML_RESULT_SUCCESS)
+            {
+                result = stream_get_data(iface, &hdr, sizeof(hdr), timeout_ms);
+            }
+        }
+        if(result != MTB_ML_RESULT_SUCCESS)
+        {
+            return result;
+        }
+        if(!mtb_ml_stream_frames_hdr_valid(iface, &hdr, &req))
+        {
+            return MTB_ML_RESULT_COMM_ERROR;
+        }
+
+        /* A coded payload is received into the tail of the buffer and decoded in place */
+        payload = mtb_ml_stream_frames_payload(iface, &hdr, &req, rx_buf);
+        result = stream_get_data(iface, payload, hdr.length, timeout_ms);
+        if(result != MTB_ML_RESULT_SUCCESS)
+        {
+            return result;
+        }
+        if(mtb_ml_stream_crc32(0, payload, hdr.length) == hdr.crc)
+        {
+            if(!mtb_ml_stream_frames_decode(iface, &hdr, rx_buf, payload))
+            {
+                return MTB_ML_RESULT_COMM_ERROR;
+            }
+            break;
+        }
+        if(attempt == MTB_ML_STREAM_V2_RETRIES)
+        {
+            printf("ERROR: batch %" PRIu32 " CRC mismatch\r\n", iface->seq);
+            return MTB_ML_RESULT_COMM_ERROR;
+        }
+
+        /* Ask the host to resend the batch */
+        hdr.magic = MTB_ML_STREAM_V2_MAGIC;
+        hdr.type = MTB_ML_STREAM_V2_NACK;
+        hdr.count = 0;
+        hdr.seq = iface->seq;
+        hdr.length = 0;
+        hdr.crc = 0;
+        result = stream_send_data(iface, &hdr, sizeof(hdr), timeout_ms);
+        if(result != MTB_ML_RESULT_SUCCESS)
+        {
+            return result;
+        }
+    }
+
+    iface->seq++;
+    *frames = hdr.count;
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_stream_output_batch(mtb_ml_stream_interface_t *iface, const void *tx_buf, uint32_t frames, uint32_t timeout_ms)
+{
+    cy_rslt_t result;
+    mtb_ml_stream_v2_hdr_t hdr;
+
+    if(!iface || !tx_buf || (frames > UINT16_MAX) || (iface->protocol_version != MTB_ML_STREAM_V2_VERSION))
+    {
+        printf("ERROR: mtb_ml_stream_output_batch invalid parameters\r\n");
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    hdr.magic = MTB_ML_STREAM_V2_MAGIC;
+    hdr.type = MTB_ML_STREAM_V2_RESULTS;
+    hdr.count = (uint16_t)frames;
+    hdr.seq = iface->seq;
+    hdr.length = frames * iface->output_size * iface->output_type_bytes;
+    hdr.crc = 0;
+    if(iface->output_mode != MTB_ML_STREAM_OUTPUT_FULL)
+    {
+        /* First pass for the CRC, the second one sends the reduced results */
+        hdr.type = MTB_ML_STREAM_V2_RESULTS_REDUCED;
+        hdr.length = frames * mtb_ml_stream_reduced_bytes(iface->output_mode, iface->top_k,
+                                                          iface->output_size, iface->output_data_type);
+        stream_send_reduced(iface, tx_buf, frames, &hdr.crc, timeout_ms);
+    }
+    else
+    {
+        hdr.crc = mtb_ml_stream_crc32(0, tx_buf, hdr.length);
+    }
+
+    result = stream_send_data(iface, &hdr, sizeof(hdr), timeout_ms);
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        printf("ERROR: failed to send result batch to host\r\n");
+        return result;
+    }
+    if(iface->output_mode != MTB_ML_STREAM_OUTPUT_FULL)
+    {
+        result = stream_send_reduced(iface, tx_buf, frames, NULL, timeout_ms);
+        iface->sent_results = tx_buf;
+        iface->sent_results_seq = hdr.seq;
+        iface->sent_results_frames = frames;
+    }
+    else
+    {
+        result = stream_send_data(iface, (void *)tx_buf, hdr.length, timeout_ms);
+    }
+    if(result == MTB_ML_RESULT_SUCCESS)
+    {
+        iface->seq++;
+    }
+    return result;
+}
+
+cy_rslt_t mtb_ml_stream_register_transport(mtb_data_streaming_interface_t *interface_obj,
+                                           const mtb_ml_stream_transport_t *transport)
+{
+    if(!interface_obj || !transport || !transport->send || !transport->receive)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    interface_obj->send     = transport->send;
+    interface_obj->receive  = transport->receive;
+    interface_obj->send_async       = transport->send_async;
+    interface_obj->receive_async    = transport->receive_async;
+    interface_obj->wait             = transport->wait;
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_stream_log_stats(const mtb_ml_stream_interface_t *iface)
+{
+    const mtb_ml_stream_stats_t *stats;
+
+    if(!iface)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    stats = &iface->stats;
+    printf("PROFILE_INFO, MTB ML stream, transport=%s, tx_bytes=%-" PRIu64 ", tx_kBps=%-10.2f, rx_bytes=%-" PRIu64 ", rx_kBps=%-10.2f\r\n",
+            (iface->transport_name != NULL) ? iface->transport_name : "unknown",
+            stats->tx_bytes,
+            (stats->tx_cycles != 0) ? ((float)stats->tx_bytes * mtb_ml_cpu_clk_freq / stats->tx_cycles / 1000.0f) : 0.0f,
+            stats->rx_bytes,
+            (stats->rx_cycles != 0) ? ((float)stats->rx_bytes * mtb_ml_cpu_clk_freq / stats->rx_cycles / 1000.0f) : 0.0f);
+    return MTB_ML_RESULT_SUCCESS;
 }
 
 cy_rslt_t mtb_ml_inform_host_done( mtb_ml_stream_interface_t *iface, uint32_t timeout_ms)
@@ -209,6 +453,25 @@ cy_rslt_t mtb_ml_inform_host_done( mtb_ml_stream_interface_t *iface, uint32_t ti
         printf("ERROR: mtb_ml_inform_host_done invalid parameters\r\n");
         return MTB_ML_RESULT_BAD_ARG;
     }
+    /* An empty request leaves the host a chance to ask for the last full results */
+    if((iface->protocol_version == MTB_ML_STREAM_V2_VERSION) && (iface->sent_results != NULL))
+    {
+        uint8_t empty;
+        uint32_t frames = 0;
+        uint32_t batch_frames = iface->batch_frames;
+        uint32_t rx_slack = iface->rx_slack;
+
+        iface->batch_frames = 0;
+        iface->rx_slack = 0;
+        cy_rslt_t result = mtb_ml_stream_input_batch(iface, &empty, &frames, timeout_ms);
+        iface->batch_frames = batch_frames;
+        iface->rx_slack = rx_slack;
+        iface->sent_results = NULL;
+        if(result != MTB_ML_RESULT_SUCCESS)
+        {
+            return result;
+        }
+    }
     cy_rslt_t result = stream_get_string(iface, ML_TC_DONE_STRING, sizeof(ML_TC_DONE_STRING), timeout_ms);
     if(result != MTB_ML_RESULT_SUCCESS)
     {
@@ -217,11 +480,282 @@ cy_rslt_t mtb_ml_inform_host_done( mtb_ml_stream_interface_t *iface, uint32_t ti
     return stream_send_data(iface, ML_CT_DONE_STRING, sizeof(ML_CT_DONE_STRING), timeout_ms);
 }
 
+/*******************************************************************************
+ * Stream internal Functions
+*******************************************************************************/
+size_t mtb_ml_stream_frame_bytes(const mtb_ml_stream_interface_t *iface)
+{
+    /* If recurrent_ts_size is greater than 1, it indicates a streaming RNN
+    * model where data slicing is required. Otherwise, no slicing is required.
+    * (if recurrent_ts_size is -1, it indicates a non-RNN model, and if
+    * recurrent_ts_size 1, it indicates a non-streaming RNN model where no data
+    * slicing is required.
+    */
+    uint32_t slice_data_into = (iface->x_data_info.recurrent_ts_size < 0) ? 1 : iface->x_data_info.recurrent_ts_size;
+
+    return (iface->input_size * sizeof(MTB_ML_DATA_T)) / slice_data_into;
+}
+
+bool mtb_ml_stream_frames_hdr_valid(const mtb_ml_stream_interface_t *iface, const mtb_ml_stream_v2_hdr_t *hdr,
+                                    const mtb_ml_stream_v2_hdr_t *req)
+{
+    size_t frame_bytes = mtb_ml_stream_frame_bytes(iface);
+    bool coded = (hdr->type == MTB_ML_STREAM_V2_FRAMES_CODED) && (iface->codec != 0);
+
+    /* A coded payload fits the buffer of the request, the host sends it raw otherwise */
+    if((hdr->magic != MTB_ML_STREAM_V2_MAGIC) || ((hdr->type != MTB_ML_STREAM_V2_FRAMES) && !coded) ||
+       (hdr->seq != req->seq) || (hdr->count > req->count) ||
+       (coded ? (hdr->length > req->count * frame_bytes + req->length) : (hdr->length != hdr->count * frame_bytes)))
+    {
+        printf("ERROR: unexpected batch header (type %d, seq %" PRIu32 ", count %d)\r\n",
+               (int)hdr->type, hdr->seq, (int)hdr->count);
+        return false;
+    }
+    return true;
+}
+
+uint8_t *mtb_ml_stream_frames_payload(const mtb_ml_stream_interface_t *iface, const mtb_ml_stream_v2_hdr_t *hdr,
+                                      const mtb_ml_stream_v2_hdr_t *req, void *frames)
+{
+    if(hdr->type != MTB_ML_STREAM_V2_FRAMES_CODED)
+    {
+        return (uint8_t *)frames;
+    }
+    return (uint8_t *)frames + req->count * mtb_ml_stream_frame_bytes(iface) + req->length - hdr->length;
+}
+
+bool mtb_ml_stream_frames_decode(const mtb_ml_stream_interface_t *iface, const mtb_ml_stream_v2_hdr_t *hdr,
+                                 void *frames, const void *payload)
+{
+    if(hdr->type != MTB_ML_STREAM_V2_FRAMES_CODED)
+    {
+        return true;
+    }
+    if(!mtb_ml_stream_codec_decode(iface->codec, frames, hdr->count * mtb_ml_stream_frame_bytes(iface),
+                                   payload, hdr->length))
+    {
+        printf("ERROR: batch %" PRIu32 " could not be decoded\r\n", hdr->seq);
+        return false;
+    }
+    return true;
+}
+
+cy_rslt_t mtb_ml_stream_xfer_start(mtb_ml_stream_interface_t *iface, mtb_ml_stream_xfer_t *xfer,
+                                   bool tx, void *buf, size_t length, uint32_t timeout_ms)
+{
+    mtb_data_streaming_interface_t *iface_obj = iface->interface_obj;
+    cy_rslt_t result;
+
+    xfer->tx = tx;
+    xfer->length = length;
+    xfer->pending = true;
+    xfer->busy_cycles = 0;
+    xfer->tag.stream_done = false;
+    xfer->tag.stream_status = MTB_ML_RESULT_SUCCESS;
+    mtb_ml_model_profile_get_tsc(&xfer->start_cycles);
+
+    if(length == 0)
+    {
+        /* Empty payload, e.g. the batch answering an empty request */
+        mtb_ml_stream_cb(&xfer->tag, MTB_ML_RESULT_SUCCESS);
+        result = MTB_ML_RESULT_SUCCESS;
+    }
+    else if(tx && (iface_obj->send_async != NULL))
+    {
+        result = iface_obj->send_async(&iface_obj->context, buf, length, &xfer->tag);
+    }
+    else if(!tx && (iface_obj->receive_async != NULL))
+    {
+        result = iface_obj->receive_async(&iface_obj->context, (uint8_t *)buf, length, &xfer->tag);
+    }
+    else
+    {
+        /* Transport without async operations, the transfer completes right here */
+        result = tx ? mtb_data_streaming_send(iface_obj, (uint8_t *)buf, length, (void *)(&timeout_ms)) :
+                      mtb_data_streaming_receive(iface_obj, (uint8_t *)buf, length, (void *)(&timeout_ms));
+        mtb_ml_stream_cb(&xfer->tag, result);
+        result = MTB_ML_RESULT_SUCCESS;
+    }
+
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        xfer->pending = false;
+    }
+    return result;
+}
+
+cy_rslt_t mtb_ml_stream_xfer_wait(mtb_ml_stream_interface_t *iface, mtb_ml_stream_xfer_t *xfer, uint32_t timeout_ms)
+{
+    mtb_data_streaming_interface_t *iface_obj = iface->interface_obj;
+    volatile mtb_ml_stream_tag_t *stream_tag = &xfer->tag;
+    /* Timeout is counted in 10 us steps */
+    uint32_t steps = timeout_ms * 100;
+
+    if(!xfer->pending)
+    {
+        return MTB_ML_RESULT_SUCCESS;
+    }
+    if(!stream_tag->stream_done && (iface_obj->wait != NULL))
+    {
+        /* The transport blocks until its completion event */
+        cy_rslt_t result = iface_obj->wait(&iface_obj->context, &xfer->tag, xfer->tx, timeout_ms);
+        if(result != MTB_ML_RESULT_SUCCESS)
+        {
+            return result;
+        }
+    }
+    while(!stream_tag->stream_done)
+    {
+        /* Timeout of 0 means wait forever */
+        stream_delay_us(10);
+        if((timeout_ms != 0) && (--steps == 0))
+        {
+            return MTB_ML_RESULT_TIMEOUT;
+        }
+    }
+    xfer->pending = false;
+    if(stream_tag->stream_status != MTB_ML_RESULT_SUCCESS)
+    {
+        return stream_tag->stream_status;
+    }
+
+    /* Time the link was busy with the transfer, overlapping any work done meanwhile */
+    if(stream_tag->done_cycles > xfer->start_cycles)
+    {
+        xfer->busy_cycles = stream_tag->done_cycles - xfer->start_cycles;
+    }
+    if(xfer->tx)
+    {
+        iface->stats.tx_bytes += xfer->length;
+        iface->stats.tx_cycles += xfer->busy_cycles;
+    }
+    else
+    {
+        iface->stats.rx_bytes += xfer->length;
+        iface->stats.rx_cycles += xfer->busy_cycles;
+    }
+    return MTB_ML_RESULT_SUCCESS;
+}
+
 /*******************************************************************************
  * Private Functions
 *******************************************************************************/
+
+static cy_rslt_t stream_negotiate_v2(mtb_ml_stream_interface_t *iface,
+                                     const mtb_ml_stream_config_t *config)
+{
+    cy_rslt_t result;
+    mtb_ml_stream_v2_caps_t caps;
+    char reply[sizeof(ML_TC_V2_ACCEPT_STRING)];
+    size_t frame_bytes = mtb_ml_stream_frame_bytes(iface);
+    uint32_t batch_frames = (config->batch_frames > 1) ? config->batch_frames : 1;
+    uint32_t codecs;
+    uint32_t output_mode;
+    uint32_t top_k;
+
+    /* K is tuned to the frames fitting the receive buffer */
+    if((frame_bytes == 0) || (config->rx_buffer_size < frame_bytes))
+    {
+        printf("ERROR: stream RX buffer (%d) smaller than a frame (%d)\r\n", (int)config->rx_buffer_size, (int)frame_bytes);
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    if(batch_frames > config->rx_buffer_size / frame_bytes)
+    {
+        batch_frames = (uint32_t)(config->rx_buffer_size / frame_bytes);
+    }
+    if(batch_frames > UINT16_MAX)
+    {
+        batch_frames = UINT16_MAX;
+    }
+    /* Coded frames are decoded in place, keep some slack past the batch when a frame less still fits */
+    if((config->codecs != 0) && (batch_frames > 1) &&
+       (config->rx_buffer_size - batch_frames * frame_bytes < MTB_ML_STREAM_CODEC_MARGIN))
+    {
+        batch_frames--;
+    }
+
+    result = stream_send_data(iface, ML_CT_V2_OFFER_STRING, sizeof(ML_CT_V2_OFFER_STRING), DEFAULT_TX_TIMEOUT);
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        return result;
+    }
+    caps.version = MTB_ML_STREAM_V2_VERSION;
+    caps.batch_frames = batch_frames;
+    caps.frame_bytes = (uint32_t)frame_bytes;
+    caps.result_bytes = (uint32_t)(iface->output_size * iface->output_type_bytes);
+    caps.codecs = config->codecs & (MTB_ML_STREAM_CODEC_DELTA16 | MTB_ML_STREAM_CODEC_LZ4);
+    codecs = caps.codecs;
+    caps.output_mode = config->output_mode;
+    caps.top_k = 0;
+    if(caps.output_mode == MTB_ML_STREAM_OUTPUT_TOPK)
+    {
+        caps.top_k = config->top_k;
+        if((caps.top_k == 0) || (caps.top_k > MTB_ML_STREAM_V2_TOPK_MAX) || (caps.top_k > iface->output_size))
+        {
+            printf("ERROR: stream top_k (%d) out of range\r\n", (int)caps.top_k);
+            return MTB_ML_RESULT_BAD_ARG;
+        }
+    }
+    else if(caps.output_mode != MTB_ML_STREAM_OUTPUT_HASH)
+    {
+        caps.output_mode = MTB_ML_STREAM_OUTPUT_FULL;
+    }
+    top_k = caps.top_k;
+    output_mode = caps.output_mode;
+    result = stream_send_data(iface, &caps, sizeof(caps), DEFAULT_TX_TIMEOUT);
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        return result;
+    }
+
+    result = stream_get_data(iface, reply, sizeof(reply), DEFAULT_RX_TIMEOUT);
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        return result;
+    }
+    if(strncmp(reply, ML_TC_V2_DECLINE_STRING, sizeof(reply)) == 0)
+    {
+        printf("Host declined stream protocol v2\r\n");
+        return MTB_ML_RESULT_SUCCESS;
+    }
+    if(strncmp(reply, ML_TC_V2_ACCEPT_STRING, sizeof(reply)) != 0)
+    {
+        printf("ERROR: Expected string %s but got string %.*s\r\n", ML_TC_V2_ACCEPT_STRING, (int)sizeof(reply), reply);
+        return MTB_ML_RESULT_COMM_ERROR;
+    }
+
+    /* The host echoes the capabilities with the batch size it accepts */
+    result = stream_get_data(iface, &caps, sizeof(caps), DEFAULT_RX_TIMEOUT);
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        return result;
+    }
+    /* At most one of the offered codecs, the offered output mode or full results */
+    if((caps.version != MTB_ML_STREAM_V2_VERSION) || (caps.batch_frames == 0) || (caps.batch_frames > batch_frames) ||
+       ((caps.codecs & ~codecs) != 0) || ((caps.codecs & (caps.codecs - 1)) != 0) ||
+       ((caps.output_mode != MTB_ML_STREAM_OUTPUT_FULL) && ((caps.output_mode != output_mode) || (caps.top_k != top_k))))
+    {
+        printf("ERROR: invalid stream protocol v2 parameters from host\r\n");
+        return MTB_ML_RESULT_COMM_ERROR;
+    }
+
+    iface->protocol_version = MTB_ML_STREAM_V2_VERSION;
+    iface->batch_frames = caps.batch_frames;
+    iface->codec = caps.codecs;
+    iface->rx_slack = (uint32_t)(config->rx_buffer_size - iface->batch_frames * frame_bytes);
+    iface->output_mode = caps.output_mode;
+    iface->top_k = (caps.output_mode == MTB_ML_STREAM_OUTPUT_TOPK) ? caps.top_k : 0;
+    printf("Stream protocol v2, %d frames per batch, codec %s, output %s\r\n", (int)iface->batch_frames,
+           (iface->codec == MTB_ML_STREAM_CODEC_DELTA16) ? "delta16" :
+           (iface->codec == MTB_ML_STREAM_CODEC_LZ4) ? "lz4" : "none",
+           (iface->output_mode == MTB_ML_STREAM_OUTPUT_TOPK) ? "top-k" :
+           (iface->output_mode == MTB_ML_STREAM_OUTPUT_HASH) ? "hash" : "full");
+    return MTB_ML_RESULT_SUCCESS;
+}
+
 static cy_rslt_t stream_verify_test_data(   mtb_ml_stream_interface_t *iface,
-                                            const mtb_ml_model_t *model_object)
+                                            const mtb_ml_model_t *model_object,
+                                            const mtb_ml_stream_config_t *config)
 {
     cy_rslt_t result;
     mtb_ml_x_file_header_t test_data_info;
@@ -292,21 +826,21 @@ static cy_rslt_t stream_verify_test_data(   mtb_ml_stream_interface_t *iface,
         case(MTB_ML_X_DATA_FLOAT32):
             if(input_type_size != sizeof(float))
             {
-                printf("ERROR: Test data size (%d) does not match model data size (%d).\r\n", sizeof(float), input_type_size);
+                printf("ERROR: Test data size (%d) does not match model data size (%d).\r\n", (int)sizeof(float), input_type_size);
                 return MTB_ML_RESULT_INPUT_ERROR;
             }
             break;
         case(MTB_ML_X_DATA_INT8):
             if(input_type_size != sizeof(int8_t))
             {
-                printf("ERROR: Test data size (%d) does not match model data size (%d).\r\n", sizeof(int8_t), input_type_size);
+                printf("ERROR: Test data size (%d) does not match model data size (%d).\r\n", (int)sizeof(int8_t), input_type_size);
                 return MTB_ML_RESULT_INPUT_ERROR;
             }
             break;
         case(MTB_ML_X_DATA_INT16):
             if(input_type_size != sizeof(int16_t))
             {
-                printf("ERROR: Test data size (%d) does not match model data size (%d).\r\n", sizeof(int16_t), input_type_size);
+                printf("ERROR: Test data size (%d) does not match model data size (%d).\r\n", (int)sizeof(int16_t), input_type_size);
                 return MTB_ML_RESULT_INPUT_ERROR;
             }
             break;
@@ -315,26 +849,82 @@ static cy_rslt_t stream_verify_test_data(   mtb_ml_stream_interface_t *iface,
             return MTB_ML_RESULT_BAD_ARG;
     }
 
+    /* Results are reduced by the element type of the model output, not of the dataset */
+    switch(model_object->output_type_size)
+    {
+        case(sizeof(float)):
+            iface->output_data_type = MTB_ML_X_DATA_FLOAT32;
+            break;
+        case(sizeof(int8_t)):
+            iface->output_data_type = MTB_ML_X_DATA_INT8;
+            break;
+        case(sizeof(int16_t)):
+            iface->output_data_type = MTB_ML_X_DATA_INT16;
+            break;
+        default:
+            printf("ERROR: Unsupported model output data size (%d)\r\n", model_object->output_type_size);
+            return MTB_ML_RESULT_BAD_MODEL;
+    }
+
     /* Initialize interface */
     iface->input_size = (size_t)test_data_info.input_size;
     iface->output_size = (size_t)model_object->output_size;
+    iface->output_type_bytes = (size_t)model_object->output_type_size;
 
     /* Updata x data info */
+    iface->x_data_info.data_type = test_data_info.data_type;
     iface->x_data_info.num_of_samples = test_data_info.num_of_samples;
     iface->x_data_info.input_size = test_data_info.input_size;
     iface->x_data_info.recurrent_ts_size = test_data_info.recurrent_ts_size;
 
+    iface->protocol_version = 1;
+    iface->batch_frames = 1;
+    iface->seq = 0;
+    iface->codec = 0;
+    iface->rx_slack = 0;
+    iface->output_mode = MTB_ML_STREAM_OUTPUT_FULL;
+    iface->top_k = 0;
+    iface->sent_results = NULL;
+
+    /* Batched protocol is opt-in, the host may still decline it */
+    if((config != NULL) && ((config->batch_frames > 1) || (config->output_mode != MTB_ML_STREAM_OUTPUT_FULL)))
+    {
+        return stream_negotiate_v2(iface, config);
+    }
+
     return MTB_ML_RESULT_SUCCESS;
 }
 
 static cy_rslt_t stream_send_data(mtb_ml_stream_interface_t *iface, void* tx_buf, size_t tx_length, uint32_t timeout_ms)
 {
-    return mtb_data_streaming_send(iface->interface_obj, (uint8_t *)tx_buf, tx_length, (void *)(&timeout_ms));
+    uint64_t start = 0, end = 0;
+    cy_rslt_t result;
+
+    mtb_ml_model_profile_get_tsc(&start);
+    result = mtb_data_streaming_send(iface->interface_obj, (uint8_t *)tx_buf, tx_length, (void *)(&timeout_ms));
+    mtb_ml_model_profile_get_tsc(&end);
+    if(result == MTB_ML_RESULT_SUCCESS)
+    {
+        iface->stats.tx_bytes += tx_length;
+        iface->stats.tx_cycles += end - start;
+    }
+    return result;
 }
 
 static cy_rslt_t stream_get_data(mtb_ml_stream_interface_t *iface, void* rx_buf, size_t rx_length, uint32_t timeout_ms)
 {
-    return mtb_data_streaming_receive(iface->interface_obj, (uint8_t *)rx_buf, rx_length, (void *)(&timeout_ms));
+    uint64_t start = 0, end = 0;
+    cy_rslt_t result;
+
+    mtb_ml_model_profile_get_tsc(&start);
+    result = mtb_data_streaming_receive(iface->interface_obj, (uint8_t *)rx_buf, rx_length, (void *)(&timeout_ms));
+    mtb_ml_model_profile_get_tsc(&end);
+    if(result == MTB_ML_RESULT_SUCCESS)
+    {
+        iface->stats.rx_bytes += rx_length;
+        iface->stats.rx_cycles += end - start;
+    }
+    return result;
 }
 
 static cy_rslt_t stream_get_string(mtb_ml_stream_interface_t *iface, const char *string, size_t size, uint32_t timeout_ms)
@@ -356,6 +946,67 @@ static cy_rslt_t stream_get_string(mtb_ml_stream_interface_t *iface, const char
     return result;
 }
 
+/* Reduces the results of tx_buf chunk by chunk, into the CRC when crc is given, to the host otherwise */
+static cy_rslt_t stream_send_reduced(mtb_ml_stream_interface_t *iface, const void *tx_buf, uint32_t frames,
+                                     uint32_t *crc, uint32_t timeout_ms)
+{
+    uint8_t chunk[MTB_ML_STREAM_V2_TOPK_MAX * (sizeof(uint32_t) + sizeof(float))];
+    size_t result_bytes = iface->output_size * iface->output_type_bytes;
+    size_t record = mtb_ml_stream_reduced_bytes(iface->output_mode, iface->top_k, iface->output_size,
+                                                iface->output_data_type);
+    size_t used = 0;
+    cy_rslt_t result = MTB_ML_RESULT_SUCCESS;
+
+    for(uint32_t i = 0; (i <= frames) && (result == MTB_ML_RESULT_SUCCESS); i++)
+    {
+        if((i == frames) || (used + record > sizeof(chunk)))
+        {
+            if(crc != NULL)
+            {
+                *crc = mtb_ml_stream_crc32(*crc, chunk, used);
+            }
+            else if(used > 0)
+            {
+                result = stream_send_data(iface, chunk, used, timeout_ms);
+            }
+            used = 0;
+        }
+        if(i < frames)
+        {
+            mtb_ml_stream_reduce(iface->output_mode, iface->top_k, (const uint8_t *)tx_buf + i * result_bytes,
+                                 (uint32_t)iface->output_size, iface->output_data_type, chunk + used);
+            used += record;
+        }
+    }
+    return result;
+}
+
+static cy_rslt_t stream_resend_results(mtb_ml_stream_interface_t *iface, const mtb_ml_stream_v2_hdr_t *hdr,
+                                       uint32_t timeout_ms)
+{
+    mtb_ml_stream_v2_hdr_t res;
+    cy_rslt_t result;
+
+    if((iface->sent_results == NULL) || (hdr->seq != iface->sent_results_seq))
+    {
+        printf("ERROR: host asks for results %" PRIu32 " not kept\r\n", hdr->seq);
+        return MTB_ML_RESULT_COMM_ERROR;
+    }
+
+    res.magic = MTB_ML_STREAM_V2_MAGIC;
+    res.type = MTB_ML_STREAM_V2_RESULTS;
+    res.count = (uint16_t)iface->sent_results_frames;
+    res.seq = hdr->seq;
+    res.length = iface->sent_results_frames * iface->output_size * iface->output_type_bytes;
+    res.crc = mtb_ml_stream_crc32(0, iface->sent_results, res.length);
+    result = stream_send_data(iface, &res, sizeof(res), timeout_ms);
+    if(result == MTB_ML_RESULT_SUCCESS)
+    {
+        result = stream_send_data(iface, (void *)iface->sent_results, res.length, timeout_ms);
+    }
+    return result;
+}
+
 static cy_rslt_t send_model_regr_info(mtb_ml_stream_interface_t *iface, const mtb_ml_model_t *model_object)
 {
     cy_rslt_t result;
@@ -387,19 +1038,79 @@ static cy_rslt_t send_model_regr_info(mtb_ml_stream_interface_t *iface, const mt
     return stream_send_data(iface, (void *)&model_regr_info, sizeof(model_regr_info), DEFAULT_TX_TIMEOUT);
 }
 
-static cy_rslt_t stream_setup(mtb_data_streaming_interface_t* iface)
+static cy_rslt_t stream_setup(mtb_ml_stream_interface_t *iface, const mtb_ml_stream_config_t *config)
 {
-    iface->send     = stream_uart_send;
-    iface->receive  = stream_uart_get;
+    mtb_data_streaming_interface_t* iface_obj = iface->interface_obj;
+
+    memset(&iface->stats, 0, sizeof(iface->stats));
+
+    /* Transport set up by the application */
+    if((config != NULL) && (config->transport != NULL))
+    {
+        iface->transport_name = config->transport->name;
+        return mtb_ml_stream_register_transport(iface_obj, config->transport);
+    }
+
+#if defined(COMPONENT_ML_HOST)
+    printf("ERROR: host build requires a stream transport\r\n");
+    return MTB_ML_RESULT_BAD_ARG;
+#else
+    iface->transport_name = STREAM_TRANSPORT_NAME;
+    iface_obj->send     = stream_uart_send;
+    iface_obj->receive  = stream_uart_get;
+    iface_obj->send_async       = NULL;
+    iface_obj->receive_async    = NULL;
+    iface_obj->wait             = NULL;
     /* for CY_HAL rely on object allocated in retarget-io itself */
 #if !defined(COMPONENT_MTB_HAL)
-    mtb_data_streaming_context_t *context = (mtb_data_streaming_context_t *)&(iface->context);
+    mtb_data_streaming_context_t *context = (mtb_data_streaming_context_t *)&(iface_obj->context);
     context->obj_inst.uart = &cy_retarget_io_uart_obj;
+#if MTB_ML_STREAM_UART_ASYNC
+    /* Transfers complete in the UART event callback through the stream tag */
+    if(iface->stream_tag == NULL)
+    {
+        printf("ERROR: async UART stream requires stream_tag\r\n");
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    /* The event callback and the transfers in flight would clash with printf() on the retarget-io UART */
+    if((config == NULL) || (config->uart == NULL) || (config->uart == &cy_retarget_io_uart_obj))
+    {
+        printf("ERROR: async UART stream requires a UART other than retarget-io\r\n");
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    context->obj_inst.uart = config->uart;
+#if defined(CY_RTOS_AWARE)
+    if(stream_uart_sem_init() != CY_RSLT_SUCCESS)
+    {
+        return MTB_ML_RESULT_ALLOC_ERR;
+    }
+#endif
+    context->callback = mtb_ml_stream_cb;
+    context->call_tag = iface->stream_tag;
+#if MTB_ML_STREAM_UART_DMA
+    if(cyhal_uart_set_async_mode(context->obj_inst.uart, CYHAL_ASYNC_DMA, CYHAL_DMA_PRIORITY_DEFAULT) != CY_RSLT_SUCCESS)
+    {
+        return MTB_ML_RESULT_COMM_ERROR;
+    }
+#endif
+    cyhal_uart_register_callback(context->obj_inst.uart, stream_uart_event_cb, context);
+    cyhal_uart_enable_event(context->obj_inst.uart,
+                            (cyhal_uart_event_t)(CYHAL_UART_IRQ_TX_DONE | CYHAL_UART_IRQ_RX_DONE |
+                                                 CYHAL_UART_IRQ_TX_ERROR | CYHAL_UART_IRQ_RX_ERROR),
+                            MTB_ML_STREAM_UART_IRQ_PRIORITY, true);
+    iface_obj->send     = stream_uart_send_async;
+    iface_obj->receive  = stream_uart_get_async;
+    iface_obj->send_async       = stream_uart_send_start;
+    iface_obj->receive_async    = stream_uart_get_start;
+    iface_obj->wait             = stream_uart_async_wait;
+#endif
 #endif
 
     return CY_RSLT_SUCCESS;
+#endif /* defined(COMPONENT_ML_HOST) */
 }
 
+#if !defined(COMPONENT_ML_HOST)
 #if !defined(COMPONENT_MTB_HAL)
 #define ml_uart_writable   cyhal_uart_writable
 #define ml_uart_write      cyhal_uart_write
@@ -489,6 +1200,200 @@ static cy_rslt_t stream_uart_get(mtb_data_streaming_vcontext_t* vcontext,
     return MTB_ML_RESULT_SUCCESS;
 }
 
+#if MTB_ML_STREAM_UART_ASYNC && !defined(COMPONENT_MTB_HAL)
+/* Delay step of a bare-metal wait with a timeout */
+#define STREAM_UART_WAIT_STEP_US    (10)
+
+/* Tags of the transfers in flight, TX and RX complete independently */
+static mtb_ml_stream_tag_t * volatile stream_uart_tx_tag = NULL;
+static mtb_ml_stream_tag_t * volatile stream_uart_rx_tag = NULL;
+#if defined(CY_RTOS_AWARE)
+/* Given by the event callback on completion, the waiting task blocks on them */
+static cy_semaphore_t stream_uart_tx_sem;
+static cy_semaphore_t stream_uart_rx_sem;
+static bool stream_uart_sem_ready = false;
+
+static cy_rslt_t stream_uart_sem_init(void)
+{
+    if(!stream_uart_sem_ready)
+    {
+        if(cy_rtos_init_semaphore(&stream_uart_tx_sem, 1, 0) != CY_RSLT_SUCCESS)
+        {
+            return MTB_ML_RESULT_ALLOC_ERR;
+        }
+        if(cy_rtos_init_semaphore(&stream_uart_rx_sem, 1, 0) != CY_RSLT_SUCCESS)
+        {
+            (void)cy_rtos_semaphore_deinit(&stream_uart_tx_sem);
+            return MTB_ML_RESULT_ALLOC_ERR;
+        }
+        stream_uart_sem_ready = true;
+    }
+    return CY_RSLT_SUCCESS;
+}
+
+/* Drops a completion left over by a transfer that timed out */
+static void stream_uart_sem_clear(cy_semaphore_t *sem)
+{
+    while(cy_rtos_get_semaphore(sem, 0, false) == CY_RSLT_SUCCESS)
+    {
+    }
+}
+#endif
+
+static void stream_uart_event_cb(void *callback_arg, cyhal_uart_event_t event)
+{
+    mtb_data_streaming_context_t *context = (mtb_data_streaming_context_t *)callback_arg;
+
+    if(event & (CYHAL_UART_IRQ_TX_ERROR | CYHAL_UART_IRQ_TX_DONE))
+    {
+        context->callback(stream_uart_tx_tag,
+                          (event & CYHAL_UART_IRQ_TX_ERROR) ? MTB_ML_RESULT_COMM_ERROR : MTB_ML_RESULT_SUCCESS);
+#if defined(CY_RTOS_AWARE)
+        (void)cy_rtos_set_semaphore(&stream_uart_tx_sem, true);
+#endif
+    }
+    if(event & (CYHAL_UART_IRQ_RX_ERROR | CYHAL_UART_IRQ_RX_DONE))
+    {
+        context->callback(stream_uart_rx_tag,
+                          (event & CYHAL_UART_IRQ_RX_ERROR) ? MTB_ML_RESULT_COMM_ERROR : MTB_ML_RESULT_SUCCESS);
+#if defined(CY_RTOS_AWARE)
+        (void)cy_rtos_set_semaphore(&stream_uart_rx_sem, true);
+#endif
+    }
+}
+
+/* Waits for the transfer completion signalled through the stream tag, a timeout of 0 waits forever.
+ * With an RTOS the task blocks on the completion semaphore. Bare metal sleeps in WFI until the
+ * completion interrupt when waiting forever. Neither the TSC nor a periodic wake up is guaranteed
+ * there, so a finite timeout is counted in delay steps as by the polling transfers. */
+static cy_rslt_t stream_uart_async_wait(mtb_data_streaming_vcontext_t* vcontext, void* tag, bool tx,
+                                        uint32_t timeout_ms)
+{
+    mtb_data_streaming_context_t *context = (mtb_data_streaming_context_t *)vcontext;
+    volatile mtb_ml_stream_tag_t *stream_tag = (volatile mtb_ml_stream_tag_t *)tag;
+    bool timed_out = false;
+#if defined(CY_RTOS_AWARE)
+    cy_semaphore_t *sem = tx ? &stream_uart_tx_sem : &stream_uart_rx_sem;
+
+    while(!stream_tag->stream_done && !timed_out)
+    {
+        timed_out = (cy_rtos_get_semaphore(sem, (timeout_ms == 0) ? CY_RTOS_NEVER_TIMEOUT : timeout_ms, false)
+                     != CY_RSLT_SUCCESS);
+    }
+#else
+    uint32_t steps = timeout_ms * (1000 / STREAM_UART_WAIT_STEP_US);
+
+    while(!stream_tag->stream_done && !timed_out)
+    {
+        if(timeout_ms == 0)
+        {
+            /* Interrupts masked between the check and WFI, a completion in between still wakes it up */
+            uint32_t state = cyhal_system_critical_section_enter();
+            if(!stream_tag->stream_done)
+            {
+                __WFI();
+            }
+            cyhal_system_critical_section_exit(state);
+        }
+        else
+        {
+            (void)ml_system_delay_us(STREAM_UART_WAIT_STEP_US);
+            timed_out = (--steps == 0);
+        }
+    }
+#endif
+    if(!stream_tag->stream_done)
+    {
+        if(tx)
+        {
+            (void)cyhal_uart_write_abort(context->obj_inst.uart);
+        }
+        else
+        {
+            (void)cyhal_uart_read_abort(context->obj_inst.uart);
+        }
+        return MTB_ML_RESULT_TIMEOUT;
+    }
+    return stream_tag->stream_status;
+}
+
+static cy_rslt_t stream_uart_send_start(mtb_data_streaming_vcontext_t* vcontext,
+                                        void* data, size_t count, void* tag)
+{
+    mtb_data_streaming_context_t *context = (mtb_data_streaming_context_t *)vcontext;
+    mtb_ml_stream_tag_t *stream_tag = (mtb_ml_stream_tag_t *)tag;
+
+    stream_tag->stream_done = false;
+    stream_uart_tx_tag = stream_tag;
+#if defined(CY_RTOS_AWARE)
+    stream_uart_sem_clear(&stream_uart_tx_sem);
+#endif
+    if(cyhal_uart_write_async(context->obj_inst.uart, data, count) != CY_RSLT_SUCCESS)
+    {
+        return MTB_ML_RESULT_COMM_ERROR;
+    }
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+static cy_rslt_t stream_uart_get_start(mtb_data_streaming_vcontext_t* vcontext,
+                                       uint8_t* data, size_t count, void* tag)
+{
+    mtb_data_streaming_context_t *context = (mtb_data_streaming_context_t *)vcontext;
+    mtb_ml_stream_tag_t *stream_tag = (mtb_ml_stream_tag_t *)tag;
+
+    stream_tag->stream_done = false;
+    stream_uart_rx_tag = stream_tag;
+#if defined(CY_RTOS_AWARE)
+    stream_uart_sem_clear(&stream_uart_rx_sem);
+#endif
+    if(cyhal_uart_read_async(context->obj_inst.uart, data, count) != CY_RSLT_SUCCESS)
+    {
+        return MTB_ML_RESULT_COMM_ERROR;
+    }
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+static cy_rslt_t stream_uart_send_async(mtb_data_streaming_vcontext_t* vcontext,
+                                        void* data, size_t count, void* tag)
+{
+    mtb_data_streaming_context_t *context = (mtb_data_streaming_context_t *)vcontext;
+    /* tag is the timeout in ms */
+    uint32_t timeout_ms = *((uint32_t *)tag);
+
+    cy_rslt_t result = stream_uart_send_start(vcontext, data, count, context->call_tag);
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        return result;
+    }
+    return stream_uart_async_wait(vcontext, context->call_tag, true, timeout_ms);
+}
+
+static cy_rslt_t stream_uart_get_async(mtb_data_streaming_vcontext_t* vcontext,
+                                       uint8_t* data, size_t count, void* tag)
+{
+    mtb_data_streaming_context_t *context = (mtb_data_streaming_context_t *)vcontext;
+    /* tag is the timeout in ms */
+    uint32_t timeout_ms = *((uint32_t *)tag);
+
+    cy_rslt_t result = stream_uart_get_start(vcontext, data, count, context->call_tag);
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        return result;
+    }
+    return stream_uart_async_wait(vcontext, context->call_tag, false, timeout_ms);
+}
+#endif
+#endif /* !defined(COMPONENT_ML_HOST) */
+
+static void stream_delay_us(uint32_t us)
+{
+#if defined(COMPONENT_ML_HOST)
+    (void)usleep(us);
+#else
+    (void)ml_system_delay_us(us);
+#endif
+}
+
 static inline cy_rslt_t mtb_data_streaming_receive(mtb_data_streaming_interface_t* iface,
                                                    uint8_t* data, size_t count, void* tag)
 {
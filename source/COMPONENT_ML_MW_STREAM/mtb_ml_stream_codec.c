@@ -0,0 +1,191 @@
+/***************************************************************************//**
+* \file mtb_ml_stream_codec.c
+*
+* \brief
+* This file contains the frame payload decoders of ML validation data streaming
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#include <string.h>
+
+#include "mtb_ml_stream_impl.h"
+
+/*******************************************************************************
+ * Private Functions
+*******************************************************************************/
+/* Reads an LZ4 length continuation, bytes of 255 extend it */
+static bool codec_lz4_length(const uint8_t **in, const uint8_t *in_end, size_t *len)
+{
+    uint8_t b;
+
+    do
+    {
+        if(*in == in_end)
+        {
+            return false;
+        }
+        b = *(*in)++;
+        *len += b;
+    } while(b == 255);
+    return true;
+}
+
+/* Zig-zag varint of the delta to the previous int16 sample, little-endian samples */
+static bool codec_delta16_decode(uint8_t *dst, size_t dst_size, const uint8_t *src, size_t src_size, bool inplace)
+{
+    const uint8_t *in = src;
+    const uint8_t *in_end = src + src_size;
+    uint16_t sample = 0;
+
+    if((dst_size & 1) != 0)
+    {
+        return false;
+    }
+
+    for(size_t out = 0; out < dst_size; out += 2)
+    {
+        uint32_t zz = 0;
+        uint8_t b;
+
+        for(uint32_t shift = 0; ; shift += 7)
+        {
+            if((in == in_end) || (shift > 14))
+            {
+                return false;
+            }
+            b = *in++;
+            zz |= (uint32_t)(b & 0x7F) << shift;
+            if((b & 0x80) == 0)
+            {
+                break;
+            }
+        }
+        if(zz > 0xFFFF)
+        {
+            return false;
+        }
+        sample += (uint16_t)((zz >> 1) ^ (0U - (zz & 1)));
+
+        /* Output must not overtake the input still to be read */
+        if(inplace && (dst + out + 2 > in))
+        {
+            return false;
+        }
+        dst[out] = (uint8_t)sample;
+        dst[out + 1] = (uint8_t)(sample >> 8);
+    }
+    return in == in_end;
+}
+
+/* LZ4 block format, sequences of literals and a match, the last one has literals only */
+static bool codec_lz4_decode(uint8_t *dst, size_t dst_size, const uint8_t *src, size_t src_size, bool inplace)
+{
+    const uint8_t *in = src;
+    const uint8_t *in_end = src + src_size;
+    uint8_t *out = dst;
+    uint8_t *out_end = dst + dst_size;
+
+    while(in < in_end)
+    {
+        uint8_t token = *in++;
+        size_t len = token >> 4;
+        size_t offset;
+
+        if((len == 15) && !codec_lz4_length(&in, in_end, &len))
+        {
+            return false;
+        }
+        if((len > (size_t)(in_end - in)) || (len > (size_t)(out_end - out)))
+        {
+            return false;
+        }
+        /* In place the output stays behind the input, memmove covers the overlap */
+        memmove(out, in, len);
+        out += len;
+        in += len;
+        if(in == in_end)
+        {
+            break;
+        }
+
+        if(in_end - in < 2)
+        {
+            return false;
+        }
+        offset = (size_t)in[0] | ((size_t)in[1] << 8);
+        in += 2;
+        len = token & 0x0F;
+        if((len == 15) && !codec_lz4_length(&in, in_end, &len))
+        {
+            return false;
+        }
+        len += 4;
+        if((offset == 0) || (offset > (size_t)(out - dst)) || (len > (size_t)(out_end - out)) ||
+           (inplace && (out + len > in)))
+        {
+            return false;
+        }
+        /* Byte copy, the match may overlap its own output */
+        for(const uint8_t *match = out - offset; len > 0; len--)
+        {
+            *out++ = *match++;
+        }
+    }
+    return out == out_end;
+}
+
+/*******************************************************************************
+ * Public Functions
+*******************************************************************************/
+bool mtb_ml_stream_codec_decode(uint32_t codec, void *dst, size_t dst_size, const void *src, size_t src_size)
+{
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+    /* Coded payload received behind the start of the frames, decoded in place */
+    bool inplace = (s >= d) && (s < d + dst_size);
+
+    if((s < d) && (s + src_size > d))
+    {
+        return false;
+    }
+
+    switch(codec)
+    {
+        case MTB_ML_STREAM_CODEC_DELTA16:
+            return codec_delta16_decode(d, dst_size, s, src_size, inplace);
+        case MTB_ML_STREAM_CODEC_LZ4:
+            return codec_lz4_decode(d, dst_size, s, src_size, inplace);
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,219 @@
+/***************************************************************************//**
+* \file mtb_ml_stream_impl.h
+*
+* \brief
+* This file contains the wire protocol of ML validation data streaming feature
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#if !defined(__MTB_ML_STREAM_IMPL_H__)
+#define __MTB_ML_STREAM_IMPL_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* The host peer tool shares the protocol definitions only */
+#if defined(COMPONENT_ML_MW_STREAM)
+#include "mtb_ml_stream.h"
+#endif
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * Macros
+*******************************************************************************/
+/* NOTE: Must match mtb_ml_regression_info_t in streaming application */
+#define ML_PROFILE_FRAME_STRING         "Frame "
+#define ML_PROFILE_OUTPUT_STRING        " output:"
+#define ML_PROFILE_INFO_STRING          "PROFILE_INFO,"
+
+#define ML_TC_START_STRING              "ML_START"
+#define ML_CT_READY_STRING              "ML_READY"
+#define ML_TC_MODEL_DATA_REQ_STRING     "ML_MODEL_DATA_REQ"
+#define ML_CT_MODEL_DATA_STRING         "ML_MODEL_DATA"
+#define ML_TC_DATASET_REQ_SEND_STRING   "ML_DATASET_SENDREQ"
+#define ML_CT_FRAME_REQ_STRING          "ML_FRAME"
+#define ML_CT_RESULT_STRING             "ML_RESULT"
+#define ML_TC_DONE_STRING               "ML_COMPLETED"
+#define ML_CT_DONE_STRING               "ML_DONE"
+#define ML_ERROR_STRING                 "ERROR"
+
+/* Protocol v2 negotiation, sent by the device after the dataset header.
+ * Both host replies have the same length. */
+#define ML_CT_V2_OFFER_STRING           "ML_V2"
+#define ML_TC_V2_ACCEPT_STRING          "ML_V2_OK"
+#define ML_TC_V2_DECLINE_STRING         "ML_V2_NO"
+
+#define MTB_ML_STREAM_V2_VERSION        (2)
+/* "MLB2" little-endian */
+#define MTB_ML_STREAM_V2_MAGIC          (0x32424C4DUL)
+
+/* Batch types */
+#define MTB_ML_STREAM_V2_FRAME_REQ      (1) /* device -> host, requests count frames, length is the
+                                             * slack past them available for in place decoding */
+#define MTB_ML_STREAM_V2_FRAMES         (2) /* host -> device, count frames */
+#define MTB_ML_STREAM_V2_RESULTS        (3) /* device -> host, count results */
+#define MTB_ML_STREAM_V2_NACK           (4) /* device -> host, resend the batch with the same seq */
+#define MTB_ML_STREAM_V2_FRAMES_CODED   (5) /* host -> device, count frames in the negotiated codec */
+#define MTB_ML_STREAM_V2_RESULT_REQ     (6) /* host -> device, answers a frame request ahead of the frames:
+                                             * resend the results with seq in full */
+#define MTB_ML_STREAM_V2_RESULTS_REDUCED (7) /* device -> host, count results in the negotiated output mode */
+
+/* Largest top_k of MTB_ML_STREAM_OUTPUT_TOPK */
+#define MTB_ML_STREAM_V2_TOPK_MAX       (32)
+
+#if !defined(MTB_ML_STREAM_CODEC_DELTA16)
+/* Host tools are built without mtb_ml_stream.h, values must match it */
+#define MTB_ML_STREAM_CODEC_DELTA16     (1UL << 0)
+#define MTB_ML_STREAM_CODEC_LZ4         (1UL << 1)
+#endif
+#if !defined(MTB_ML_STREAM_OUTPUT_FULL)
+#define MTB_ML_STREAM_OUTPUT_FULL       (0)
+#define MTB_ML_STREAM_OUTPUT_TOPK       (1)
+#define MTB_ML_STREAM_OUTPUT_HASH       (2)
+#endif
+
+/*******************************************************************************
+ * Typedefs
+*******************************************************************************/
+/* NOTE: Must match mtb_ml_regression_info_t in streaming application */
+typedef struct
+{
+    uint32_t output_size;       /* NN model inference classification output size */
+    uint32_t buffer_size;       /* Runtime buffer size required for inference */
+    uint32_t model_size;        /* Model's weights & biases */
+    uint32_t model_time_steps;  /* Number of model time steps */
+    int output_zero_point;      /* Model's output data zero point */
+    float output_scale;         /* Model's output data */
+} mtb_ml_regression_info_t;
+
+/* Protocol v2 capabilities, offered by the device and echoed with the
+ * accepted batch size by the host */
+typedef struct
+{
+    uint32_t version;           /* MTB_ML_STREAM_V2_VERSION */
+    uint32_t batch_frames;      /* Frames per batch, host may lower it */
+    uint32_t frame_bytes;       /* Bytes of one input frame */
+    uint32_t result_bytes;      /* Bytes of one result */
+    uint32_t codecs;            /* Codecs offered by the device, the one chosen by the host or 0 */
+    uint32_t output_mode;       /* Output mode offered by the device, echoed or MTB_ML_STREAM_OUTPUT_FULL */
+    uint32_t top_k;             /* Results per frame of MTB_ML_STREAM_OUTPUT_TOPK */
+} mtb_ml_stream_v2_caps_t;
+
+/* Header preceding every v2 batch, followed by length bytes of payload */
+typedef struct
+{
+    uint32_t magic;             /* MTB_ML_STREAM_V2_MAGIC */
+    uint16_t type;              /* MTB_ML_STREAM_V2_* batch type */
+    uint16_t count;             /* Frames or results in the batch */
+    uint32_t seq;               /* Sequence number, a NACK or resend repeats it */
+    uint32_t length;            /* Payload bytes */
+    uint32_t crc;               /* CRC32 (IEEE 802.3) of the payload */
+} mtb_ml_stream_v2_hdr_t;
+
+#if defined(COMPONENT_ML_MW_STREAM)
+/* Transfer in flight on one direction of the link */
+typedef struct
+{
+    mtb_ml_stream_tag_t tag;    /* Completed through mtb_ml_stream_cb() */
+    uint64_t start_cycles;      /* Time the transfer was started */
+    uint64_t busy_cycles;       /* Start to completion, valid after a successful wait */
+    size_t length;              /* Bytes transferred */
+    bool tx;                    /* Direction, true for device -> host */
+    bool pending;               /* Started and not waited for yet */
+} mtb_ml_stream_xfer_t;
+#endif
+
+/*******************************************************************************
+ * Function prototypes
+*******************************************************************************/
+/* CRC32 (IEEE 802.3), pass 0 as crc for the first chunk */
+uint32_t mtb_ml_stream_crc32(uint32_t crc, const void *data, size_t size);
+
+/* Decodes a coded payload into exactly dst_size bytes. src could overlap dst from its
+ * start on, decoding then fails instead of overwriting input not read yet. */
+bool mtb_ml_stream_codec_decode(uint32_t codec, void *dst, size_t dst_size, const void *src, size_t src_size);
+
+/* 64-bit FNV-1a hash */
+uint64_t mtb_ml_stream_fnv1a64(const void *data, size_t size);
+
+/* Indices of the k largest of count values of mtb_ml_x_data_type_t data_type, the largest
+ * first and the lower index first on a tie */
+void mtb_ml_stream_topk(const void *data, uint32_t count, uint32_t data_type, uint32_t k, uint32_t *indices);
+
+/* Bytes of one result of count values in an output mode */
+size_t mtb_ml_stream_reduced_bytes(uint32_t mode, uint32_t top_k, uint32_t count, uint32_t data_type);
+
+/* Reduces one result of count values. MTB_ML_STREAM_OUTPUT_TOPK gives top_k uint32_t indices
+ * followed by their values, MTB_ML_STREAM_OUTPUT_HASH the hash of the result bytes. */
+void mtb_ml_stream_reduce(uint32_t mode, uint32_t top_k, const void *result, uint32_t count, uint32_t data_type,
+                          void *dst);
+
+/* Compares two reduced results of size bytes, top-k results match on their indices */
+bool mtb_ml_stream_reduced_match(uint32_t mode, uint32_t top_k, const void *a, const void *b, size_t size);
+
+#if defined(COMPONENT_ML_MW_STREAM)
+/* Bytes of one input frame, a time step slice for streaming RNN models */
+size_t mtb_ml_stream_frame_bytes(const mtb_ml_stream_interface_t *iface);
+
+/* Checks the header of a frames batch answering the request req */
+bool mtb_ml_stream_frames_hdr_valid(const mtb_ml_stream_interface_t *iface, const mtb_ml_stream_v2_hdr_t *hdr,
+                                    const mtb_ml_stream_v2_hdr_t *req);
+
+/* Position of the batch payload in the frames buffer: a raw batch at the start, a coded
+ * one ending at the end of the buffer of the request, the slack included */
+uint8_t *mtb_ml_stream_frames_payload(const mtb_ml_stream_interface_t *iface, const mtb_ml_stream_v2_hdr_t *hdr,
+                                      const mtb_ml_stream_v2_hdr_t *req, void *frames);
+
+/* Decodes a coded batch payload into the frames, a raw batch is left as received */
+bool mtb_ml_stream_frames_decode(const mtb_ml_stream_interface_t *iface, const mtb_ml_stream_v2_hdr_t *hdr,
+                                 void *frames, const void *payload);
+
+/* Starts a transfer with the async operations of the transport. Transports without
+ * them transfer synchronously here, so the wait returns at once. */
+cy_rslt_t mtb_ml_stream_xfer_start(mtb_ml_stream_interface_t *iface, mtb_ml_stream_xfer_t *xfer,
+                                   bool tx, void *buf, size_t length, uint32_t timeout_ms);
+
+/* Waits for a started transfer and accounts it in the stream statistics */
+cy_rslt_t mtb_ml_stream_xfer_wait(mtb_ml_stream_interface_t *iface, mtb_ml_stream_xfer_t *xfer,
+                                  uint32_t timeout_ms);
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __MTB_ML_STREAM_IMPL_H__ */
@@ -0,0 +1,173 @@
+/***************************************************************************//**
+* \file mtb_ml_stream_reduce.c
+*
+* \brief
+* This file contains the result reductions of ML validation data streaming
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#include <string.h>
+
+#include "mtb_ml_dataset.h"
+#include "mtb_ml_stream_impl.h"
+
+/*******************************************************************************
+ * Macros
+*******************************************************************************/
+#define FNV1A64_OFFSET_BASIS    (0xCBF29CE484222325ULL)
+#define FNV1A64_PRIME           (0x00000100000001B3ULL)
+
+/*******************************************************************************
+ * Private Functions
+*******************************************************************************/
+static size_t reduce_type_size(uint32_t data_type)
+{
+    switch(data_type)
+    {
+        case MTB_ML_X_DATA_INT8:
+            return sizeof(int8_t);
+        case MTB_ML_X_DATA_INT16:
+            return sizeof(int16_t);
+        default:
+            return sizeof(float);
+    }
+}
+
+static float reduce_value(const void *data, uint32_t data_type, uint32_t i)
+{
+    switch(data_type)
+    {
+        case MTB_ML_X_DATA_INT8:
+            return (float)((const int8_t *)data)[i];
+        case MTB_ML_X_DATA_INT16:
+            return (float)((const int16_t *)data)[i];
+        default:
+            return ((const float *)data)[i];
+    }
+}
+
+/*******************************************************************************
+ * Public Functions
+*******************************************************************************/
+uint64_t mtb_ml_stream_fnv1a64(const void *data, size_t size)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    uint64_t hash = FNV1A64_OFFSET_BASIS;
+
+    for(size_t i = 0; i < size; i++)
+    {
+        hash ^= p[i];
+        hash *= FNV1A64_PRIME;
+    }
+    return hash;
+}
+
+void mtb_ml_stream_topk(const void *data, uint32_t count, uint32_t data_type, uint32_t k, uint32_t *indices)
+{
+    uint32_t found = 0;
+
+    /* Insertion into the sorted top k, the lower index wins a tie */
+    for(uint32_t i = 0; i < count; i++)
+    {
+        float v = reduce_value(data, data_type, i);
+        uint32_t pos = found;
+
+        while((pos > 0) && (v > reduce_value(data, data_type, indices[pos - 1])))
+        {
+            pos--;
+        }
+        if(pos >= k)
+        {
+            continue;
+        }
+        if(found < k)
+        {
+            found++;
+        }
+        memmove(&indices[pos + 1], &indices[pos], (found - 1 - pos) * sizeof(indices[0]));
+        indices[pos] = i;
+    }
+}
+
+size_t mtb_ml_stream_reduced_bytes(uint32_t mode, uint32_t top_k, uint32_t count, uint32_t data_type)
+{
+    switch(mode)
+    {
+        case MTB_ML_STREAM_OUTPUT_TOPK:
+            return top_k * (sizeof(uint32_t) + reduce_type_size(data_type));
+        case MTB_ML_STREAM_OUTPUT_HASH:
+            return sizeof(uint64_t);
+        default:
+            return count * reduce_type_size(data_type);
+    }
+}
+
+void mtb_ml_stream_reduce(uint32_t mode, uint32_t top_k, const void *result, uint32_t count, uint32_t data_type,
+                          void *dst)
+{
+    size_t type_size = reduce_type_size(data_type);
+    uint8_t *out = (uint8_t *)dst;
+
+    if(mode == MTB_ML_STREAM_OUTPUT_TOPK)
+    {
+        uint32_t indices[MTB_ML_STREAM_V2_TOPK_MAX];
+
+        /* k indices, then their scores in the output data type, records are not aligned */
+        mtb_ml_stream_topk(result, count, data_type, top_k, indices);
+        memcpy(out, indices, top_k * sizeof(uint32_t));
+        for(uint32_t i = 0; i < top_k; i++)
+        {
+            memcpy(out + top_k * sizeof(uint32_t) + i * type_size,
+                   (const uint8_t *)result + indices[i] * type_size, type_size);
+        }
+    }
+    else if(mode == MTB_ML_STREAM_OUTPUT_HASH)
+    {
+        uint64_t hash = mtb_ml_stream_fnv1a64(result, count * type_size);
+        memcpy(out, &hash, sizeof(hash));
+    }
+    else
+    {
+        memcpy(out, result, count * type_size);
+    }
+}
+
+bool mtb_ml_stream_reduced_match(uint32_t mode, uint32_t top_k, const void *a, const void *b, size_t size)
+{
+    /* Top-k results match on their classes, the scores are informative */
+    if(mode == MTB_ML_STREAM_OUTPUT_TOPK)
+    {
+        size = top_k * sizeof(uint32_t);
+    }
+    return memcmp(a, b, size) == 0;
+}
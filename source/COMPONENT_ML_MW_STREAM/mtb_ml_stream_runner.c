@@ -0,0 +1,575 @@
+/***************************************************************************//**
+* \file mtb_ml_stream_runner.c
+*
+* \brief
+* This file contains the pipelined runner of ML validation data streaming
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "mtb_ml_common.h"
+#include "mtb_ml_stream.h"
+#include "mtb_ml_model.h"
+#include "mtb_ml_stream_impl.h"
+
+/*******************************************************************************
+ * Macros
+*******************************************************************************/
+/* Room for the v2 header or the v1 result string in front of each payload */
+#define RUNNER_PREFIX_SIZE  (sizeof(mtb_ml_stream_v2_hdr_t))
+#define RUNNER_ALIGN(x)     (((x) + 3U) & ~(size_t)3U)
+
+/*******************************************************************************
+ * Typedefs
+*******************************************************************************/
+typedef struct
+{
+    mtb_ml_stream_interface_t *iface;
+    mtb_ml_model_t *model;
+    mtb_ml_stream_runner_stats_t *stats;
+    uint32_t timeout_ms;
+    uint32_t unit_frames;           /* Frames per receive, the v2 batch size or 1 */
+    size_t frame_bytes;
+    size_t result_bytes;
+    size_t reduced_bytes;           /* Bytes of a result in a reduced output mode */
+    uint8_t *rx_buf[2];             /* Ping-pong buffers, prefix and payload */
+    uint8_t *tx_buf[2];             /* Full results, then the reduced ones with their own prefix */
+    mtb_ml_stream_v2_hdr_t req;     /* Frame request of protocol v2 */
+    mtb_ml_stream_v2_hdr_t batch_req; /* Frame request the batch in flight answers */
+    bool split;                     /* Coded batches or result requests, header and payload are received apart */
+    bool tx_resend;                 /* Full results resent from a tx buffer */
+    bool rx_hdr_pending;            /* Header of a split batch in flight */
+    uint8_t *rx_pending_buf;        /* Buffer receiving the requested frames */
+    uint32_t rx_pending_frames;
+    mtb_ml_stream_xfer_t rx;
+    mtb_ml_stream_xfer_t tx;
+} stream_runner_t;
+
+/*******************************************************************************
+ * Private Functions
+*******************************************************************************/
+static bool runner_is_v2(const stream_runner_t *runner)
+{
+    return runner->iface->protocol_version == MTB_ML_STREAM_V2_VERSION;
+}
+
+/* Starts a transfer, a transport without async operations stalls the CPU right here */
+static cy_rslt_t runner_start(stream_runner_t *runner, mtb_ml_stream_xfer_t *xfer, bool tx, void *buf, size_t length)
+{
+    uint64_t start = 0, end = 0;
+    cy_rslt_t result;
+
+    mtb_ml_model_profile_get_tsc(&start);
+    result = mtb_ml_stream_xfer_start(runner->iface, xfer, tx, buf, length, runner->timeout_ms);
+    mtb_ml_model_profile_get_tsc(&end);
+    runner->stats->stall_cycles += end - start;
+    return result;
+}
+
+/* Waits for a transfer, the time spent is the CPU stalling on the link */
+static cy_rslt_t runner_wait(stream_runner_t *runner, mtb_ml_stream_xfer_t *xfer)
+{
+    uint64_t start = 0, end = 0;
+    cy_rslt_t result;
+
+    mtb_ml_model_profile_get_tsc(&start);
+    result = mtb_ml_stream_xfer_wait(runner->iface, xfer, runner->timeout_ms);
+    mtb_ml_model_profile_get_tsc(&end);
+    runner->stats->stall_cycles += end - start;
+    if(result == MTB_ML_RESULT_SUCCESS)
+    {
+        if(xfer->tx)
+        {
+            runner->stats->tx_busy_cycles += xfer->busy_cycles;
+        }
+        else
+        {
+            runner->stats->rx_busy_cycles += xfer->busy_cycles;
+        }
+    }
+    return result;
+}
+
+/* Posts the receive of frames into buf and sends the request for them. An async receive
+ * is posted ahead of the request, so no byte arrives before the transport is ready for it. */
+static cy_rslt_t runner_post(stream_runner_t *runner, uint8_t *buf, uint32_t frames, void *req, size_t req_size)
+{
+    bool rx_async = (runner->iface->interface_obj->receive_async != NULL);
+    uint8_t *rx_p = buf;
+    size_t rx_size = RUNNER_PREFIX_SIZE + frames * runner->frame_bytes;
+    cy_rslt_t result;
+
+    if(!runner_is_v2(runner))
+    {
+        rx_p = buf + RUNNER_PREFIX_SIZE;
+        rx_size = runner->frame_bytes;
+    }
+    else if(runner->split)
+    {
+        /* The payload length of a coded batch is only known from its header */
+        rx_size = sizeof(mtb_ml_stream_v2_hdr_t);
+    }
+    runner->rx_pending_buf = buf;
+    runner->rx_pending_frames = frames;
+    runner->rx_hdr_pending = runner->split;
+
+    /* TX is idle before anything is started on it */
+    result = runner_wait(runner, &runner->tx);
+    if((result == MTB_ML_RESULT_SUCCESS) && rx_async)
+    {
+        result = runner_start(runner, &runner->rx, false, rx_p, rx_size);
+    }
+    if(result == MTB_ML_RESULT_SUCCESS)
+    {
+        result = runner_start(runner, &runner->tx, true, req, req_size);
+    }
+    if((result == MTB_ML_RESULT_SUCCESS) && !rx_async)
+    {
+        result = runner_start(runner, &runner->rx, false, rx_p, rx_size);
+    }
+    return result;
+}
+
+/* Requests frames from the host into buf */
+static cy_rslt_t runner_request(stream_runner_t *runner, uint8_t *buf, uint32_t frames)
+{
+    if(!runner_is_v2(runner))
+    {
+        return runner_post(runner, buf, frames, ML_CT_FRAME_REQ_STRING, sizeof(ML_CT_FRAME_REQ_STRING));
+    }
+
+    runner->req.magic = MTB_ML_STREAM_V2_MAGIC;
+    runner->req.type = MTB_ML_STREAM_V2_FRAME_REQ;
+    runner->req.count = (uint16_t)frames;
+    runner->req.seq = runner->iface->seq++;
+    runner->req.length = runner->split ? MTB_ML_STREAM_CODEC_MARGIN : 0;
+    runner->req.crc = 0;
+    runner->batch_req = runner->req;
+    return runner_post(runner, buf, frames, &runner->req, sizeof(runner->req));
+}
+
+static bool runner_hdr_valid(stream_runner_t *runner, const mtb_ml_stream_v2_hdr_t *hdr)
+{
+    if(!mtb_ml_stream_frames_hdr_valid(runner->iface, hdr, &runner->batch_req))
+    {
+        return false;
+    }
+    /* The frames left in the dataset are known, the host sends them all */
+    if(hdr->count != runner->rx_pending_frames)
+    {
+        printf("ERROR: batch %" PRIu32 " holds %d frames instead of %d\r\n",
+               hdr->seq, (int)hdr->count, (int)runner->rx_pending_frames);
+        return false;
+    }
+    return true;
+}
+
+/* Resends the full results of batch seq, still held by one of the tx buffers. The next header
+ * is received into buf, posted ahead of the results as for a frame request. */
+static cy_rslt_t runner_resend(stream_runner_t *runner, uint32_t seq, uint8_t *buf)
+{
+    bool rx_async = (runner->iface->interface_obj->receive_async != NULL);
+    mtb_ml_stream_v2_hdr_t *res = NULL;
+    cy_rslt_t result;
+
+    for(int i = 0; i < 2; i++)
+    {
+        mtb_ml_stream_v2_hdr_t *hdr = (mtb_ml_stream_v2_hdr_t *)runner->tx_buf[i];
+        if((hdr->magic == MTB_ML_STREAM_V2_MAGIC) && (hdr->seq == seq))
+        {
+            res = hdr;
+        }
+    }
+    if(res == NULL)
+    {
+        printf("ERROR: host asks for results %" PRIu32 " not kept\r\n", seq);
+        return MTB_ML_RESULT_COMM_ERROR;
+    }
+
+    runner->rx_hdr_pending = true;
+    result = runner_wait(runner, &runner->tx);
+    if((result == MTB_ML_RESULT_SUCCESS) && rx_async)
+    {
+        result = runner_start(runner, &runner->rx, false, buf, sizeof(mtb_ml_stream_v2_hdr_t));
+    }
+    if(result == MTB_ML_RESULT_SUCCESS)
+    {
+        res->crc = mtb_ml_stream_crc32(0, res + 1, res->length);
+        runner->tx_resend = true;
+        result = runner_start(runner, &runner->tx, true, res, RUNNER_PREFIX_SIZE + res->length);
+    }
+    if((result == MTB_ML_RESULT_SUCCESS) && !rx_async)
+    {
+        result = runner_start(runner, &runner->rx, false, buf, sizeof(mtb_ml_stream_v2_hdr_t));
+    }
+    return result;
+}
+
+/* Header of a split batch arrived, a coded payload is received into the tail of the frames */
+static cy_rslt_t runner_rx_payload(stream_runner_t *runner)
+{
+    mtb_ml_stream_v2_hdr_t *hdr = (mtb_ml_stream_v2_hdr_t *)runner->rx_pending_buf;
+    cy_rslt_t result;
+
+    runner->rx_hdr_pending = false;
+    result = runner_wait(runner, &runner->rx);
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        return result;
+    }
+    /* The host asks for the full results of a mismatching batch ahead of the frames */
+    if((hdr->magic == MTB_ML_STREAM_V2_MAGIC) && (hdr->type == MTB_ML_STREAM_V2_RESULT_REQ))
+    {
+        return runner_resend(runner, hdr->seq, runner->rx_pending_buf);
+    }
+    if(!runner_hdr_valid(runner, hdr))
+    {
+        return MTB_ML_RESULT_COMM_ERROR;
+    }
+    return runner_start(runner, &runner->rx, false,
+                        mtb_ml_stream_frames_payload(runner->iface, hdr, &runner->batch_req,
+                                                     runner->rx_pending_buf + RUNNER_PREFIX_SIZE),
+                        hdr->length);
+}
+
+/* Moves a coded batch on to its payload once the header is there, without waiting */
+static cy_rslt_t runner_poll(stream_runner_t *runner)
+{
+    if(runner->rx_hdr_pending && ((volatile mtb_ml_stream_tag_t *)&runner->rx.tag)->stream_done)
+    {
+        return runner_rx_payload(runner);
+    }
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+/* Waits for the frames requested into buf, a v2 batch failing its CRC is requested again */
+static cy_rslt_t runner_receive(stream_runner_t *runner, uint8_t *buf, uint32_t frames)
+{
+    mtb_ml_stream_v2_hdr_t *hdr = (mtb_ml_stream_v2_hdr_t *)buf;
+    uint8_t *payload;
+    cy_rslt_t result;
+
+    for(uint32_t attempt = 0; ; attempt++)
+    {
+        while(runner->rx_hdr_pending)
+        {
+            result = runner_rx_payload(runner);
+            if(result != MTB_ML_RESULT_SUCCESS)
+            {
+                return result;
+            }
+        }
+        result = runner_wait(runner, &runner->rx);
+        if((result != MTB_ML_RESULT_SUCCESS) || !runner_is_v2(runner))
+        {
+            return result;
+        }
+        if(!runner->split && !runner_hdr_valid(runner, hdr))
+        {
+            return MTB_ML_RESULT_COMM_ERROR;
+        }
+
+        payload = mtb_ml_stream_frames_payload(runner->iface, hdr, &runner->batch_req, buf + RUNNER_PREFIX_SIZE);
+        if(mtb_ml_stream_crc32(0, payload, hdr->length) == hdr->crc)
+        {
+            return mtb_ml_stream_frames_decode(runner->iface, hdr, buf + RUNNER_PREFIX_SIZE, payload) ?
+                   MTB_ML_RESULT_SUCCESS : MTB_ML_RESULT_COMM_ERROR;
+        }
+        if(attempt == MTB_ML_STREAM_V2_RETRIES)
+        {
+            printf("ERROR: batch %" PRIu32 " CRC mismatch\r\n", runner->batch_req.seq);
+            return MTB_ML_RESULT_COMM_ERROR;
+        }
+
+        /* Ask the host to resend the batch */
+        runner->req.type = MTB_ML_STREAM_V2_NACK;
+        runner->req.count = 0;
+        result = runner_post(runner, buf, frames, &runner->req, sizeof(runner->req));
+        if(result != MTB_ML_RESULT_SUCCESS)
+        {
+            return result;
+        }
+    }
+}
+
+/* Runs the frames of rx_buf and starts sending their results from tx_buf */
+static cy_rslt_t runner_infer(stream_runner_t *runner, const uint8_t *rx_buf, uint8_t *tx_buf, uint32_t frames)
+{
+    uint8_t *payload = tx_buf + RUNNER_PREFIX_SIZE;
+    uint64_t start = 0, end = 0;
+    size_t length = frames * runner->result_bytes;
+    cy_rslt_t result;
+
+    /* Full results resent from this buffer are on their way */
+    if(runner->tx_resend)
+    {
+        runner->tx_resend = false;
+        result = runner_wait(runner, &runner->tx);
+        if(result != MTB_ML_RESULT_SUCCESS)
+        {
+            return result;
+        }
+    }
+
+    for(uint32_t i = 0; i < frames; i++)
+    {
+        mtb_ml_model_profile_get_tsc(&start);
+        result = mtb_ml_model_run(runner->model, (MTB_ML_DATA_T *)(rx_buf + RUNNER_PREFIX_SIZE + i * runner->frame_bytes));
+        mtb_ml_model_profile_get_tsc(&end);
+        if(result != MTB_ML_RESULT_SUCCESS)
+        {
+            return result;
+        }
+        runner->stats->infer_cycles += end - start;
+        memcpy(payload + i * runner->result_bytes, runner->model->output, runner->result_bytes);
+
+        result = runner_poll(runner);
+        if(result != MTB_ML_RESULT_SUCCESS)
+        {
+            return result;
+        }
+    }
+    runner->stats->frames += frames;
+
+    /* The frame request sent before inference leaves TX idle soon */
+    result = runner_wait(runner, &runner->tx);
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        return result;
+    }
+
+    if(runner_is_v2(runner))
+    {
+        mtb_ml_stream_v2_hdr_t *hdr = (mtb_ml_stream_v2_hdr_t *)tx_buf;
+
+        hdr->magic = MTB_ML_STREAM_V2_MAGIC;
+        hdr->type = MTB_ML_STREAM_V2_RESULTS;
+        hdr->count = (uint16_t)frames;
+        hdr->seq = runner->iface->seq++;
+        hdr->length = length;
+        if(runner->iface->output_mode == MTB_ML_STREAM_OUTPUT_FULL)
+        {
+            hdr->crc = mtb_ml_stream_crc32(0, payload, length);
+            return runner_start(runner, &runner->tx, true, tx_buf, RUNNER_PREFIX_SIZE + length);
+        }
+
+        /* The full results stay behind for a resend, their CRC is left to it */
+        mtb_ml_stream_v2_hdr_t *red = (mtb_ml_stream_v2_hdr_t *)(void *)(payload + RUNNER_ALIGN(runner->unit_frames * runner->result_bytes));
+        uint8_t *red_payload = (uint8_t *)(red + 1);
+
+        for(uint32_t i = 0; i < frames; i++)
+        {
+            mtb_ml_stream_reduce(runner->iface->output_mode, runner->iface->top_k, payload + i * runner->result_bytes,
+                                 (uint32_t)runner->iface->output_size, runner->iface->output_data_type,
+                                 red_payload + i * runner->reduced_bytes);
+        }
+        *red = *hdr;
+        red->type = MTB_ML_STREAM_V2_RESULTS_REDUCED;
+        red->length = frames * runner->reduced_bytes;
+        red->crc = mtb_ml_stream_crc32(0, red_payload, red->length);
+        return runner_start(runner, &runner->tx, true, red, RUNNER_PREFIX_SIZE + red->length);
+    }
+
+    /* Result string right in front of the result */
+    memcpy(payload - sizeof(ML_CT_RESULT_STRING), ML_CT_RESULT_STRING, sizeof(ML_CT_RESULT_STRING));
+    return runner_start(runner, &runner->tx, true, payload - sizeof(ML_CT_RESULT_STRING),
+                        sizeof(ML_CT_RESULT_STRING) + length);
+}
+
+/*******************************************************************************
+ * Public Functions
+*******************************************************************************/
+cy_rslt_t mtb_ml_stream_run(mtb_ml_stream_interface_t *iface,
+                            mtb_ml_model_t *model_object,
+                            uint32_t timeout_ms,
+                            mtb_ml_stream_runner_stats_t *stats)
+{
+    stream_runner_t runner;
+    mtb_ml_stream_runner_stats_t local_stats;
+    uint32_t num_frames;
+    uint32_t frames;
+    uint32_t next_frames;
+    uint64_t start = 0, end = 0;
+    size_t rx_size, tx_size;
+    cy_rslt_t result = MTB_ML_RESULT_SUCCESS;
+
+    if(!iface || !model_object || !iface->interface_obj)
+    {
+        printf("ERROR: mtb_ml_stream_run invalid parameters\r\n");
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    /* Streaming RNN time step slices are left to the application */
+    if(iface->x_data_info.recurrent_ts_size > 1)
+    {
+        printf("ERROR: mtb_ml_stream_run does not support streaming RNN models\r\n");
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    memset(&runner, 0, sizeof(runner));
+    runner.iface = iface;
+    runner.model = model_object;
+    runner.stats = (stats != NULL) ? stats : &local_stats;
+    runner.timeout_ms = timeout_ms;
+    runner.unit_frames = runner_is_v2(&runner) ? iface->batch_frames : 1;
+    runner.split = runner_is_v2(&runner) && ((iface->codec != 0) || (iface->output_mode != MTB_ML_STREAM_OUTPUT_FULL));
+    runner.frame_bytes = mtb_ml_stream_frame_bytes(iface);
+    runner.result_bytes = iface->output_size * iface->output_type_bytes;
+    runner.reduced_bytes = 0;
+    if(runner_is_v2(&runner) && (iface->output_mode != MTB_ML_STREAM_OUTPUT_FULL))
+    {
+        runner.reduced_bytes = mtb_ml_stream_reduced_bytes(iface->output_mode, iface->top_k, iface->output_size,
+                                                           iface->output_data_type);
+    }
+    memset(runner.stats, 0, sizeof(*runner.stats));
+
+    /* Coded batches are decoded in place and use some slack past the frames */
+    rx_size = RUNNER_PREFIX_SIZE + runner.unit_frames * runner.frame_bytes + (runner.split ? MTB_ML_STREAM_CODEC_MARGIN : 0);
+    tx_size = RUNNER_PREFIX_SIZE + runner.unit_frames * runner.result_bytes;
+    if(runner.reduced_bytes != 0)
+    {
+        tx_size = RUNNER_PREFIX_SIZE + RUNNER_ALIGN(runner.unit_frames * runner.result_bytes) +
+                  RUNNER_PREFIX_SIZE + runner.unit_frames * runner.reduced_bytes;
+    }
+    for(int i = 0; i < 2; i++)
+    {
+        runner.rx_buf[i] = (uint8_t *)malloc(rx_size);
+        runner.tx_buf[i] = (uint8_t *)malloc(tx_size);
+        if((runner.rx_buf[i] == NULL) || (runner.tx_buf[i] == NULL))
+        {
+            printf("ERROR: mtb_ml_stream_run out of memory\r\n");
+            result = MTB_ML_RESULT_ALLOC_ERR;
+            goto ret;
+        }
+        /* No results kept for a resend yet */
+        memset(runner.tx_buf[i], 0, RUNNER_PREFIX_SIZE);
+    }
+
+    mtb_ml_model_profile_get_tsc(&start);
+    num_frames = (uint32_t)iface->x_data_info.num_of_samples;
+    frames = (num_frames < runner.unit_frames) ? num_frames : runner.unit_frames;
+    if(frames > 0)
+    {
+        result = runner_request(&runner, runner.rx_buf[0], frames);
+    }
+
+    /* Frames of unit u arrive in rx_buf[u % 2] while unit u - 1 is inferred,
+     * results of unit u - 1 leave from tx_buf[(u - 1) % 2] while unit u arrives.
+     * Protocol v1 has no sequence numbers, there each frame waits for the previous result. */
+    for(uint32_t first = 0, u = 0; (result == MTB_ML_RESULT_SUCCESS) && (first < num_frames); first += frames, u++)
+    {
+        uint8_t *rx_buf = runner.rx_buf[u % 2];
+
+        frames = (num_frames - first < runner.unit_frames) ? (num_frames - first) : runner.unit_frames;
+        result = runner_receive(&runner, rx_buf, frames);
+        if(result != MTB_ML_RESULT_SUCCESS)
+        {
+            break;
+        }
+
+        next_frames = num_frames - first - frames;
+        if(next_frames > runner.unit_frames)
+        {
+            next_frames = runner.unit_frames;
+        }
+        if((next_frames > 0) && runner_is_v2(&runner))
+        {
+            result = runner_request(&runner, runner.rx_buf[(u + 1) % 2], next_frames);
+            if(result != MTB_ML_RESULT_SUCCESS)
+            {
+                break;
+            }
+        }
+
+        result = runner_infer(&runner, rx_buf, runner.tx_buf[u % 2], frames);
+
+        /* Protocol v1 stays strictly sequential, the next frame is requested after the result */
+        if((result == MTB_ML_RESULT_SUCCESS) && (next_frames > 0) && !runner_is_v2(&runner))
+        {
+            result = runner_request(&runner, runner.rx_buf[(u + 1) % 2], next_frames);
+        }
+    }
+
+    /* An empty request leaves the host a chance to ask for the last full results */
+    if((result == MTB_ML_RESULT_SUCCESS) && (runner.reduced_bytes != 0) && (num_frames > 0))
+    {
+        result = runner_request(&runner, runner.rx_buf[0], 0);
+        if(result == MTB_ML_RESULT_SUCCESS)
+        {
+            result = runner_receive(&runner, runner.rx_buf[0], 0);
+        }
+    }
+    if(result == MTB_ML_RESULT_SUCCESS)
+    {
+        result = runner_wait(&runner, &runner.tx);
+    }
+    mtb_ml_model_profile_get_tsc(&end);
+    runner.stats->wall_cycles = end - start;
+
+ret:
+    /* After an error a transfer may still use the buffers, they are leaked if it does not end */
+    if((mtb_ml_stream_xfer_wait(iface, &runner.rx, timeout_ms) == MTB_ML_RESULT_TIMEOUT) ||
+       (mtb_ml_stream_xfer_wait(iface, &runner.tx, timeout_ms) == MTB_ML_RESULT_TIMEOUT))
+    {
+        return result;
+    }
+    for(int i = 0; i < 2; i++)
+    {
+        free(runner.rx_buf[i]);
+        free(runner.tx_buf[i]);
+    }
+    return result;
+}
+
+cy_rslt_t mtb_ml_stream_runner_log(const mtb_ml_stream_runner_stats_t *stats)
+{
+    float wall;
+
+    if(!stats)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    wall = (stats->wall_cycles != 0) ? (float)stats->wall_cycles : 1.0f;
+    printf("PROFILE_INFO, MTB ML stream runner, frames=%-10" PRIu32 ", wall_cycles=%-10" PRIu64 ", infer=%-6.2f%%, rx_link=%-6.2f%%, tx_link=%-6.2f%%, stall=%-6.2f%%\r\n",
+            stats->frames,
+            stats->wall_cycles,
+            100.0f * (float)stats->infer_cycles / wall,
+            100.0f * (float)stats->rx_busy_cycles / wall,
+            100.0f * (float)stats->tx_busy_cycles / wall,
+            100.0f * (float)stats->stall_cycles / wall);
+    return MTB_ML_RESULT_SUCCESS;
+}
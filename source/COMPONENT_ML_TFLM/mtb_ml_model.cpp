@@ -38,23 +38,32 @@
 * indemnity Cypress against all liability.
 *******************************************************************************/
 #include <stdlib.h>
+#include <string.h>
 #include <inttypes.h>
 #include "mtb_ml.h"
+#include "mtb_ml_model_impl.h"
 
 #include <climits>
+#include <new>
+
+#if defined(COMPONENT_ML_HOST)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 #include "tensorflow/lite/micro/tflite_bridge/micro_error_reporter.h"
 #include "tensorflow/lite/micro/micro_op_resolver.h"
 #include "tensorflow/lite/micro/recording_micro_interpreter.h"
 #include "tensorflow/lite/micro/all_ops_resolver.h"
+#include "tensorflow/lite/micro/memory_helpers.h"
 #include "tensorflow/lite/micro/micro_utils.h"
+#include "tensorflow/lite/micro/micro_profiler_interface.h"
+#include "tensorflow/lite/schema/schema_generated.h"
 
 extern "C" {
 
-#if defined(COMPONENT_U55)
-extern ethosu_driver *mtb_ml_ethosu_driver_handle;
-#endif
-
 /* LCOV_EXCL_START (Excluded from the code coverage, until the STOP marker) */
 int __attribute__((weak)) mtb_ml_model_profile_get_tsc(uint64_t *val)
 {
@@ -68,6 +77,26 @@ namespace tflite {
 
 static tflite::AllOpsResolver resolver;
 
+#if defined(COMPONENT_NNLITE2)
+/* Tags NNLite kernel timing records with the TFLM operator being evaluated */
+class MTBNNLiteOpTagger : public MicroProfilerInterface {
+ public:
+  void Bind(mtb_ml_npu_prof_ctx_t* ctx) { ctx_ = ctx; }
+
+  uint32_t BeginEvent(const char* tag) override {
+    if (ctx_ != nullptr) {
+      ctx_->op_tag = tag;
+      ctx_->op_index = ctx_->op_seq++;
+    }
+    return 0;
+  }
+  void EndEvent(uint32_t event_handle) override { (void)event_handle; }
+
+ private:
+  mtb_ml_npu_prof_ctx_t* ctx_ = nullptr;
+};
+#endif
+
 template <typename inputT>
 class MTBTFLiteMicro {
  public:
@@ -78,9 +107,21 @@ class MTBTFLiteMicro {
                        const tflite::MicroOpResolver& op_resolver,
                        MicroResourceVariables* resource_variables)
       : interpreter_(GetModel(model), op_resolver, tensor_arena,
-                     tensor_arena_size, resource_variables, nullptr) {
+                     tensor_arena_size, resource_variables,
+#if defined(COMPONENT_NNLITE2)
+                     &op_tagger_
+#else
+                     nullptr
+#endif
+                     ) {
+      uint64_t start = 0, end = 0;
+      mtb_ml_model_profile_get_tsc(&start);
       allocate_status_ = interpreter_.AllocateTensors();
+      mtb_ml_model_profile_get_tsc(&end);
+      alloc_cycles_ = end - start;
       model_ = GetModel(model);
+      arena_ = tensor_arena;
+      arena_size_ = tensor_arena_size;
   }
 
   TfLiteStatus RunSingleIteration() {
@@ -92,6 +133,10 @@ class MTBTFLiteMicro {
   TfLiteTensor* Output(int index = 0) { return interpreter_.output(index); }
 
   TfLiteStatus AllocationStatus() { return allocate_status_; }
+  uint64_t AllocationCycles() { return alloc_cycles_; }
+
+  /* Passed by the Ethos-U operator to the driver callbacks as user_arg */
+  TfLiteStatus SetExternalContext(void* context) { return interpreter_.SetMicroExternalContext(context); }
 
   /* Use for RNN state control. This will free subgraphs to the reset state */
   TfLiteStatus reset_all_variables() { return interpreter_.Reset(); }
@@ -127,10 +172,98 @@ class MTBTFLiteMicro {
     interpreter_.GetMicroAllocator().PrintAllocations();
   }
 
+  int arena_size() const { return arena_size_; }
+
+  /* Arena split of the recording allocator, tensor offsets from the data pointers and
+   * lifetimes from the operators of the main subgraph */
+  void MemoryReport(mtb_ml_memory_report_t* report, mtb_ml_tensor_memory_t* tensors, uint32_t max_tensors) {
+    const RecordingMicroAllocator& allocator = interpreter_.GetMicroAllocator();
+    const SubGraph* subgraph = model_->subgraphs()->Get(0);
+    const auto* operators = subgraph->operators();
+    uint32_t count = subgraph->tensors()->size();
+
+    report->arena_size = arena_size_;
+    report->arena_used = interpreter_.arena_used_bytes();
+    report->persistent_bytes = allocator.GetSimpleMemoryAllocator()->GetPersistentUsedBytes();
+    report->scratch_bytes = allocator.GetSimpleMemoryAllocator()->GetNonPersistentUsedBytes();
+    report->tensor_data_bytes =
+        allocator.GetRecordedAllocation(RecordedAllocationType::kTfLiteEvalTensorData).used_bytes +
+        allocator.GetRecordedAllocation(RecordedAllocationType::kPersistentTfLiteTensorData).used_bytes +
+        allocator.GetRecordedAllocation(RecordedAllocationType::kPersistentTfLiteTensorQuantizationData).used_bytes +
+        allocator.GetRecordedAllocation(RecordedAllocationType::kTfLiteTensorVariableBufferData).used_bytes;
+    report->node_metadata_bytes =
+        allocator.GetRecordedAllocation(RecordedAllocationType::kNodeAndRegistrationArray).used_bytes;
+    report->op_data_bytes =
+        allocator.GetRecordedAllocation(RecordedAllocationType::kOpData).used_bytes +
+        allocator.GetRecordedAllocation(RecordedAllocationType::kPersistentBufferData).used_bytes;
+    report->operator_count = (operators != nullptr) ? operators->size() : 0;
+    report->tensor_count = count;
+
+    if (tensors == nullptr) {
+      return;
+    }
+    if (max_tensors > count) {
+      max_tensors = count;
+    }
+    for (uint32_t i = 0; i < max_tensors; i++) {
+      TfLiteEvalTensor* tensor = interpreter_.GetTensor(i);
+      const uint8_t* data = (tensor != nullptr) ? static_cast<const uint8_t*>(tensor->data.data) : nullptr;
+      size_t bytes = 0;
+
+      if (tensor != nullptr) {
+        TfLiteEvalTensorByteLength(tensor, &bytes);
+      }
+      tensors[i].index = i;
+      tensors[i].offset = (data != nullptr && data >= arena_ && data < arena_ + arena_size_) ? (int32_t)(data - arena_) : -1;
+      tensors[i].bytes = bytes;
+      tensors[i].first_use = -1;
+      tensors[i].last_use = -1;
+    }
+    for (uint32_t op = 0; op < report->operator_count; op++) {
+      const Operator* node = operators->Get(op);
+      const flatbuffers::Vector<int32_t>* lists[2] = { node->inputs(), node->outputs() };
+      for (const auto* list : lists) {
+        for (uint32_t j = 0; list != nullptr && j < list->size(); j++) {
+          int32_t index = list->Get(j);
+          if (index >= 0 && (uint32_t)index < max_tensors) {
+            if (tensors[index].first_use < 0) {
+              tensors[index].first_use = op;
+            }
+            tensors[index].last_use = op;
+          }
+        }
+      }
+    }
+    /* The inputs are written before and the outputs read after the invocation */
+    for (uint32_t j = 0; j < subgraph->inputs()->size(); j++) {
+      int32_t index = subgraph->inputs()->Get(j);
+      if (index >= 0 && (uint32_t)index < max_tensors) {
+        tensors[index].first_use = 0;
+      }
+    }
+    for (uint32_t j = 0; j < subgraph->outputs()->size() && report->operator_count != 0; j++) {
+      int32_t index = subgraph->outputs()->Get(j);
+      if (index >= 0 && (uint32_t)index < max_tensors) {
+        tensors[index].last_use = report->operator_count - 1;
+      }
+    }
+  }
+
+#if defined(COMPONENT_NNLITE2)
+  void BindProfiling(mtb_ml_npu_prof_ctx_t* ctx) { op_tagger_.Bind(ctx); }
+#endif
+
  private:
+#if defined(COMPONENT_NNLITE2)
+  /* Declared ahead of the interpreter, which keeps a pointer to it */
+  MTBNNLiteOpTagger op_tagger_;
+#endif
   tflite::RecordingMicroInterpreter interpreter_;
   TfLiteStatus allocate_status_;
+  uint64_t alloc_cycles_;
   const Model* model_;
+  const uint8_t* arena_;
+  int arena_size_;
 
 };
 
@@ -167,6 +300,48 @@ static uint8_t var_arena[160 + 20 * TFLM_RESVAR_COUNT] __attribute__ ((aligned (
 #endif
 #endif
 
+/* Model binary data of mtb_ml_model_bin_from_mmap(), the public part first, bin.owner points to it */
+typedef struct
+{
+    mtb_ml_model_bin_t bin;
+    void *map;          /* File mapping owned by the model binary data, NULL if none */
+    size_t map_size;
+} mtb_ml_model_bin_mapped_t;
+
+/* Verifies the flatbuffer tables, the buffers holding the weights are only bounds checked */
+static bool mtb_ml_model_bin_verify(const void *data, size_t size)
+{
+    flatbuffers::Verifier verifier(static_cast<const uint8_t *>(data), size);
+
+    if (!tflite::VerifyModelBuffer(verifier))
+    {
+        return false;
+    }
+    return tflite::GetModel(data)->version() == TFLITE_SCHEMA_VERSION;
+}
+
+static cy_rslt_t mtb_ml_model_bin_wrap(const char *name, const void *data, size_t size, int arena_size,
+                                       void *map, size_t map_size, mtb_ml_model_bin_t **bin)
+{
+    mtb_ml_model_bin_mapped_t *mapped;
+
+    if (!mtb_ml_model_bin_verify(data, size))
+    {
+        return MTB_ML_RESULT_BAD_MODEL;
+    }
+
+    mapped = new (std::nothrow) mtb_ml_model_bin_mapped_t{
+        { {0}, static_cast<const uint8_t *>(data), (unsigned int)size, arena_size, nullptr }, map, map_size };
+    if (mapped == nullptr)
+    {
+        return MTB_ML_RESULT_ALLOC_ERR;
+    }
+    mapped->bin.owner = mapped;
+    strncpy(mapped->bin.name, name, MTB_ML_MODEL_NAME_LEN - 1);
+    *bin = &mapped->bin;
+    return MTB_ML_RESULT_SUCCESS;
+}
+
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
@@ -174,13 +349,91 @@ extern "C" {
 /*******************************************************************************
  * Public Functions
 *******************************************************************************/
+cy_rslt_t mtb_ml_model_bin_from_mmap(const char *name, const void *data, size_t size, int arena_size,
+                                     mtb_ml_model_bin_t **bin)
+{
+    /* Sanity check of input parameters */
+    if (name == NULL || data == NULL || size == 0 || arena_size <= 0 || bin == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    return mtb_ml_model_bin_wrap(name, data, size, arena_size, NULL, 0, bin);
+}
+
+#if defined(COMPONENT_ML_HOST)
+cy_rslt_t mtb_ml_model_bin_from_file(const char *path, int arena_size, mtb_ml_model_bin_t **bin)
+{
+    struct stat st;
+    const char *name;
+    void *map;
+    int fd;
+    cy_rslt_t ret;
+
+    /* Sanity check of input parameters */
+    if (path == NULL || arena_size <= 0 || bin == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        close(fd);
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    /* The weights are paged in by the first inference, the start-up does not depend on the model size */
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    name = strrchr(path, '/');
+    name = (name != NULL) ? name + 1 : path;
+    ret = mtb_ml_model_bin_wrap(name, map, (size_t)st.st_size, arena_size, map, (size_t)st.st_size, bin);
+    if (ret != MTB_ML_RESULT_SUCCESS)
+    {
+        munmap(map, (size_t)st.st_size);
+    }
+    return ret;
+}
+#endif
+
+cy_rslt_t mtb_ml_model_bin_free(mtb_ml_model_bin_t *bin)
+{
+    /* Sanity check of input parameters */
+    if (bin == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    /* Static model binary data has no owner, it was not allocated here */
+    if (bin->owner == NULL || bin->owner != static_cast<void *>(bin))
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    mtb_ml_model_bin_mapped_t *mapped = static_cast<mtb_ml_model_bin_mapped_t *>(bin->owner);
+#if defined(COMPONENT_ML_HOST)
+    if (mapped->map != NULL)
+    {
+        munmap(mapped->map, mapped->map_size);
+    }
+#endif
+    delete mapped;
+    return MTB_ML_RESULT_SUCCESS;
+}
+
 
 cy_rslt_t mtb_ml_model_init(const mtb_ml_model_bin_t *bin, const mtb_ml_model_buffer_t *buffer, mtb_ml_model_t **object)
 {
     mtb_ml_model_t *model_object = NULL;
     uint8_t * arena_buffer = NULL;
     int arena_size;
-    tflite::MTB_TFLM_Class * TFLMClass;
+    tflite::MTB_TFLM_Class * TFLMClass = nullptr;
     int ret = MTB_ML_RESULT_SUCCESS;
 
 #if ((TFLM_RESVAR_COUNT != 0) && (TFLM_RESVAR_COUNT <= 64))
@@ -267,6 +520,21 @@ cy_rslt_t mtb_ml_model_init(const mtb_ml_model_bin_t *bin, const mtb_ml_model_bu
         ret = MTB_ML_RESULT_ALLOC_ERR;
         goto ret_err;
     }
+    model_object->m_alloc_cycles = TFLMClass->AllocationCycles();
+
+#if defined(COMPONENT_U55)
+    /* The Ethos-U operator passes the external context as user_arg to
+     * ethosu_inference_begin/end, which account into this model only */
+    model_object->npu_prof.counters = &model_object->npu_counters;
+    if (TFLMClass->SetExternalContext(&model_object->npu_prof) != kTfLiteOk)
+    {
+        ret = MTB_ML_RESULT_BAD_MODEL;
+        goto ret_err;
+    }
+#endif
+#if defined(COMPONENT_NNLITE2)
+    TFLMClass->BindProfiling(&model_object->npu_prof);
+#endif
 
     /* Input parameters */
     model_object->input = (MTB_ML_DATA_T *)TFLMClass->input_ptr();
@@ -311,9 +579,14 @@ cy_rslt_t mtb_ml_model_init(const mtb_ml_model_bin_t *bin, const mtb_ml_model_bu
         goto ret_err;
     }
 
+    /* Type kernels of the run-time type detection, resolved once */
+    model_object->input_ops = mtb_ml_type_ops_get(model_object->input_type_size);
+    model_object->output_ops = mtb_ml_type_ops_get(model_object->output_type_size);
+
     *object = model_object;
     return ret;
 ret_err:
+    delete TFLMClass;
     free(model_object->arena_buffer);
     free(model_object);
     return ret;
@@ -327,7 +600,11 @@ cy_rslt_t mtb_ml_model_deinit(mtb_ml_model_t *object)
         return MTB_ML_RESULT_BAD_ARG;
     }
     delete reinterpret_cast<tflite::MTB_TFLM_Class *>(object->tflm_obj);
+#if defined(COMPONENT_NNLITE2)
+    (void)mtb_ml_nnlite_prof_kernels_enable(&object->npu_prof, false);
+#endif
     free(object->arena_buffer);
+    mtb_ml_input_gate_free(object);
     free(object);
 
     return MTB_ML_RESULT_SUCCESS;
@@ -342,6 +619,12 @@ cy_rslt_t mtb_ml_model_run(mtb_ml_model_t *object, MTB_ML_DATA_T *input)
         return MTB_ML_RESULT_BAD_ARG;
     }
 
+    /* Nearly unchanged input, the output of the last inference stays valid */
+    if (mtb_ml_input_gate_skip(object, input))
+    {
+        return MTB_ML_RESULT_SUCCESS;
+    }
+
     tflite::MTB_TFLM_Class *Tflm = reinterpret_cast<tflite::MTB_TFLM_Class *>(object->tflm_obj);
 
     /* Set input data */
@@ -351,20 +634,37 @@ cy_rslt_t mtb_ml_model_run(mtb_ml_model_t *object, MTB_ML_DATA_T *input)
     if (object->profiling & MTB_ML_PROFILE_ENABLE_MODEL)
     {
         mtb_ml_model_profile_get_tsc(&object->m_cpu_cycles);
-#if (!defined(COMPONENT_RTOS) && \
-     (defined(COMPONENT_U55) || \
-      defined(COMPONENT_NNLITE2)))
-        mtb_ml_npu_cycles = 0;
+#if defined(COMPONENT_U55) || \
+    defined(COMPONENT_NNLITE2)
+        object->npu_prof.npu_cycles = 0;
+#endif
+#if defined(COMPONENT_U55)
+        memset(&object->npu_counters, 0, sizeof(object->npu_counters));
 #endif
     }
+#if defined(COMPONENT_NNLITE2)
+    /* NNLite driver callbacks account to the context bound by this task */
+    object->npu_prof.op_seq = 0;
+    object->npu_prof.frame = object->m_sum_frames;
+    mtb_ml_nnlite_prof_bind(&object->npu_prof);
+#endif
 #if defined(COMPONENT_U55)
+    /* Powers the NPU up if the idle timeout gated it */
+    if (mtb_ml_npu_power_acquire() != MTB_ML_RESULT_SUCCESS)
+    {
+        return MTB_ML_RESULT_NPU_INIT_ERROR;
+    }
     if(mtb_ml_get_cache_mgmt_type() == MTB_ML_ETHOSU_CACHE_MGMT_OUTER_LAYERS)
     {
         SCB_CleanDCache_by_Addr((uint32_t *)object->input, object->input_size);
     }
 #endif
     ret = Tflm->RunSingleIteration();
+#if defined(COMPONENT_NNLITE2)
+    mtb_ml_nnlite_prof_bind(NULL);
+#endif
 #if defined(COMPONENT_U55)
+    mtb_ml_npu_power_release();
     if(mtb_ml_get_cache_mgmt_type() == MTB_ML_ETHOSU_CACHE_MGMT_OUTER_LAYERS)
     {
         SCB_InvalidateDCache_by_Addr((uint32_t *)object->output, object->output_size);
@@ -375,24 +675,26 @@ cy_rslt_t mtb_ml_model_run(mtb_ml_model_t *object, MTB_ML_DATA_T *input)
         object->lib_error = ret;
         return MTB_ML_RESULT_INFERENCE_ERROR;
     }
+    mtb_ml_input_gate_update(object, input);
 
     if (object->profiling & MTB_ML_PROFILE_ENABLE_MODEL)
     {
         uint64_t cycles = 0U;
         mtb_ml_model_profile_get_tsc(&cycles);
         uint64_t cpu_cycles_only = cycles - object->m_cpu_cycles;
-#if (!defined(COMPONENT_RTOS) && \
-     (defined(COMPONENT_U55) || \
-      defined(COMPONENT_NNLITE2)))
+#if defined(COMPONENT_U55) || \
+    defined(COMPONENT_NNLITE2)
+        uint64_t npu_cycles = object->npu_prof.npu_cycles;
         /* mtb_ml_init() : mtb_ml_norm_clk_freq = npu_freq/cpu_freq */
-        uint64_t norm_npu_cycles = (uint64_t)(((float)mtb_ml_npu_cycles) / mtb_ml_norm_clk_freq);
+        uint64_t norm_npu_cycles = (uint64_t)(((float)npu_cycles) / mtb_ml_norm_clk_freq);
         /* Check for bad cpu/npu count values so we don't overflow */
         if (norm_npu_cycles > cpu_cycles_only)
         {
             return MTB_ML_RESULT_CYCLE_COUNT_ERROR;
         }
 
-        object->m_npu_cycles = mtb_ml_npu_cycles;
+        object->m_npu_cycles = npu_cycles;
+        mtb_ml_npu_cycles = npu_cycles;
         if (object->m_npu_cycles > object->m_npu_peak_cycles)
         {
             object->m_npu_peak_cycles = object->m_npu_cycles;
@@ -401,6 +703,16 @@ cy_rslt_t mtb_ml_model_run(mtb_ml_model_t *object, MTB_ML_DATA_T *input)
         object->m_npu_sum_cycles += object->m_npu_cycles;
         /* Subtracting NPU fraction */
         cpu_cycles_only -= norm_npu_cycles;
+#endif
+#if defined(COMPONENT_NNLITE2)
+        mtb_ml_nnlite_wait_account(npu_cycles);
+#endif
+#if defined(COMPONENT_U55)
+        object->m_npu_sum_pmu.cycles += object->npu_counters.total.cycles;
+        for (int i = 0; i < MTB_ML_NPU_PMU_EVENT_COUNT; i++)
+        {
+            object->m_npu_sum_pmu.events[i] += object->npu_counters.total.events[i];
+        }
 #endif
         if (cpu_cycles_only > object->m_cpu_peak_cycles)
         {
@@ -524,11 +836,6 @@ cy_rslt_t mtb_ml_model_profile_config(mtb_ml_model_t *object, mtb_ml_profile_con
         return MTB_ML_RESULT_BAD_ARG;
     }
 
-#if defined(COMPONENT_U55)
-    /* Enable PMU block */
-    ETHOSU_PMU_Enable(mtb_ml_ethosu_driver_handle);
-#endif
-
     object->profiling = config;
     if (object->profiling != MTB_ML_PROFILE_DISABLE)
     {
@@ -543,6 +850,45 @@ cy_rslt_t mtb_ml_model_profile_config(mtb_ml_model_t *object, mtb_ml_profile_con
         object->m_npu_peak_frame = 0;
         object->m_npu_peak_cycles = 0;
 #endif
+#if defined(COMPONENT_NNLITE2)
+    /* Kernel timing records are kept with layer profiling only */
+    if (mtb_ml_nnlite_prof_kernels_enable(&object->npu_prof,
+            (object->profiling & MTB_ML_PROFILE_ENABLE_LAYER) != 0) != MTB_ML_RESULT_SUCCESS)
+    {
+        return MTB_ML_RESULT_ALLOC_ERR;
+    }
+#endif
+#if defined(COMPONENT_U55)
+        memset(&object->npu_counters, 0, sizeof(object->npu_counters));
+        memset(&object->m_npu_sum_pmu, 0, sizeof(object->m_npu_sum_pmu));
+#endif
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_model_get_memory_report(const mtb_ml_model_t *object, mtb_ml_memory_report_t *report,
+                                         mtb_ml_tensor_memory_t *tensors, uint32_t max_tensors)
+{
+    /* Sanity check of input parameters */
+    if (object == NULL || object->tflm_obj == NULL || report == NULL || (tensors == NULL && max_tensors != 0))
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    tflite::MTB_TFLM_Class *Tflm = reinterpret_cast<tflite::MTB_TFLM_Class *>(object->tflm_obj);
+
+    memset(report, 0, sizeof(*report));
+    Tflm->MemoryReport(report, tensors, max_tensors);
+#if (TFLM_RESVAR_COUNT != 0)
+    report->resource_variable_bytes = sizeof(var_arena);
+#endif
+    report->wrapper_heap_bytes = sizeof(mtb_ml_model_t) + sizeof(tflite::MTB_TFLM_Class);
+    if (object->arena_buffer != NULL)
+    {
+        report->wrapper_heap_bytes += Tflm->arena_size();
+    }
+    if (object->input_gate.reference != NULL)
+    {
+        report->wrapper_heap_bytes += object->input_size * object->input_type_size;
+    }
     return MTB_ML_RESULT_SUCCESS;
 }
 
@@ -568,6 +914,36 @@ cy_rslt_t mtb_ml_model_profile_log(mtb_ml_model_t *object)
                 (float)object->m_npu_peak_cycles,
                 object->m_npu_peak_frame,
                 mtb_ml_npu_clk_freq / 1000000);
+#endif
+#if defined(COMPONENT_NNLITE2)
+        if (object->profiling & MTB_ML_PROFILE_ENABLE_LAYER)
+        {
+            (void)mtb_ml_nnlite_prof_kernels_log(&object->npu_prof);
+        }
+        mtb_ml_nnlite_wait_log();
+#endif
+#if defined(COMPONENT_U55)
+        printf("PROFILE_INFO, MTB ML NPU PMU, avg_pmu_cyc=%-10.2f, custom_ops=%-" PRIu32 ", overflows=%-" PRIu32 "\r\n",
+                (float)object->m_npu_sum_pmu.cycles / object->m_sum_frames,
+                object->npu_counters.op_count,
+                object->npu_counters.overflow_count);
+        for (int i = 0; i < MTB_ML_NPU_PMU_EVENT_COUNT; i++)
+        {
+            printf("PROFILE_INFO, MTB ML NPU PMU, event[%d]=%-" PRIu32 ", avg_count=%-10.2f\r\n",
+                    i,
+                    object->npu_counters.event_type[i],
+                    (float)object->m_npu_sum_pmu.events[i] / object->m_sum_frames);
+        }
+        mtb_ml_npu_pm_stats_t pm_stats;
+        mtb_ml_npu_power_get_stats(&pm_stats);
+        if (pm_stats.wake_count != 0)
+        {
+            printf("PROFILE_INFO, MTB ML NPU power, wakes=%-" PRIu32 ", power_offs=%-" PRIu32 ", avg_wake_cyc=%-10.2f, peak_wake_cyc=%.0f\r\n",
+                    pm_stats.wake_count,
+                    pm_stats.off_count,
+                    (float)pm_stats.sum_wake_cycles / pm_stats.wake_count,
+                    (float)pm_stats.max_wake_cycles);
+        }
 #endif
     }
 
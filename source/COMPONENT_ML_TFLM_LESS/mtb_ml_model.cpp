@@ -43,6 +43,7 @@
 #include <stdlib.h>
 #include <inttypes.h>
 #include "mtb_ml.h"
+#include "mtb_ml_model_impl.h"
 #include <tensorflow/lite/kernels/kernel_util.h>
 
 extern "C" {
@@ -172,6 +173,10 @@ cy_rslt_t mtb_ml_model_init(const mtb_ml_model_bin_t *bin, const mtb_ml_model_bu
         return MTB_ML_RESULT_MISMATCH_DATA_TYPE;
     }
 
+    /* Type kernels of the run-time type detection, resolved once */
+    model_object->input_ops = mtb_ml_type_ops_get(model_object->input_type_size);
+    model_object->output_ops = mtb_ml_type_ops_get(model_object->output_type_size);
+
     *object = model_object;
     return MTB_ML_RESULT_SUCCESS;
 }
@@ -183,6 +188,10 @@ cy_rslt_t mtb_ml_model_deinit(mtb_ml_model_t *object)
     {
         return MTB_ML_RESULT_BAD_ARG;
     }
+#if defined(COMPONENT_NNLITE2)
+    (void)mtb_ml_nnlite_prof_kernels_enable(&object->npu_prof, false);
+#endif
+    mtb_ml_input_gate_free(object);
     free(object);
 
     return MTB_ML_RESULT_SUCCESS;
@@ -197,6 +206,13 @@ cy_rslt_t mtb_ml_model_run(mtb_ml_model_t *object, MTB_ML_DATA_T *input)
         return MTB_ML_RESULT_BAD_ARG;
     }
 
+    /* Nearly unchanged input, the output of the last inference stays valid */
+    if (mtb_ml_input_gate_skip(object, input))
+    {
+        return MTB_ML_RESULT_SUCCESS;
+    }
+    const MTB_ML_DATA_T *gate_input = input;
+
     tflm_rmf_apis_t *rmf_api = (tflm_rmf_apis_t *) object->tflm_obj;
 
     /* Set input data */
@@ -210,34 +226,44 @@ cy_rslt_t mtb_ml_model_run(mtb_ml_model_t *object, MTB_ML_DATA_T *input)
     if (object->profiling & MTB_ML_PROFILE_ENABLE_MODEL)
     {
         mtb_ml_model_profile_get_tsc(&object->m_cpu_cycles);
-#if (!defined(COMPONENT_RTOS) && \
-      defined(COMPONENT_NNLITE2))
-        mtb_ml_npu_cycles = 0;
+#if defined(COMPONENT_NNLITE2)
+        object->npu_prof.npu_cycles = 0;
 #endif
     }
+#if defined(COMPONENT_NNLITE2)
+    /* NNLite driver callbacks account to the context bound by this task */
+    object->npu_prof.op_seq = 0;
+    object->npu_prof.frame = object->m_sum_frames;
+    mtb_ml_nnlite_prof_bind(&object->npu_prof);
+#endif
     ret = rmf_api->model_invoke();
+#if defined(COMPONENT_NNLITE2)
+    mtb_ml_nnlite_prof_bind(NULL);
+#endif
     if ( ret != kTfLiteOk )
     {
         object->lib_error = ret;
         return MTB_ML_RESULT_INFERENCE_ERROR;
     }
+    mtb_ml_input_gate_update(object, gate_input);
 
     if (object->profiling & MTB_ML_PROFILE_ENABLE_MODEL)
     {
         uint64_t cycles = 0U;
         mtb_ml_model_profile_get_tsc(&cycles);
         uint64_t cpu_cycles_only = cycles - object->m_cpu_cycles;
-#if (!defined(COMPONENT_RTOS) && \
-      defined(COMPONENT_NNLITE2))
+#if defined(COMPONENT_NNLITE2)
+        uint64_t npu_cycles = object->npu_prof.npu_cycles;
         /* mtb_ml_init() : mtb_ml_norm_clk_freq = npu_freq/cpu_freq */
-        uint64_t norm_npu_cycles = (uint64_t)(((float)mtb_ml_npu_cycles) / mtb_ml_norm_clk_freq);
+        uint64_t norm_npu_cycles = (uint64_t)(((float)npu_cycles) / mtb_ml_norm_clk_freq);
         /* Check for bad cpu/npu count values so we don't overflow */
         if (norm_npu_cycles > cpu_cycles_only)
         {
             return MTB_ML_RESULT_CYCLE_COUNT_ERROR;
         }
 
-        object->m_npu_cycles = mtb_ml_npu_cycles;
+        object->m_npu_cycles = npu_cycles;
+        mtb_ml_npu_cycles = npu_cycles;
         if (object->m_npu_cycles > object->m_npu_peak_cycles)
         {
             object->m_npu_peak_cycles = object->m_npu_cycles;
@@ -246,6 +272,9 @@ cy_rslt_t mtb_ml_model_run(mtb_ml_model_t *object, MTB_ML_DATA_T *input)
         object->m_npu_sum_cycles += object->m_npu_cycles;
         /* Subtracting NPU fraction */
         cpu_cycles_only -= norm_npu_cycles;
+#endif
+#if defined(COMPONENT_NNLITE2)
+        mtb_ml_nnlite_wait_account(npu_cycles);
 #endif
         if (cpu_cycles_only > object->m_cpu_peak_cycles)
         {
@@ -390,6 +419,14 @@ cy_rslt_t mtb_ml_model_profile_config(mtb_ml_model_t *object, mtb_ml_profile_con
         object->m_npu_sum_cycles = 0;
         object->m_npu_peak_frame = 0;
         object->m_npu_peak_cycles = 0;
+#endif
+#if defined(COMPONENT_NNLITE2)
+    /* Kernel timing records are kept with layer profiling only */
+    if (mtb_ml_nnlite_prof_kernels_enable(&object->npu_prof,
+            (object->profiling & MTB_ML_PROFILE_ENABLE_LAYER) != 0) != MTB_ML_RESULT_SUCCESS)
+    {
+        return MTB_ML_RESULT_ALLOC_ERR;
+    }
 #endif
     return MTB_ML_RESULT_SUCCESS;
 }
@@ -416,6 +453,13 @@ cy_rslt_t mtb_ml_model_profile_log(mtb_ml_model_t *object)
                 (float)object->m_npu_peak_cycles,
                 object->m_npu_peak_frame,
                 mtb_ml_npu_clk_freq / 1000000);
+#endif
+#if defined(COMPONENT_NNLITE2)
+        if (object->profiling & MTB_ML_PROFILE_ENABLE_LAYER)
+        {
+            (void)mtb_ml_nnlite_prof_kernels_log(&object->npu_prof);
+        }
+        mtb_ml_nnlite_wait_log();
 #endif
     }
 
@@ -47,6 +47,15 @@
 #endif
 
 void u55_irq_handler(void);
+/******************************************************************************
+ * Macros
+******************************************************************************/
+/* Mask of all PMU event counters (ETHOSU_PMU_CNT1_Msk..ETHOSU_PMU_CNT4_Msk) */
+#define MTB_ML_ETHOSU_PMU_EVCNT_MSK     ((1UL << MTB_ML_NPU_PMU_EVENT_COUNT) - 1UL)
+/* Wrap values of the 48-bit cycle counter and the 32-bit event counters */
+#define MTB_ML_ETHOSU_PMU_CCNT_WRAP     (1ULL << 48)
+#define MTB_ML_ETHOSU_PMU_EVCNT_WRAP    (1ULL << 32)
+
 /******************************************************************************
  * Public variables
 ******************************************************************************/
@@ -81,6 +90,19 @@ typedef struct _cpu_cache_state {
 ******************************************************************************/
 static cpu_cache_state s_cache_state = {.dcache_cleaned = 0, .dcache_invalidated = 0};
 static uint32_t mtb_ml_cache_mgmt_type = MTB_ML_ETHOSU_CACHE_MGMT_TYPE;
+static mtb_ml_npu_pm_t mtb_ml_ethosu_pm;
+static uint32_t (*mtb_ml_ethosu_pm_time_source)(void) = NULL;
+#if defined(CY_RTOS_AWARE)
+static cy_mutex_t mtb_ml_ethosu_pm_mutex;
+static cy_timer_t mtb_ml_ethosu_pm_timer;
+#endif
+static enum ethosu_pmu_event_type mtb_ml_pmu_events[MTB_ML_NPU_PMU_EVENT_COUNT] =
+{
+    MTB_ML_ETHOSU_PMU_EVENT0,
+    MTB_ML_ETHOSU_PMU_EVENT1,
+    MTB_ML_ETHOSU_PMU_EVENT2,
+    MTB_ML_ETHOSU_PMU_EVENT3
+};
 
 void mtb_ml_set_cache_mgmt_type(uint32_t type)
 {
@@ -91,6 +113,22 @@ uint32_t mtb_ml_get_cache_mgmt_type(void)
 {
     return mtb_ml_cache_mgmt_type;
 }
+
+void mtb_ml_set_pmu_events(const enum ethosu_pmu_event_type events[MTB_ML_NPU_PMU_EVENT_COUNT])
+{
+    for (uint32_t i = 0; i < MTB_ML_NPU_PMU_EVENT_COUNT; i++)
+    {
+        mtb_ml_pmu_events[i] = events[i];
+    }
+}
+
+void mtb_ml_get_pmu_events(enum ethosu_pmu_event_type events[MTB_ML_NPU_PMU_EVENT_COUNT])
+{
+    for (uint32_t i = 0; i < MTB_ML_NPU_PMU_EVENT_COUNT; i++)
+    {
+        events[i] = mtb_ml_pmu_events[i];
+    }
+}
 /**
  * @brief   Gets the current CPU cache state.
  * @return  Pointer to the CPU cache state object.
@@ -108,12 +146,182 @@ void ethosu_clear_cache_states(void)
     state->dcache_cleaned     = 0;
 }
 
+/*******************************************************************************
+ * Power manager operations
+*******************************************************************************/
+/* Powers the NPU up and initializes the Ethos-U driver */
+static cy_rslt_t mtb_ml_ethosu_power_on(void *arg)
+{
+    struct ethosu_driver *drv = (struct ethosu_driver *)arg;
+
+    /* Must enable peripheral before initializing driver*/
+    Cy_SysEnableU55(true);
+
+    if (0 != ethosu_init(
+                drv,                            /* Ethos-U55 driver device pointer */
+                (void * const)U550_BASE,        /* Ethos-U55's base address. */
+                NULL,                           /* Pointer to fast mem area - NULL for U55. */
+                0,                              /* Fast mem region size. */
+                MTB_ML_ETHOSU_SECURITY_ENABLE,
+                MTB_ML_ETHOSU_PRIVILEGE_ENABLE))
+    {
+        printf("Failed to initialize Ethos-U55 device\r\n");
+        Cy_SysEnableU55(false);
+        return MTB_ML_RESULT_NPU_INIT_ERROR;
+    }
+
+    /* Cache maintenance state does not survive the power cycle */
+    ethosu_clear_cache_states();
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+/* Deinitializes the Ethos-U driver and powers the NPU down */
+static void mtb_ml_ethosu_power_off(void *arg)
+{
+    struct ethosu_driver *drv = (struct ethosu_driver *)arg;
+
+    /* Disable PMU block */
+    ETHOSU_PMU_Disable(drv);
+
+    ethosu_soft_reset(drv);
+    ethosu_deinit(drv /* Ethos-U55 driver device pointer */);
+    Cy_SysEnableU55(false);
+}
+
+static uint32_t mtb_ml_ethosu_pm_get_time_ms(void *arg)
+{
+    (void)arg;
+#if defined(CY_RTOS_AWARE)
+    if (mtb_ml_ethosu_pm_time_source == NULL)
+    {
+        cy_time_t now = 0;
+        (void)cy_rtos_get_time(&now);
+        return (uint32_t)now;
+    }
+#endif
+    return mtb_ml_ethosu_pm_time_source();
+}
+
+static uint64_t mtb_ml_ethosu_pm_get_cycles(void *arg)
+{
+    uint64_t cycles = 0;
+    (void)arg;
+    mtb_ml_model_profile_get_tsc(&cycles);
+    return cycles;
+}
+
+#if defined(CY_RTOS_AWARE)
+static void mtb_ml_ethosu_pm_lock(void *arg)
+{
+    (void)arg;
+    (void)cy_rtos_mutex_get(&mtb_ml_ethosu_pm_mutex, CY_RTOS_NEVER_TIMEOUT);
+}
+
+static void mtb_ml_ethosu_pm_unlock(void *arg)
+{
+    (void)arg;
+    (void)cy_rtos_mutex_set(&mtb_ml_ethosu_pm_mutex);
+}
+
+/* The timer task must not block on the mutex */
+static bool mtb_ml_ethosu_pm_try_lock(void *arg)
+{
+    (void)arg;
+    return cy_rtos_mutex_get(&mtb_ml_ethosu_pm_mutex, 0) == CY_RSLT_SUCCESS;
+}
+
+/* Idle timeout expiry, runs in the timer task. A missed expiry, with the state machine
+ * held, is followed by a release or a timeout change restarting the timer. An expiry
+ * ahead of the idle timeout, from tick rounding, re-arms the timer for the time left */
+static void mtb_ml_ethosu_pm_timer_cb(cy_timer_callback_arg_t arg)
+{
+    uint32_t idle_left_ms = 0;
+    (void)arg;
+    if (!mtb_ml_npu_pm_process(&mtb_ml_ethosu_pm, &idle_left_ms) && (idle_left_ms > 0))
+    {
+        (void)cy_rtos_timer_start(&mtb_ml_ethosu_pm_timer, idle_left_ms);
+    }
+}
+#endif
+
+static mtb_ml_npu_pm_ops_t mtb_ml_ethosu_pm_ops =
+{
+    .power_on       = mtb_ml_ethosu_power_on,
+    .power_off      = mtb_ml_ethosu_power_off,
+    .get_time_ms    = NULL,
+    .get_cycles     = mtb_ml_ethosu_pm_get_cycles,
+#if defined(CY_RTOS_AWARE)
+    .lock           = mtb_ml_ethosu_pm_lock,
+    .unlock         = mtb_ml_ethosu_pm_unlock,
+    .try_lock       = mtb_ml_ethosu_pm_try_lock,
+#else
+    .lock           = NULL,
+    .unlock         = NULL,
+    .try_lock       = NULL,
+#endif
+    .arg            = &ethosu_drv,
+};
+
+/*******************************************************************************
+ * Public Functions
+*******************************************************************************/
+cy_rslt_t mtb_ml_npu_power_acquire(void)
+{
+    return mtb_ml_npu_pm_acquire(&mtb_ml_ethosu_pm);
+}
+
+void mtb_ml_npu_power_release(void)
+{
+    mtb_ml_npu_pm_release(&mtb_ml_ethosu_pm);
+#if defined(CY_RTOS_AWARE)
+    if ((mtb_ml_ethosu_pm.idle_timeout_ms != MTB_ML_NPU_PM_ALWAYS_ON) &&
+        (mtb_ml_ethosu_pm.state == MTB_ML_NPU_PM_IDLE))
+    {
+        (void)cy_rtos_timer_start(&mtb_ml_ethosu_pm_timer, mtb_ml_ethosu_pm.idle_timeout_ms);
+    }
+#endif
+}
+
+bool mtb_ml_npu_power_process(void)
+{
+    return mtb_ml_npu_pm_process(&mtb_ml_ethosu_pm, NULL);
+}
+
+void mtb_ml_npu_power_set_idle_timeout(uint32_t idle_timeout_ms)
+{
+    mtb_ml_npu_pm_set_idle_timeout(&mtb_ml_ethosu_pm, idle_timeout_ms);
+#if defined(CY_RTOS_AWARE)
+    if ((idle_timeout_ms != MTB_ML_NPU_PM_ALWAYS_ON) && (mtb_ml_ethosu_pm.state == MTB_ML_NPU_PM_IDLE))
+    {
+        (void)cy_rtos_timer_start(&mtb_ml_ethosu_pm_timer, idle_timeout_ms);
+    }
+#endif
+}
+
+void mtb_ml_npu_power_set_time_source(uint32_t (*get_time_ms)(void))
+{
+    mtb_ml_ethosu_pm_time_source = get_time_ms;
+#if !defined(CY_RTOS_AWARE)
+    /* Bare-metal has no default time base, power gating needs the application's one */
+    mtb_ml_ethosu_pm_ops.get_time_ms = (get_time_ms != NULL) ? mtb_ml_ethosu_pm_get_time_ms : NULL;
+#endif
+}
+
+void mtb_ml_npu_power_get_stats(mtb_ml_npu_pm_stats_t *stats)
+{
+    if (stats != NULL)
+    {
+        *stats = mtb_ml_ethosu_pm.stats;
+    }
+}
+
 /*******************************************************************************
  * Private Functions
 *******************************************************************************/
 /* This function initializes the Ethos-U driver. */
 cy_rslt_t mtb_ml_ethosu_init(struct ethosu_driver *ethosu_drv, uint32_t priority)
 {
+    cy_rslt_t result;
 
     U55_SCB_IRQ_cfg.intrSrc      = mxu55_interrupt_npu_IRQn;
     U55_SCB_IRQ_cfg.intrPriority = priority;
@@ -128,29 +336,29 @@ cy_rslt_t mtb_ml_ethosu_init(struct ethosu_driver *ethosu_drv, uint32_t priority
     /* Enable the interrupt */
     NVIC_EnableIRQ(U55_SCB_IRQ_cfg.intrSrc);
 
-    /* Must enable peripheral before initializing driver*/
-    Cy_SysEnableU55(true);
-
-    if (0 != ethosu_init(
-                ethosu_drv,                     /* Ethos-U55 driver device pointer */
-                (void * const)U550_BASE,        /* Ethos-U55's base address. */
-                NULL,                           /* Pointer to fast mem area - NULL for U55. */
-                0,                              /* Fast mem region size. */
-                MTB_ML_ETHOSU_SECURITY_ENABLE,
-                MTB_ML_ETHOSU_PRIVILEGE_ENABLE))
+    if (ethosu_drv == NULL)
     {
-        printf("Failed to initialize Ethos-U55 device\r\n");
         return MTB_ML_RESULT_NPU_INIT_ERROR;
     }
 
-    if (ethosu_drv != NULL)
+    result = mtb_ml_ethosu_power_on(ethosu_drv);
+    if (result != MTB_ML_RESULT_SUCCESS)
     {
-        mtb_ml_ethosu_driver_handle = ethosu_drv;
+        return result;
     }
-    else
+    mtb_ml_ethosu_driver_handle = ethosu_drv;
+
+#if defined(CY_RTOS_AWARE)
+    mtb_ml_ethosu_pm_ops.get_time_ms = mtb_ml_ethosu_pm_get_time_ms;
+    if ((cy_rtos_mutex_init(&mtb_ml_ethosu_pm_mutex, false) != CY_RSLT_SUCCESS) ||
+        (cy_rtos_timer_init(&mtb_ml_ethosu_pm_timer, CY_TIMER_TYPE_ONCE, mtb_ml_ethosu_pm_timer_cb, 0) != CY_RSLT_SUCCESS))
     {
         return MTB_ML_RESULT_NPU_INIT_ERROR;
     }
+#endif
+    mtb_ml_ethosu_pm_ops.arg = ethosu_drv;
+    /* The NPU was just powered up, the power manager starts idle */
+    (void)mtb_ml_npu_pm_init(&mtb_ml_ethosu_pm, &mtb_ml_ethosu_pm_ops, MTB_ML_NPU_IDLE_TIMEOUT_MS);
 
     mtb_ml_npu_clk_freq = Cy_SysClk_ClkHfGetFrequency(Cy_Sysclk_PeriPclkGetClkHfNum(PCLK_MXU55_CLK_HF));
     return MTB_ML_RESULT_SUCCESS;
@@ -168,12 +376,15 @@ cy_rslt_t mtb_ml_ethosu_deinit()
         /* Enable the interrupt */
         NVIC_DisableIRQ(U55_SCB_IRQ_cfg.intrSrc);
 
-        /* Disable PMU block */
-        ETHOSU_PMU_Disable(mtb_ml_ethosu_driver_handle);
-
-        ethosu_soft_reset(mtb_ml_ethosu_driver_handle);
-        ethosu_deinit(mtb_ml_ethosu_driver_handle /* Ethos-U55 driver device pointer */);
-        Cy_SysEnableU55(false);
+        /* Powers the NPU down unless the idle timeout already did */
+        if (mtb_ml_npu_pm_suspend(&mtb_ml_ethosu_pm) != MTB_ML_RESULT_SUCCESS)
+        {
+            return MTB_ML_RESULT_BAD_ARG;
+        }
+#if defined(CY_RTOS_AWARE)
+        (void)cy_rtos_timer_deinit(&mtb_ml_ethosu_pm_timer);
+        (void)cy_rtos_mutex_deinit(&mtb_ml_ethosu_pm_mutex);
+#endif
 
         mtb_ml_ethosu_driver_handle = NULL;
     }
@@ -203,11 +414,24 @@ void ethosu_inference_begin(struct ethosu_driver *drv, void *user_arg)
     /* Unused */
     ((void)user_arg);
 
-    /* Enable cycle counter */
-    ETHOSU_PMU_CNTR_Enable(drv, ETHOSU_PMU_CCNT_Msk);
+    /* The PMU block is enabled per inference as power gating resets it */
+    ETHOSU_PMU_Enable(drv);
 
-    /* Reset cycle counter*/
+    /* Select the configured event of each PMU event counter */
+    for (uint32_t i = 0; i < MTB_ML_NPU_PMU_EVENT_COUNT; i++)
+    {
+        ETHOSU_PMU_Set_EVTYPER(drv, i, mtb_ml_pmu_events[i]);
+    }
+
+    /* Clear stale overflow flags */
+    ETHOSU_PMU_Set_CNTR_OVS(drv, ETHOSU_PMU_CCNT_Msk | MTB_ML_ETHOSU_PMU_EVCNT_MSK);
+
+    /* Enable cycle and event counters */
+    ETHOSU_PMU_CNTR_Enable(drv, ETHOSU_PMU_CCNT_Msk | MTB_ML_ETHOSU_PMU_EVCNT_MSK);
+
+    /* Reset cycle and event counters */
     ETHOSU_PMU_CYCCNT_Reset(drv);
+    ETHOSU_PMU_EVCNTR_ALL_Reset(drv);
 }
 
 /**
@@ -215,22 +439,60 @@ void ethosu_inference_begin(struct ethosu_driver *drv, void *user_arg)
  *          inference end callback
  *
  * \param[in]   drv         : pointer to ethosu_driver
- * \param[in]   bytes       : pointer to user arg
+ * \param[in]   user_arg    : pointer to mtb_ml_npu_prof_ctx_t of the invocation (TFLM external context)
  */
 void ethosu_inference_end(struct ethosu_driver *drv, void *user_arg)
 {
-    /* Unused */
-    ((void)user_arg);
+    /* Profiling context of the invocation, see mtb_ml_model_run() */
+    mtb_ml_npu_prof_ctx_t *ctx = (mtb_ml_npu_prof_ctx_t *)user_arg;
+    mtb_ml_npu_pmu_sample_t sample;
+    uint32_t ovs;
+    uint32_t overflows = 0;
+
+    ETHOSU_PMU_CNTR_Disable(drv, ETHOSU_PMU_CCNT_Msk | MTB_ML_ETHOSU_PMU_EVCNT_MSK);
+    ovs = ETHOSU_PMU_Get_CNTR_OVS(drv);
+
+    /* A set overflow flag means the counter wrapped once during this custom
+     * operator. It is extended instead of discarding the whole measurement. */
+    sample.cycles = ETHOSU_PMU_Get_CCNTR(drv);
+    if (ovs & ETHOSU_PMU_CCNT_Msk)
+    {
+        sample.cycles += MTB_ML_ETHOSU_PMU_CCNT_WRAP;
+        overflows++;
+    }
+    for (uint32_t i = 0; i < MTB_ML_NPU_PMU_EVENT_COUNT; i++)
+    {
+        sample.events[i] = ETHOSU_PMU_Get_EVCNTR(drv, i);
+        if (ovs & (1UL << i))
+        {
+            sample.events[i] += MTB_ML_ETHOSU_PMU_EVCNT_WRAP;
+            overflows++;
+        }
+    }
+    ETHOSU_PMU_Set_CNTR_OVS(drv, ovs);
 
-    ETHOSU_PMU_CNTR_Disable(drv, ETHOSU_PMU_CCNT_Msk);
-    if (ETHOSU_PMU_Get_CNTR_OVS(drv) & ETHOSU_PMU_CCNT_Msk)
+    if ((ctx == NULL) || (ctx->counters == NULL))
     {
-        mtb_ml_npu_cycles = 0;
+        /* Invocation not issued through mtb_ml_model_run() */
+        mtb_ml_npu_cycles += sample.cycles;
+        return;
     }
-    else
+
+    mtb_ml_npu_counters_t *counters = ctx->counters;
+    for (uint32_t i = 0; i < MTB_ML_NPU_PMU_EVENT_COUNT; i++)
+    {
+        counters->event_type[i] = (uint32_t)mtb_ml_pmu_events[i];
+        counters->total.events[i] += sample.events[i];
+    }
+    counters->total.cycles += sample.cycles;
+    counters->overflow_count += overflows;
+    if (counters->op_count < MTB_ML_NPU_COUNTERS_MAX_OPS)
     {
-        mtb_ml_npu_cycles += ETHOSU_PMU_Get_CCNTR(drv);
+        counters->op[counters->op_count] = sample;
     }
+    counters->op_count++;
+
+    ctx->npu_cycles += sample.cycles;
 }
 
 /**
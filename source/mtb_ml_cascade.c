@@ -0,0 +1,324 @@
+/***************************************************************************//**
+* \file mtb_ml_cascade.c
+*
+* \brief
+* This file contains the cascade of a gate model and an expensive model
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <inttypes.h>
+#include "mtb_ml_common.h"
+#include "mtb_ml_cascade.h"
+#include "mtb_ml_utils.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define CASCADE_ARENA_ALIGN     16
+
+/*******************************************************************************
+ * Private Functions
+*******************************************************************************/
+static uint64_t cascade_tsc(void)
+{
+    uint64_t now = 0;
+    mtb_ml_model_profile_get_tsc(&now);
+    return now;
+}
+
+/* Threshold in the quantized domain of the gate output, compared without dequantizing */
+static cy_rslt_t cascade_set_predicate(mtb_ml_cascade_t *cascade, const mtb_ml_cascade_gate_t *predicate)
+{
+    const mtb_ml_model_t *gate = cascade->gate;
+    int32_t q_min, q_max;
+    float q;
+
+    switch(predicate->type)
+    {
+        case MTB_ML_CASCADE_GATE_THRESHOLD:
+            if(predicate->index >= (uint32_t)gate->output_size)
+            {
+                return MTB_ML_RESULT_BAD_ARG;
+            }
+            break;
+        case MTB_ML_CASCADE_GATE_ARGMAX_IN_SET:
+            if(predicate->class_set == 0)
+            {
+                return MTB_ML_RESULT_BAD_ARG;
+            }
+            break;
+        case MTB_ML_CASCADE_GATE_CALLBACK:
+            if(predicate->callback == NULL)
+            {
+                return MTB_ML_RESULT_BAD_ARG;
+            }
+            break;
+        default:
+            return MTB_ML_RESULT_BAD_ARG;
+    }
+    cascade->predicate = *predicate;
+
+    if(predicate->type == MTB_ML_CASCADE_GATE_THRESHOLD && gate->output_type_size != sizeof(float))
+    {
+        if(gate->output_scale <= 0.0f)
+        {
+            return MTB_ML_RESULT_BAD_MODEL;
+        }
+        q_min = (gate->output_type_size == sizeof(int8_t)) ? INT8_MIN : INT16_MIN;
+        q_max = (gate->output_type_size == sizeof(int8_t)) ? INT8_MAX : INT16_MAX;
+        /* Smallest quantized value at or above the threshold */
+        q = ceilf(predicate->threshold / gate->output_scale) + (float)gate->output_zero_point;
+        if(q < (float)q_min)
+        {
+            q = (float)q_min;
+        }
+        else if(q > (float)q_max + 1.0f)
+        {
+            q = (float)q_max + 1.0f;
+        }
+        cascade->q_threshold = (int32_t)q;
+    }
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+static bool cascade_gate_pass(const mtb_ml_cascade_t *cascade)
+{
+    const mtb_ml_model_t *gate = cascade->gate;
+    const mtb_ml_cascade_gate_t *predicate = &cascade->predicate;
+    const void *out = gate->output;
+    int top;
+
+    switch(predicate->type)
+    {
+        case MTB_ML_CASCADE_GATE_THRESHOLD:
+            switch(gate->output_type_size)
+            {
+                case sizeof(int8_t):
+                    return ((const int8_t *)out)[predicate->index] >= cascade->q_threshold;
+                case sizeof(int16_t):
+                    return ((const int16_t *)out)[predicate->index] >= cascade->q_threshold;
+                default:
+                    return ((const float *)out)[predicate->index] >= predicate->threshold;
+            }
+        case MTB_ML_CASCADE_GATE_ARGMAX_IN_SET:
+            top = mtb_ml_utils_model_find_max(gate);
+            return (top >= 0) && (top < 64) && ((predicate->class_set >> top) & 1U);
+        default:
+            return predicate->callback(gate, predicate->callback_arg);
+    }
+}
+
+/*******************************************************************************
+ * Public Functions
+*******************************************************************************/
+cy_rslt_t mtb_ml_cascade_init(mtb_ml_cascade_t *cascade, const mtb_ml_model_bin_t *gate_bin,
+                              const mtb_ml_model_bin_t *main_bin, const mtb_ml_model_buffer_t *buffer,
+                              const mtb_ml_cascade_gate_t *predicate)
+{
+    mtb_ml_model_buffer_t gate_buffer, main_buffer;
+    const mtb_ml_model_buffer_t *gate_buf = NULL, *main_buf = NULL;
+    mtb_ml_model_t *gate_model = NULL, *main_model = NULL;
+    cy_rslt_t result;
+
+    if(cascade == NULL || gate_bin == NULL || main_bin == NULL || predicate == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    if(buffer != NULL && buffer->tensor_arena != NULL)
+    {
+        /* The stages run one after the other out of one arena */
+        uintptr_t base = (uintptr_t)buffer->tensor_arena;
+        uintptr_t end = base + buffer->tensor_arena_size;
+        uintptr_t split;
+
+        base = (base + CASCADE_ARENA_ALIGN - 1) & ~(uintptr_t)(CASCADE_ARENA_ALIGN - 1);
+        split = (base + (uintptr_t)gate_bin->arena_size + CASCADE_ARENA_ALIGN - 1) & ~(uintptr_t)(CASCADE_ARENA_ALIGN - 1);
+        if(gate_bin->arena_size <= 0 || split >= end)
+        {
+            return MTB_ML_RESULT_ALLOC_ERR;
+        }
+        gate_buffer.tensor_arena = (uint8_t *)base;
+        gate_buffer.tensor_arena_size = (size_t)gate_bin->arena_size;
+        main_buffer.tensor_arena = (uint8_t *)split;
+        main_buffer.tensor_arena_size = (size_t)(end - split);
+        gate_buf = &gate_buffer;
+        main_buf = &main_buffer;
+    }
+
+    result = mtb_ml_model_init(gate_bin, gate_buf, &gate_model);
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        return result;
+    }
+    result = mtb_ml_model_init(main_bin, main_buf, &main_model);
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        (void)mtb_ml_model_deinit(gate_model);
+        return result;
+    }
+
+    result = mtb_ml_cascade_attach(cascade, gate_model, main_model, predicate);
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        (void)mtb_ml_model_deinit(main_model);
+        (void)mtb_ml_model_deinit(gate_model);
+        return result;
+    }
+    cascade->owns_models = true;
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_cascade_attach(mtb_ml_cascade_t *cascade, mtb_ml_model_t *gate, mtb_ml_model_t *main,
+                                const mtb_ml_cascade_gate_t *predicate)
+{
+    if(cascade == NULL || gate == NULL || main == NULL || predicate == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    memset(cascade, 0, sizeof(*cascade));
+    cascade->gate = gate;
+    cascade->main = main;
+    return cascade_set_predicate(cascade, predicate);
+}
+
+cy_rslt_t mtb_ml_cascade_run(mtb_ml_cascade_t *cascade, MTB_ML_DATA_T *gate_input,
+                             MTB_ML_DATA_T *main_input, bool *triggered)
+{
+    mtb_ml_cascade_stats_t *stats;
+    uint64_t start, end;
+    cy_rslt_t result;
+
+    if(cascade == NULL || cascade->gate == NULL || gate_input == NULL || triggered == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    if(main_input == NULL)
+    {
+        if(cascade->gate->input_size != cascade->main->input_size ||
+           cascade->gate->input_type_size != cascade->main->input_type_size)
+        {
+            return MTB_ML_RESULT_INPUT_ERROR;
+        }
+        main_input = gate_input;
+    }
+
+    stats = &cascade->stats;
+    *triggered = false;
+    start = cascade_tsc();
+    result = mtb_ml_model_run(cascade->gate, gate_input);
+    end = cascade_tsc();
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        return result;
+    }
+    stats->frames++;
+    stats->gate_cycles += end - start;
+
+    if(!cascade_gate_pass(cascade))
+    {
+        return MTB_ML_RESULT_SUCCESS;
+    }
+
+    start = end;
+    result = mtb_ml_model_run(cascade->main, main_input);
+    end = cascade_tsc();
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        return result;
+    }
+    stats->gate_hits++;
+    stats->main_cycles += end - start;
+    *triggered = true;
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_cascade_get_stats(const mtb_ml_cascade_t *cascade, mtb_ml_cascade_stats_t *stats)
+{
+    uint64_t always_on;
+
+    if(cascade == NULL || stats == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    *stats = cascade->stats;
+    if(stats->frames == 0)
+    {
+        return MTB_ML_RESULT_SUCCESS;
+    }
+    stats->hit_rate = (float)stats->gate_hits / (float)stats->frames;
+
+    /* The cost of an always-on expensive model is only known once it ran */
+    if(stats->gate_hits != 0)
+    {
+        always_on = (stats->main_cycles / stats->gate_hits) * stats->frames;
+        stats->saved_cycles = (int64_t)always_on - (int64_t)(stats->gate_cycles + stats->main_cycles);
+        stats->avg_saved_cycles = stats->saved_cycles / (int64_t)stats->frames;
+        stats->saved_ratio = (always_on != 0) ? (float)stats->saved_cycles / (float)always_on : 0.0f;
+    }
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_cascade_log(const mtb_ml_cascade_stats_t *stats)
+{
+    if(stats == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    printf("CASCADE_INFO, frames=%-8" PRIu32 ", gate_hits=%-8" PRIu32 ", hit_rate=%-8.4f, gate_cycles=%-12" PRIu64 ", main_cycles=%-12" PRIu64 ", avg_saved_cycles=%-10" PRId64 ", saved_ratio=%.4f\r\n",
+           stats->frames, stats->gate_hits, stats->hit_rate, stats->gate_cycles, stats->main_cycles,
+           stats->avg_saved_cycles, stats->saved_ratio);
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_cascade_deinit(mtb_ml_cascade_t *cascade)
+{
+    if(cascade == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    if(cascade->owns_models)
+    {
+        (void)mtb_ml_model_deinit(cascade->main);
+        (void)mtb_ml_model_deinit(cascade->gate);
+    }
+    memset(cascade, 0, sizeof(*cascade));
+    return MTB_ML_RESULT_SUCCESS;
+}
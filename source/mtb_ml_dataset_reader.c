@@ -0,0 +1,336 @@
+/***************************************************************************//**
+* \file mtb_ml_dataset_reader.c
+*
+* \brief
+* This file contains the reader of ML test datasets (x data and reference results)
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "mtb_ml_common.h"
+#include "mtb_ml_dataset_reader.h"
+
+#if defined(COMPONENT_ML_HOST)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/*******************************************************************************
+ * Private Functions
+*******************************************************************************/
+static size_t dataset_type_size(mtb_ml_x_data_type_t type)
+{
+    switch(type)
+    {
+        case MTB_ML_X_DATA_FLOAT32:
+            return sizeof(float);
+        case MTB_ML_X_DATA_INT8:
+            return sizeof(int8_t);
+        case MTB_ML_X_DATA_INT16:
+            return sizeof(int16_t);
+        default:
+            return 0;
+    }
+}
+
+#if defined(COMPONENT_ML_HOST)
+static void *dataset_map_file(const char *path, size_t *size)
+{
+    struct stat st;
+    void *map;
+    int fd = open(path, O_RDONLY);
+
+    if(fd < 0)
+    {
+        return NULL;
+    }
+    if((fstat(fd, &st) != 0) || (st.st_size <= 0))
+    {
+        close(fd);
+        return NULL;
+    }
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(map == MAP_FAILED)
+    {
+        return NULL;
+    }
+    /* Samples are mostly read in order */
+    (void)madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+    *size = (size_t)st.st_size;
+    return map;
+}
+#endif
+
+/*******************************************************************************
+ * Public Functions
+*******************************************************************************/
+cy_rslt_t mtb_ml_dataset_open(mtb_ml_dataset_t *dataset, const void *x_data, size_t x_size,
+                              const void *y_data, size_t y_size)
+{
+    const mtb_ml_x_file_header_t *x_header = (const mtb_ml_x_file_header_t *)x_data;
+    const mtb_ml_y_file_header_t *y_header = (const mtb_ml_y_file_header_t *)y_data;
+    size_t type_size;
+
+    if((dataset == NULL) || (x_data == NULL))
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    memset(dataset, 0, sizeof(*dataset));
+
+    type_size = (x_size >= sizeof(*x_header)) ? dataset_type_size(x_header->data_type) : 0;
+    if((type_size == 0) || (x_header->num_of_samples < 0) || (x_header->input_size <= 0))
+    {
+        printf("ERROR: Invalid x data header\r\n");
+        return MTB_ML_RESULT_INPUT_ERROR;
+    }
+    dataset->x_header = x_header;
+    dataset->x_samples = (const uint8_t *)(x_header + 1);
+    dataset->num_samples = (uint32_t)x_header->num_of_samples;
+
+    /* Streaming RNN samples are sliced into recurrent_ts_size time steps */
+    dataset->slices = (x_header->recurrent_ts_size > 1) ? (uint32_t)x_header->recurrent_ts_size : 1;
+    if((uint32_t)x_header->input_size % dataset->slices != 0)
+    {
+        printf("ERROR: x data input size (%d) is not a multiple of its time steps (%d)\r\n",
+               (int)x_header->input_size, (int)dataset->slices);
+        return MTB_ML_RESULT_INPUT_ERROR;
+    }
+    dataset->sample_bytes = (size_t)x_header->input_size * type_size;
+    dataset->slice_bytes = dataset->sample_bytes / dataset->slices;
+    if((uint64_t)(x_size - sizeof(*x_header)) < (uint64_t)dataset->num_samples * dataset->sample_bytes)
+    {
+        printf("ERROR: x data shorter than its %u samples\r\n", (unsigned int)dataset->num_samples);
+        return MTB_ML_RESULT_INPUT_ERROR;
+    }
+
+    if(y_data == NULL)
+    {
+        return MTB_ML_RESULT_SUCCESS;
+    }
+    if((y_size >= sizeof(*y_header)) && (y_header->magic == MTB_ML_Y_FILE_MAGIC))
+    {
+        type_size = dataset_type_size(y_header->data_type);
+        if((type_size == 0) || (y_header->output_size <= 0) ||
+           (y_header->num_of_samples != x_header->num_of_samples) ||
+           ((uint64_t)(y_size - sizeof(*y_header)) <
+            (uint64_t)dataset->num_samples * (uint64_t)y_header->output_size * type_size))
+        {
+            printf("ERROR: Invalid y data header\r\n");
+            return MTB_ML_RESULT_INPUT_ERROR;
+        }
+        dataset->y_samples = (const uint8_t *)(y_header + 1);
+        dataset->y_type = y_header->data_type;
+        dataset->output_size = y_header->output_size;
+        dataset->y_bytes = y_size - sizeof(*y_header);
+    }
+    else
+    {
+        /* Reference results without header, typed by mtb_ml_dataset_validate() */
+        dataset->y_samples = (const uint8_t *)y_data;
+        dataset->y_type = MTB_ML_X_DATA_UNKNOWN;
+        dataset->y_bytes = y_size;
+    }
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+#if defined(COMPONENT_ML_HOST)
+cy_rslt_t mtb_ml_dataset_open_files(mtb_ml_dataset_t *dataset, const char *x_path, const char *y_path)
+{
+    void *x_map, *y_map = NULL;
+    size_t x_map_size, y_map_size = 0;
+    cy_rslt_t result;
+
+    if((dataset == NULL) || (x_path == NULL))
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    x_map = dataset_map_file(x_path, &x_map_size);
+    if(x_map == NULL)
+    {
+        printf("ERROR: Cannot map %s\r\n", x_path);
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    if(y_path != NULL)
+    {
+        y_map = dataset_map_file(y_path, &y_map_size);
+        if(y_map == NULL)
+        {
+            printf("ERROR: Cannot map %s\r\n", y_path);
+            munmap(x_map, x_map_size);
+            return MTB_ML_RESULT_BAD_ARG;
+        }
+    }
+
+    result = mtb_ml_dataset_open(dataset, x_map, x_map_size, y_map, y_map_size);
+    dataset->x_map = x_map;
+    dataset->x_map_size = x_map_size;
+    dataset->y_map = y_map;
+    dataset->y_map_size = y_map_size;
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        mtb_ml_dataset_close(dataset);
+    }
+    return result;
+}
+#endif
+
+cy_rslt_t mtb_ml_dataset_close(mtb_ml_dataset_t *dataset)
+{
+    if(dataset == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+#if defined(COMPONENT_ML_HOST)
+    if(dataset->x_map != NULL)
+    {
+        munmap(dataset->x_map, dataset->x_map_size);
+    }
+    if(dataset->y_map != NULL)
+    {
+        munmap(dataset->y_map, dataset->y_map_size);
+    }
+#endif
+    memset(dataset, 0, sizeof(*dataset));
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_dataset_validate(mtb_ml_dataset_t *dataset, const mtb_ml_model_t *model)
+{
+    size_t y_type_size;
+
+    if((dataset == NULL) || (dataset->x_header == NULL) || (model == NULL))
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    if(dataset_type_size(dataset->x_header->data_type) != (size_t)model->input_type_size)
+    {
+        printf("ERROR: Test data size (%d) does not match model data size (%d).\r\n",
+               (int)dataset_type_size(dataset->x_header->data_type), model->input_type_size);
+        return MTB_ML_RESULT_MISMATCH_DATA_TYPE;
+    }
+    if((uint32_t)dataset->x_header->input_size / dataset->slices != (uint32_t)model->input_size)
+    {
+        printf("ERROR: Test data input size (%d) does not match model input size (%d).\r\n",
+               (int)(dataset->x_header->input_size / (int32_t)dataset->slices), model->input_size);
+        return MTB_ML_RESULT_INPUT_ERROR;
+    }
+
+    if(dataset->y_samples == NULL)
+    {
+        return MTB_ML_RESULT_SUCCESS;
+    }
+    if(dataset->y_type == MTB_ML_X_DATA_UNKNOWN)
+    {
+        switch(model->output_type_size)
+        {
+            case sizeof(int8_t):
+                dataset->y_type = MTB_ML_X_DATA_INT8;
+                break;
+            case sizeof(int16_t):
+                dataset->y_type = MTB_ML_X_DATA_INT16;
+                break;
+            default:
+                dataset->y_type = MTB_ML_X_DATA_FLOAT32;
+                break;
+        }
+        dataset->output_size = model->output_size;
+    }
+    y_type_size = dataset_type_size(dataset->y_type);
+    if((dataset->y_type != MTB_ML_X_DATA_FLOAT32) && (y_type_size != (size_t)model->output_type_size))
+    {
+        printf("ERROR: Reference data size (%d) does not match model output size (%d).\r\n",
+               (int)y_type_size, model->output_type_size);
+        return MTB_ML_RESULT_MISMATCH_DATA_TYPE;
+    }
+    if((dataset->output_size != model->output_size) ||
+       ((uint64_t)dataset->y_bytes < (uint64_t)dataset->num_samples * (uint64_t)dataset->output_size * y_type_size))
+    {
+        printf("ERROR: Reference data does not match the %d model outputs of %u samples.\r\n",
+               model->output_size, (unsigned int)dataset->num_samples);
+        return MTB_ML_RESULT_INPUT_ERROR;
+    }
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_dataset_get_sample(const mtb_ml_dataset_t *dataset, uint32_t index, const void **x, const void **y)
+{
+    if((dataset == NULL) || (x == NULL) || (index >= dataset->num_samples))
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    *x = dataset->x_samples + (size_t)index * dataset->sample_bytes;
+    if(y != NULL)
+    {
+        *y = NULL;
+        if((dataset->y_samples != NULL) && (dataset->y_type != MTB_ML_X_DATA_UNKNOWN))
+        {
+            *y = dataset->y_samples + (size_t)index * (size_t)dataset->output_size * dataset_type_size(dataset->y_type);
+        }
+    }
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_dataset_get_slice(const mtb_ml_dataset_t *dataset, uint32_t index, uint32_t slice, const void **x)
+{
+    if((dataset == NULL) || (x == NULL) || (index >= dataset->num_samples) || (slice >= dataset->slices))
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    *x = dataset->x_samples + (size_t)index * dataset->sample_bytes + (size_t)slice * dataset->slice_bytes;
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+bool mtb_ml_dataset_next(mtb_ml_dataset_t *dataset, const void **x, const void **y)
+{
+    if((dataset == NULL) || (mtb_ml_dataset_get_sample(dataset, dataset->next, x, y) != MTB_ML_RESULT_SUCCESS))
+    {
+        return false;
+    }
+    dataset->next++;
+    return true;
+}
+
+void mtb_ml_dataset_rewind(mtb_ml_dataset_t *dataset)
+{
+    if(dataset != NULL)
+    {
+        dataset->next = 0;
+    }
+}
@@ -0,0 +1,182 @@
+/***************************************************************************//**
+* \file mtb_ml_input_gate.c
+*
+* \brief
+* This file contains the input-delta gate of the ML model inference
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "mtb_ml.h"
+#include "mtb_ml_model_impl.h"
+
+/*******************************************************************************
+ * Macros
+*******************************************************************************/
+/* Integer limit of the gate, leaving headroom for the block-wise early exit */
+#define INPUT_GATE_MAX_LIMIT    (UINT32_MAX / 2U)
+
+/*******************************************************************************
+ * Private Functions
+*******************************************************************************/
+static bool input_gate_within(const mtb_ml_model_t *object, const MTB_ML_DATA_T *input)
+{
+    const mtb_ml_input_gate_t *gate = &object->input_gate;
+    float threshold = gate->config.threshold;
+    uint32_t limit = (threshold >= (float)INPUT_GATE_MAX_LIMIT) ? INPUT_GATE_MAX_LIMIT : (uint32_t)threshold;
+
+    switch (object->input_type_size)
+    {
+        case sizeof(int8_t):
+            return mtb_ml_utils_input_delta_int8((const int8_t *)input, (const int8_t *)gate->reference,
+                                                 object->input_size, gate->config.metric, limit) <= limit;
+        case sizeof(int16_t):
+            return mtb_ml_utils_input_delta_int16((const int16_t *)input, (const int16_t *)gate->reference,
+                                                  object->input_size, gate->config.metric, limit) <= limit;
+        case sizeof(float):
+            return mtb_ml_utils_input_delta_flt((const float *)input, (const float *)gate->reference,
+                                                object->input_size, gate->config.metric, threshold) <= threshold;
+        default:
+            return false;
+    }
+}
+
+/*******************************************************************************
+ * Public Functions
+*******************************************************************************/
+bool mtb_ml_input_gate_skip(mtb_ml_model_t *object, const MTB_ML_DATA_T *input)
+{
+    mtb_ml_input_gate_t *gate = &object->input_gate;
+
+    if (!gate->enabled)
+    {
+        return false;
+    }
+    gate->stats.frames++;
+
+    /* Streaming RNN slices update the model state on every call */
+    if (!gate->valid || object->recurrent_ts_size != 0)
+    {
+        return false;
+    }
+    if (gate->config.refresh_frames != 0 && gate->skipped_in_row >= gate->config.refresh_frames)
+    {
+        gate->stats.refreshes++;
+        return false;
+    }
+    if (!input_gate_within(object, input))
+    {
+        return false;
+    }
+
+    gate->skipped_in_row++;
+    gate->stats.skipped++;
+    return true;
+}
+
+void mtb_ml_input_gate_update(mtb_ml_model_t *object, const MTB_ML_DATA_T *input)
+{
+    mtb_ml_input_gate_t *gate = &object->input_gate;
+
+    if (gate->enabled && object->recurrent_ts_size == 0)
+    {
+        if (object->input_ops != NULL)
+        {
+            object->input_ops->copy(gate->reference, input, object->input_size);
+        }
+        else
+        {
+            memcpy(gate->reference, input, (size_t)object->input_size * (size_t)object->input_type_size);
+        }
+        gate->valid = true;
+        gate->skipped_in_row = 0;
+    }
+}
+
+void mtb_ml_input_gate_free(mtb_ml_model_t *object)
+{
+    free(object->input_gate.reference);
+    memset(&object->input_gate, 0, sizeof(object->input_gate));
+}
+
+cy_rslt_t mtb_ml_model_input_gate_config(mtb_ml_model_t *object, const mtb_ml_input_gate_config_t *config)
+{
+    mtb_ml_input_gate_t *gate;
+
+    /* Sanity check of input parameters */
+    if (object == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    if (config == NULL)
+    {
+        mtb_ml_input_gate_free(object);
+        return MTB_ML_RESULT_SUCCESS;
+    }
+    if (config->metric > MTB_ML_INPUT_DELTA_MAX_ABS || !(config->threshold >= 0.0f) ||
+        object->input_size <= 0 || object->input_type_size <= 0)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    gate = &object->input_gate;
+    if (gate->reference == NULL)
+    {
+        gate->reference = malloc((size_t)object->input_size * (size_t)object->input_type_size);
+        if (gate->reference == NULL)
+        {
+            return MTB_ML_RESULT_ALLOC_ERR;
+        }
+    }
+    gate->config = *config;
+    gate->enabled = true;
+    gate->valid = false;
+    gate->skipped_in_row = 0;
+    memset(&gate->stats, 0, sizeof(gate->stats));
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_model_input_gate_get_stats(const mtb_ml_model_t *object, mtb_ml_input_gate_stats_t *stats)
+{
+    /* Sanity check of input parameters */
+    if (object == NULL || stats == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    *stats = object->input_gate.stats;
+    stats->skip_ratio = (stats->frames != 0) ? (float)stats->skipped / (float)stats->frames : 0.0f;
+    return MTB_ML_RESULT_SUCCESS;
+}
@@ -0,0 +1,61 @@
+/***************************************************************************//**
+* \file mtb_ml_model_impl.h
+*
+* \brief
+* This file contains the internal interface between the ML model implementations
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#if !defined(__MTB_ML_MODEL_IMPL_H__)
+#define __MTB_ML_MODEL_IMPL_H__
+
+#include <stdbool.h>
+#include "mtb_ml_model.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/* Input-delta gate of mtb_ml_model_run(), see mtb_ml_model_input_gate_config() */
+bool mtb_ml_input_gate_skip(mtb_ml_model_t *object, const MTB_ML_DATA_T *input);
+void mtb_ml_input_gate_update(mtb_ml_model_t *object, const MTB_ML_DATA_T *input);
+void mtb_ml_input_gate_free(mtb_ml_model_t *object);
+
+/* Template kernels of the int8, int16 (type_size 1, 2) or float data type, bound to the model object */
+const mtb_ml_type_ops_t *mtb_ml_type_ops_get(int type_size);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __MTB_ML_MODEL_IMPL_H__ */
@@ -0,0 +1,243 @@
+/***************************************************************************//**
+* \file mtb_ml_model_swap.c
+*
+* \brief
+* This file contains the double-buffered hot-swap of ML models
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include "cy_pdl.h"
+#include "mtb_ml_common.h"
+#include "mtb_ml_model_swap.h"
+
+/*******************************************************************************
+ * Private Functions
+*******************************************************************************/
+static uint64_t swap_tsc(void)
+{
+    uint64_t now = 0;
+    mtb_ml_model_profile_get_tsc(&now);
+    return now;
+}
+
+/*******************************************************************************
+ * Public Functions
+*******************************************************************************/
+cy_rslt_t mtb_ml_model_swap_init(mtb_ml_model_swap_t *swap, const mtb_ml_model_bin_t *bin,
+                                 const mtb_ml_model_buffer_t *buffer)
+{
+    if(swap == NULL || bin == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    memset(swap, 0, sizeof(*swap));
+    return mtb_ml_model_init(bin, buffer, &swap->slot[0].model);
+}
+
+cy_rslt_t mtb_ml_model_swap_prepare(mtb_ml_model_swap_t *swap, const mtb_ml_model_bin_t *bin,
+                                    const mtb_ml_model_buffer_t *buffer)
+{
+    mtb_ml_model_swap_slot_t *standby;
+    uint64_t start;
+    cy_rslt_t result;
+
+    if(swap == NULL || bin == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    /* The active slot only changes when the inference thread takes the commit */
+    if(swap->pending)
+    {
+        return MTB_ML_RESULT_BUSY;
+    }
+    __DMB();
+    standby = &swap->slot[swap->active ^ 1U];
+    if(standby->held)
+    {
+        return MTB_ML_RESULT_BUSY;
+    }
+
+    start = swap_tsc();
+    swap->prepared = false;
+    if(standby->model != NULL)
+    {
+        (void)mtb_ml_model_deinit(standby->model);
+        standby->model = NULL;
+    }
+    result = mtb_ml_model_init(bin, buffer, &standby->model);
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        standby->model = NULL;
+        return result;
+    }
+    swap->stats.prepare_cycles = swap_tsc() - start;
+    swap->prepared = true;
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_model_swap_commit(mtb_ml_model_swap_t *swap)
+{
+    if(swap == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    if(!swap->prepared)
+    {
+        return MTB_ML_RESULT_BAD_MODEL;
+    }
+
+    swap->prepared = false;
+    swap->commit_cycles = swap_tsc();
+    /* Publish the standby model before the commit */
+    __DMB();
+    swap->pending = true;
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_model_swap_run(mtb_ml_model_swap_t *swap, MTB_ML_DATA_T *input, mtb_ml_model_t **model)
+{
+    mtb_ml_model_swap_slot_t *slot;
+    uint64_t start = 0;
+    bool swapped = false;
+    cy_rslt_t result;
+
+    if(swap == NULL || input == NULL || model == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    if(swap->pending)
+    {
+        start = swap_tsc();
+        __DMB();
+        swap->active ^= 1U;
+        __DMB();
+        swap->pending = false;
+        swap->stats.swaps++;
+        swapped = true;
+    }
+
+    slot = &swap->slot[swap->active];
+    if(slot->model == NULL)
+    {
+        return MTB_ML_RESULT_BAD_MODEL;
+    }
+    if(slot->held)
+    {
+        swap->stats.dropped_frames++;
+        return MTB_ML_RESULT_BUSY;
+    }
+
+    result = mtb_ml_model_run(slot->model, input);
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        return result;
+    }
+    slot->held = true;
+    swap->stats.frames++;
+    if(swapped)
+    {
+        uint64_t now = swap_tsc();
+        swap->stats.swap_frame_cycles = now - start;
+        swap->stats.commit_to_live_cycles = now - swap->commit_cycles;
+    }
+    *model = slot->model;
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_model_swap_release(mtb_ml_model_swap_t *swap, const mtb_ml_model_t *model)
+{
+    if(swap == NULL || model == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    for(uint32_t i = 0; i < MTB_ML_MODEL_SWAP_SLOTS; i++)
+    {
+        if(swap->slot[i].model == model)
+        {
+            /* Reads of the output complete before the slot can be reused */
+            __DMB();
+            swap->slot[i].held = false;
+            return MTB_ML_RESULT_SUCCESS;
+        }
+    }
+    return MTB_ML_RESULT_BAD_ARG;
+}
+
+cy_rslt_t mtb_ml_model_swap_get_stats(const mtb_ml_model_swap_t *swap, mtb_ml_model_swap_stats_t *stats)
+{
+    if(swap == NULL || stats == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    *stats = swap->stats;
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_model_swap_log(const mtb_ml_model_swap_stats_t *stats)
+{
+    if(stats == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    printf("SWAP_INFO, swaps=%-6" PRIu32 ", frames=%-8" PRIu32 ", dropped_frames=%-6" PRIu32 ", prepare_cycles=%-10" PRIu64 ", swap_frame_cycles=%-10" PRIu64 ", commit_to_live_cycles=%" PRIu64 "\r\n",
+           stats->swaps, stats->frames, stats->dropped_frames, stats->prepare_cycles,
+           stats->swap_frame_cycles, stats->commit_to_live_cycles);
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_model_swap_deinit(mtb_ml_model_swap_t *swap)
+{
+    if(swap == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    for(uint32_t i = 0; i < MTB_ML_MODEL_SWAP_SLOTS; i++)
+    {
+        if(swap->slot[i].model != NULL)
+        {
+            (void)mtb_ml_model_deinit(swap->slot[i].model);
+        }
+    }
+    memset(swap, 0, sizeof(*swap));
+    return MTB_ML_RESULT_SUCCESS;
+}
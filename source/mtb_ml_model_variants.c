@@ -0,0 +1,268 @@
+/***************************************************************************//**
+* \file mtb_ml_model_variants.c
+*
+* \brief
+* This file contains the run-time selection between quantization variants of a model
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "mtb_ml_common.h"
+#include "mtb_ml_model_variants.h"
+#include "mtb_ml_utils.h"
+
+/*******************************************************************************
+ * Private Functions
+*******************************************************************************/
+static uint64_t variants_tsc(void)
+{
+    uint64_t now = 0;
+    mtb_ml_model_profile_get_tsc(&now);
+    return now;
+}
+
+/* Most accurate variant whose unloaded cost, scaled by the current load, meets the budget */
+static uint32_t variants_select(const mtb_ml_model_variants_t *set)
+{
+    const mtb_ml_model_variants_stats_t *stats = &set->stats;
+    uint32_t active = stats->active;
+    float load = 1.0f;
+
+    if (stats->min_cycles[active] != 0)
+    {
+        load = (float)stats->est_cycles[active] / (float)stats->min_cycles[active];
+    }
+    for (uint32_t i = 0; i < set->count; i++)
+    {
+        /* A more accurate variant must fit with a margin, or the selection would flap */
+        uint64_t limit = (i < active) ? set->budget_cycles - (set->budget_cycles >> 3) : set->budget_cycles;
+
+        if (stats->min_cycles[i] == 0)
+        {
+            /* Not measured yet */
+            return i;
+        }
+        if ((float)stats->min_cycles[i] * load <= (float)limit)
+        {
+            return i;
+        }
+    }
+    return set->count - 1U;
+}
+
+/*******************************************************************************
+ * Public Functions
+*******************************************************************************/
+cy_rslt_t mtb_ml_model_variants_init(mtb_ml_model_variants_t *set, const mtb_ml_model_variant_desc_t *variants,
+                                     uint32_t count, uint64_t budget_cycles)
+{
+    size_t input_bytes = 0;
+    cy_rslt_t result = MTB_ML_RESULT_SUCCESS;
+
+    if (set == NULL || variants == NULL || count == 0 || count > MTB_ML_MODEL_VARIANTS_MAX || budget_cycles == 0)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    memset(set, 0, sizeof(*set));
+    set->budget_cycles = budget_cycles;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        mtb_ml_model_t *model;
+
+        result = mtb_ml_model_init(variants[i].bin, variants[i].buffer, &set->model[i]);
+        if (result != MTB_ML_RESULT_SUCCESS)
+        {
+            break;
+        }
+        set->count = i + 1U;
+        model = set->model[i];
+        if (model->input_size != set->model[0]->input_size || model->output_size != set->model[0]->output_size)
+        {
+            result = MTB_ML_RESULT_INPUT_ERROR;
+            break;
+        }
+#if defined(COMPONENT_ML_INT8x8) || defined(COMPONENT_ML_INT16x8) || defined(COMPONENT_ML_FLOAT32)
+        /* A typed build hands MTB_ML_DATA_T buffers to every variant */
+        if (model->input_type_size != (int)sizeof(MTB_ML_DATA_T) ||
+            model->output_type_size != (int)sizeof(MTB_ML_DATA_T))
+        {
+            result = MTB_ML_RESULT_BAD_ARG;
+            break;
+        }
+#endif
+        if ((size_t)model->input_size * (size_t)model->input_type_size > input_bytes)
+        {
+            input_bytes = (size_t)model->input_size * (size_t)model->input_type_size;
+        }
+        if (model->m_sum_frames != 0)
+        {
+            set->stats.est_cycles[i] = model->m_cpu_sum_cycles / model->m_sum_frames;
+            set->stats.min_cycles[i] = set->stats.est_cycles[i];
+        }
+    }
+    if (result == MTB_ML_RESULT_SUCCESS)
+    {
+        set->input = malloc(input_bytes);
+        if (set->input == NULL)
+        {
+            result = MTB_ML_RESULT_ALLOC_ERR;
+        }
+    }
+    if (result != MTB_ML_RESULT_SUCCESS)
+    {
+        (void)mtb_ml_model_variants_deinit(set);
+    }
+    return result;
+}
+
+cy_rslt_t mtb_ml_model_variants_set_budget(mtb_ml_model_variants_t *set, uint64_t budget_cycles)
+{
+    if (set == NULL || budget_cycles == 0)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    set->budget_cycles = budget_cycles;
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_model_variants_run(mtb_ml_model_variants_t *set, const float *input, mtb_ml_model_t **model)
+{
+    mtb_ml_model_variants_stats_t *stats;
+    mtb_ml_model_t *variant;
+    MTB_ML_DATA_T *variant_input;
+    uint64_t start, cycles;
+    uint32_t next;
+    cy_rslt_t result;
+
+    if (set == NULL || set->count == 0 || input == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    /* Frame boundary, the only place the variant changes */
+    stats = &set->stats;
+    next = variants_select(set);
+    if (next != stats->active && stats->frames != 0)
+    {
+        stats->switches++;
+    }
+    stats->active = next;
+    variant = set->model[next];
+
+    if (variant->input_type_size == sizeof(float))
+    {
+        variant_input = (MTB_ML_DATA_T *)(uintptr_t)input;
+    }
+    else
+    {
+        variant_input = (MTB_ML_DATA_T *)set->input;
+        result = mtb_ml_utils_model_quantize(variant, input, variant_input);
+        if (result != MTB_ML_RESULT_SUCCESS)
+        {
+            return result;
+        }
+    }
+
+    start = variants_tsc();
+    result = mtb_ml_model_run(variant, variant_input);
+    cycles = variants_tsc() - start;
+    if (result != MTB_ML_RESULT_SUCCESS)
+    {
+        return result;
+    }
+
+    if (stats->est_cycles[next] == 0)
+    {
+        stats->est_cycles[next] = cycles;
+    }
+    else
+    {
+        stats->est_cycles[next] = stats->est_cycles[next] - (stats->est_cycles[next] >> MTB_ML_MODEL_VARIANTS_EWMA_SHIFT) +
+                                  (cycles >> MTB_ML_MODEL_VARIANTS_EWMA_SHIFT);
+    }
+    if (stats->min_cycles[next] == 0 || cycles < stats->min_cycles[next])
+    {
+        stats->min_cycles[next] = cycles;
+    }
+    stats->frames++;
+    stats->runs[next]++;
+    if (cycles > set->budget_cycles)
+    {
+        stats->over_budget++;
+    }
+    if (model != NULL)
+    {
+        *model = variant;
+    }
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_model_variants_get_output(const mtb_ml_model_variants_t *set, float *output)
+{
+    if (set == NULL || set->count == 0 || output == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    return mtb_ml_utils_model_dequantize(set->model[set->stats.active], output);
+}
+
+cy_rslt_t mtb_ml_model_variants_get_stats(const mtb_ml_model_variants_t *set, mtb_ml_model_variants_stats_t *stats)
+{
+    if (set == NULL || stats == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    *stats = set->stats;
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_model_variants_deinit(mtb_ml_model_variants_t *set)
+{
+    if (set == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    for (uint32_t i = 0; i < set->count; i++)
+    {
+        (void)mtb_ml_model_deinit(set->model[i]);
+    }
+    free(set->input);
+    memset(set, 0, sizeof(*set));
+    return MTB_ML_RESULT_SUCCESS;
+}
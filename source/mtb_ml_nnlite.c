@@ -41,6 +41,8 @@
 
 #include "cy_pdl.h"
 #include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
 #include "mtb_ml.h"
 #include "cy_nnlite.h"
 #include "cy_nn_kernel.h"
@@ -52,6 +54,13 @@
 
 cy_kernel_config_t cy_kernel_config = {0};
 
+/* Profiling context of the invocation currently owning the NNLite NPU.
+ * Its address is handed to the driver as profArg. */
+static mtb_ml_npu_prof_ctx_t *mtb_ml_nnlite_active_ctx;
+
+static mtb_ml_npu_prof_ctx_t *mtb_ml_nnlite_prof_task_ctx(void);
+static void mtb_ml_nnlite_prof_wake(void);
+
 __WEAK void Cy_NNLite_Lpm_Lock(void) {
     /* To be substituted at application level */
 }
@@ -74,6 +83,68 @@ __WEAK void Cy_NNLite_Lpm_Unlock(void) {
 cy_mutex_t nnliteMutex;
 cy_semaphore_t nnliteSem;
 
+#ifndef MTB_ML_NPU_PROF_MAX_TASKS
+/* Maximum number of tasks running NNLite models concurrently with profiling */
+#define MTB_ML_NPU_PROF_MAX_TASKS   (4)
+#endif
+
+/* Profiling contexts bound by the tasks running a model */
+static struct
+{
+    cy_thread_t thread;
+    mtb_ml_npu_prof_ctx_t *ctx;
+} mtb_ml_nnlite_prof_bindings[MTB_ML_NPU_PROF_MAX_TASKS];
+
+/* Returns the profiling context bound by the calling task */
+static mtb_ml_npu_prof_ctx_t *mtb_ml_nnlite_prof_task_ctx(void)
+{
+    cy_thread_t thread;
+    if (cy_rtos_thread_get_handle(&thread) != CY_RSLT_SUCCESS)
+    {
+        return NULL;
+    }
+    for (uint32_t i = 0; i < MTB_ML_NPU_PROF_MAX_TASKS; i++)
+    {
+        if (mtb_ml_nnlite_prof_bindings[i].thread == thread)
+        {
+            return mtb_ml_nnlite_prof_bindings[i].ctx;
+        }
+    }
+    return NULL;
+}
+
+void mtb_ml_nnlite_prof_bind(mtb_ml_npu_prof_ctx_t *ctx)
+{
+    cy_thread_t thread;
+    uint32_t free_slot = MTB_ML_NPU_PROF_MAX_TASKS;
+
+    if (cy_rtos_thread_get_handle(&thread) != CY_RSLT_SUCCESS)
+    {
+        return;
+    }
+
+    uint32_t intr_state = Cy_SysLib_EnterCriticalSection();
+    for (uint32_t i = 0; i < MTB_ML_NPU_PROF_MAX_TASKS; i++)
+    {
+        if (mtb_ml_nnlite_prof_bindings[i].thread == thread)
+        {
+            free_slot = i;
+            break;
+        }
+        if ((free_slot == MTB_ML_NPU_PROF_MAX_TASKS) && (mtb_ml_nnlite_prof_bindings[i].ctx == NULL))
+        {
+            free_slot = i;
+        }
+    }
+    if (free_slot < MTB_ML_NPU_PROF_MAX_TASKS)
+    {
+        /* Unbinding keeps the thread handle, so the slot is reused by the same task */
+        mtb_ml_nnlite_prof_bindings[free_slot].thread = thread;
+        mtb_ml_nnlite_prof_bindings[free_slot].ctx = ctx;
+    }
+    Cy_SysLib_ExitCriticalSection(intr_state);
+}
+
 /**
  * \brief : Initialize mutex using API of RTOS abstraction.
  *
@@ -99,6 +170,12 @@ uint32_t Cy_NNLite_Mutex_Lock(void *mutex)
 {
     cy_mutex_t *handle = (cy_mutex_t *)mutex;
     cy_rslt_t res = cy_rtos_get_mutex(handle, ML_NPU_MUTEX_TIMEOUT);
+    if (res == CY_RSLT_SUCCESS)
+    {
+        /* The driver mutex serializes NNLite kernels, so the owner of the
+         * mutex is the only invocation the profiling callbacks can refer to */
+        mtb_ml_nnlite_active_ctx = mtb_ml_nnlite_prof_task_ctx();
+    }
     return (uint32_t)res;
 }
 
@@ -112,6 +189,7 @@ uint32_t Cy_NNLite_Mutex_Lock(void *mutex)
 uint32_t Cy_NNLite_Mutex_Unlock(void *mutex)
 {
     cy_mutex_t *handle = (cy_mutex_t *)mutex;
+    mtb_ml_nnlite_active_ctx = NULL;
     cy_rslt_t res = cy_rtos_set_mutex(handle);
     return (uint32_t)res;
 }
@@ -163,6 +241,10 @@ uint32_t Cy_NNLite_Sem_Wait(void *sem)
     else
     {
         res = cy_rtos_get_semaphore(handle, ML_NPU_SEMAPHORE_TIMEOUT, false);
+        if (res == CY_RSLT_SUCCESS)
+        {
+            mtb_ml_nnlite_prof_wake();
+        }
     }
     return (uint32_t)res;
 }
@@ -195,8 +277,111 @@ uint32_t Cy_NNLite_Sem_Delete(void *sem)
     return (uint32_t)res;
 }
 
+/* The NPU completion is awaited on the RTOS semaphore, wait modes apply to bare-metal only */
+void mtb_ml_set_nnlite_wait_mode(uint32_t mode)
+{
+    (void)mode;
+}
+
+uint32_t mtb_ml_get_nnlite_wait_mode(void)
+{
+    return MTB_ML_NNLITE_WAIT_SPIN;
+}
+
+void mtb_ml_set_nnlite_wait_callback(mtb_ml_nnlite_wait_cb_t callback, void *arg)
+{
+    (void)callback;
+    (void)arg;
+}
+
+void mtb_ml_nnlite_wait_account(uint64_t npu_cycles)
+{
+    (void)npu_cycles;
+}
+
+void mtb_ml_nnlite_wait_log(void)
+{
+}
+
 #else /* defined(CY_RTOS_AWARE) */
 static volatile uint32_t cy_kernel_operation_progress = 1;
+static uint32_t mtb_ml_nnlite_wait_mode = MTB_ML_NNLITE_WAIT_MODE;
+/* Wait used for the current frame, differs from the mode in benchmark mode */
+static uint32_t mtb_ml_nnlite_wait_current = MTB_ML_NNLITE_WAIT_MODE;
+static mtb_ml_nnlite_wait_cb_t mtb_ml_nnlite_wait_cb = NULL;
+static void *mtb_ml_nnlite_wait_cb_arg = NULL;
+
+/* NPU cycles per wait (SPIN, WFE, CALLBACK) */
+static struct
+{
+    uint32_t frames;
+    uint64_t npu_cycles;
+} mtb_ml_nnlite_wait_stats[MTB_ML_NNLITE_WAIT_BENCHMARK];
+
+static const char *const mtb_ml_nnlite_wait_names[MTB_ML_NNLITE_WAIT_BENCHMARK] =
+{
+    "spin", "wfe", "callback"
+};
+
+void mtb_ml_set_nnlite_wait_mode(uint32_t mode)
+{
+    if (mode > MTB_ML_NNLITE_WAIT_BENCHMARK)
+    {
+        return;
+    }
+    mtb_ml_nnlite_wait_mode = mode;
+    mtb_ml_nnlite_wait_current = (mode == MTB_ML_NNLITE_WAIT_BENCHMARK) ? MTB_ML_NNLITE_WAIT_SPIN : mode;
+    memset(mtb_ml_nnlite_wait_stats, 0, sizeof(mtb_ml_nnlite_wait_stats));
+}
+
+uint32_t mtb_ml_get_nnlite_wait_mode(void)
+{
+    return mtb_ml_nnlite_wait_mode;
+}
+
+void mtb_ml_set_nnlite_wait_callback(mtb_ml_nnlite_wait_cb_t callback, void *arg)
+{
+    mtb_ml_nnlite_wait_cb = callback;
+    mtb_ml_nnlite_wait_cb_arg = arg;
+}
+
+/* Called once per profiled frame with its NPU cycles */
+void mtb_ml_nnlite_wait_account(uint64_t npu_cycles)
+{
+    mtb_ml_nnlite_wait_stats[mtb_ml_nnlite_wait_current].frames++;
+    mtb_ml_nnlite_wait_stats[mtb_ml_nnlite_wait_current].npu_cycles += npu_cycles;
+
+    if (mtb_ml_nnlite_wait_mode == MTB_ML_NNLITE_WAIT_BENCHMARK)
+    {
+        mtb_ml_nnlite_wait_current = (mtb_ml_nnlite_wait_current == MTB_ML_NNLITE_WAIT_SPIN) ?
+                                     MTB_ML_NNLITE_WAIT_WFE : MTB_ML_NNLITE_WAIT_SPIN;
+    }
+}
+
+void mtb_ml_nnlite_wait_log(void)
+{
+    for (uint32_t i = 0; i < MTB_ML_NNLITE_WAIT_BENCHMARK; i++)
+    {
+        if (mtb_ml_nnlite_wait_stats[i].frames != 0)
+        {
+            printf("PROFILE_INFO, MTB ML NNLite wait, mode=%-8s, avg_npu_cyc=%-10.2f, frames=%-" PRIu32 "\r\n",
+                    mtb_ml_nnlite_wait_names[i],
+                    (float)mtb_ml_nnlite_wait_stats[i].npu_cycles / mtb_ml_nnlite_wait_stats[i].frames,
+                    mtb_ml_nnlite_wait_stats[i].frames);
+        }
+    }
+}
+
+void mtb_ml_nnlite_prof_bind(mtb_ml_npu_prof_ctx_t *ctx)
+{
+    /* Single thread of execution, the bound invocation owns the NPU */
+    mtb_ml_nnlite_active_ctx = ctx;
+}
+
+static mtb_ml_npu_prof_ctx_t *mtb_ml_nnlite_prof_task_ctx(void)
+{
+    return mtb_ml_nnlite_active_ctx;
+}
 /**
  * \brief   : Create mutex and return handle using API of RTOS abstraction.
  *
@@ -257,9 +442,32 @@ uint32_t Cy_NNLite_Sem_Wait(void *sem)
     (void)sem;
     /* volatile flag signalling NPU has done its work
     * cleared from ISR */
-    do {
-    } while(cy_kernel_operation_progress);
+    switch (mtb_ml_nnlite_wait_current)
+    {
+        case MTB_ML_NNLITE_WAIT_WFE:
+            /* Keep the CPU off the memory bus the NPU is using. SEV from the
+             * ISR makes WFE return even if the flag was cleared before it */
+            while (cy_kernel_operation_progress)
+            {
+                __WFE();
+            }
+            break;
+        case MTB_ML_NNLITE_WAIT_CALLBACK:
+            while (cy_kernel_operation_progress)
+            {
+                if (mtb_ml_nnlite_wait_cb != NULL)
+                {
+                    mtb_ml_nnlite_wait_cb(mtb_ml_nnlite_wait_cb_arg);
+                }
+            }
+            break;
+        default:
+            do {
+            } while(cy_kernel_operation_progress);
+            break;
+    }
     cy_kernel_operation_progress = 1;
+    mtb_ml_nnlite_prof_wake();
     return CY_NNLITE_SUCCESS;
 }
 /**
@@ -273,6 +481,8 @@ uint32_t Cy_NNLite_Sem_Give(void *sem)
     /* signalling with volatile flag that NPU is done
     * Cy_NNLite_Sem_Give() is called from ISR */
     cy_kernel_operation_progress = 0;
+    /* Wake up Cy_NNLite_Sem_Wait() sleeping in WFE */
+    __SEV();
     return CY_NNLITE_SUCCESS;
 }
 /**
@@ -287,33 +497,187 @@ uint32_t Cy_NNLite_Sem_Delete(void *sem)
 }
 #endif  /* defined(CY_RTOS_AWARE) */
 
-/* NNLite NPU-related cycles count */
-static uint64_t mtb_ml_nnlite_frame_start;
-extern uint64_t mtb_ml_npu_cycles;
+/* Called in task context once the NPU completion was signalled */
+static void mtb_ml_nnlite_prof_wake(void)
+{
+    mtb_ml_npu_prof_ctx_t *ctx = mtb_ml_nnlite_prof_task_ctx();
+    uint64_t now;
 
-void mtb_ml_nnlite_nop(void *ptr) {
-  (void)ptr;
+    if ((ctx == NULL) || (ctx->kernels == NULL) || (ctx->accel_done == 0))
+    {
+        return;
+    }
+    mtb_ml_model_profile_get_tsc(&now);
+    ctx->current.wait_cycles += (uint32_t)(now - ctx->accel_done);
+    ctx->accel_done = 0;
+}
+
+/* Kernel entry, profStart callback */
+void mtb_ml_nnlite_prof_start(void *ptr)
+{
+    (void)ptr;
+    mtb_ml_npu_prof_ctx_t *ctx = mtb_ml_nnlite_prof_task_ctx();
+
+    if ((ctx == NULL) || (ctx->kernels == NULL))
+    {
+        return;
+    }
+    memset(&ctx->current, 0, sizeof(ctx->current));
+    ctx->current.kernel_type = ctx->op_tag;
+#if defined(COMPONENT_ML_TFLM_LESS)
+    /* No interpreter tags the operators, number the kernels of the frame instead */
+    ctx->current.op_index = ctx->op_seq++;
+#else
+    ctx->current.op_index = ctx->op_index;
+#endif
+    ctx->current.frame = ctx->frame;
+    ctx->accel_done = 0;
+    mtb_ml_model_profile_get_tsc(&ctx->current.start);
+}
+
+/* Kernel exit, profStop callback. Commits the record into the ring */
+void mtb_ml_nnlite_prof_stop(void *ptr)
+{
+    (void)ptr;
+    mtb_ml_npu_prof_ctx_t *ctx = mtb_ml_nnlite_prof_task_ctx();
+    uint64_t now;
+
+    if ((ctx == NULL) || (ctx->kernels == NULL))
+    {
+        return;
+    }
+    mtb_ml_model_profile_get_tsc(&now);
+    ctx->current.total_cycles = (uint32_t)(now - ctx->current.start);
+    ctx->kernels[ctx->kernel_count % MTB_ML_NNLITE_PROF_RING_SIZE] = ctx->current;
+    ctx->kernel_count++;
 }
 
 /* This one stores _Start() point and accumulate total NPU time */
 void mtb_ml_nnlite_prof_get(void *ptr, uint32_t profilePoint)
 {
-  (void)ptr;
+  /* ptr is profArg : the location of the active invocation context */
+  mtb_ml_npu_prof_ctx_t *ctx = *(mtb_ml_npu_prof_ctx_t **)ptr;
   uint64_t nnlite_prof_tmp;
+
+  if (ctx == NULL)
+  {
+      return;
+  }
   /* pre-Start() */
   if (profilePoint == CY_NNLITE_PP_ACCELERATOR_START)
   {
-      mtb_ml_model_profile_get_tsc((uint64_t *)&mtb_ml_nnlite_frame_start);
+      mtb_ml_model_profile_get_tsc(&ctx->frame_start);
   }
   /* NNLITE ISR */
   else if (profilePoint == CY_NNLITE_PP_ACCELERATOR_DONE)
   {
-      mtb_ml_model_profile_get_tsc((uint64_t *)&nnlite_prof_tmp);
+      mtb_ml_model_profile_get_tsc(&nnlite_prof_tmp);
       /* accumulate pure NPU time in case kernel is composite - SoftMax/LayerNorm/etc */
-      mtb_ml_npu_cycles += (nnlite_prof_tmp - mtb_ml_nnlite_frame_start);
+      ctx->npu_cycles += (nnlite_prof_tmp - ctx->frame_start);
+      if (ctx->kernels != NULL)
+      {
+          ctx->current.accel_cycles += (uint32_t)(nnlite_prof_tmp - ctx->frame_start);
+          ctx->current.accel_passes++;
+          ctx->accel_done = nnlite_prof_tmp;
+      }
   }
 }
 
+cy_rslt_t mtb_ml_nnlite_prof_kernels_enable(mtb_ml_npu_prof_ctx_t *ctx, bool enable)
+{
+    if (ctx == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    if (enable && (ctx->kernels == NULL))
+    {
+        ctx->kernels = (mtb_ml_nnlite_kernel_record_t *)calloc(MTB_ML_NNLITE_PROF_RING_SIZE,
+                                                               sizeof(mtb_ml_nnlite_kernel_record_t));
+        if (ctx->kernels == NULL)
+        {
+            return MTB_ML_RESULT_ALLOC_ERR;
+        }
+    }
+    else if (!enable && (ctx->kernels != NULL))
+    {
+        free(ctx->kernels);
+        ctx->kernels = NULL;
+    }
+    ctx->kernel_count = 0;
+    ctx->frame = 0;
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_nnlite_prof_kernels_log(const mtb_ml_npu_prof_ctx_t *ctx)
+{
+    if ((ctx == NULL) || (ctx->kernels == NULL))
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    uint32_t count = (ctx->kernel_count < MTB_ML_NNLITE_PROF_RING_SIZE) ?
+                     ctx->kernel_count : MTB_ML_NNLITE_PROF_RING_SIZE;
+    uint64_t sum_accel = 0;
+    uint64_t sum_wait = 0;
+    uint64_t sum_total = 0;
+
+    /* Summarize the records kept in the ring per operator, in ring order */
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const mtb_ml_nnlite_kernel_record_t *rec = &ctx->kernels[i];
+        bool reported = false;
+
+        sum_accel += rec->accel_cycles;
+        sum_wait += rec->wait_cycles;
+        sum_total += rec->total_cycles;
+
+        for (uint32_t j = 0; j < i; j++)
+        {
+            if (ctx->kernels[j].op_index == rec->op_index)
+            {
+                reported = true;
+                break;
+            }
+        }
+        if (reported)
+        {
+            continue;
+        }
+
+        uint32_t n = 0;
+        uint32_t passes = 0;
+        uint64_t accel = 0;
+        uint64_t wait = 0;
+        uint64_t total = 0;
+        for (uint32_t j = i; j < count; j++)
+        {
+            if (ctx->kernels[j].op_index == rec->op_index)
+            {
+                n++;
+                passes += ctx->kernels[j].accel_passes;
+                accel += ctx->kernels[j].accel_cycles;
+                wait += ctx->kernels[j].wait_cycles;
+                total += ctx->kernels[j].total_cycles;
+            }
+        }
+        printf("PROFILE_INFO, MTB ML NNLite kernel, op=%-4u, type=%-20s, passes=%-6.2f, avg_accel_cyc=%-10.2f, avg_wait_cyc=%-10.2f, avg_cpu_cyc=%-10.2f, records=%-" PRIu32 "\r\n",
+                (unsigned)rec->op_index,
+                (rec->kernel_type != NULL) ? rec->kernel_type : "UNKNOWN",
+                (float)passes / n,
+                (float)accel / n,
+                (float)wait / n,
+                (float)(total - accel - wait) / n,
+                n);
+    }
+
+    printf("PROFILE_INFO, MTB ML NNLite kernels, accel_cyc=%.0f, wait_cyc=%.0f, cpu_cyc=%.0f, records=%-" PRIu32 "\r\n",
+            (float)sum_accel,
+            (float)sum_wait,
+            (float)(sum_total - sum_accel - sum_wait),
+            count);
+    return MTB_ML_RESULT_SUCCESS;
+}
+
 /**
  * \brief : Initializes NNLite Driver SW stack and HW
  *
@@ -341,10 +705,10 @@ cy_rslt_t mtb_ml_nnlite_init(uint32_t priority)
     cy_kernel_config.SemGiveFunc        = Cy_NNLite_Sem_Give;
     cy_kernel_config.LpmLockFunc        = Cy_NNLite_Lpm_Lock;
     cy_kernel_config.LpmUnlockFunc      = Cy_NNLite_Lpm_Unlock;
-    cy_kernel_config.profStart          = mtb_ml_nnlite_nop;
-    cy_kernel_config.profStop           = mtb_ml_nnlite_nop;
+    cy_kernel_config.profStart          = mtb_ml_nnlite_prof_start;
+    cy_kernel_config.profStop           = mtb_ml_nnlite_prof_stop;
     cy_kernel_config.profGetCount       = mtb_ml_nnlite_prof_get;
-    cy_kernel_config.profArg            = NULL;
+    cy_kernel_config.profArg            = (void *)&mtb_ml_nnlite_active_ctx;
     if (Cy_NNLite_KernelInit(&cy_kernel_config) != CY_NNLITE_SUCCESS)
     {
         printf("Failed to initialize MXNNLITE driver");
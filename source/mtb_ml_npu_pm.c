@@ -0,0 +1,221 @@
+/***************************************************************************//**
+* \file mtb_ml_npu_pm.c
+*
+* \brief
+* The file contains application programming interface to the ModusToolbox ML
+* middleware NPU power manager
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+#include "mtb_ml_npu_pm.h"
+
+/******************************************************************************
+ * Static functions
+******************************************************************************/
+static void mtb_ml_npu_pm_lock(const mtb_ml_npu_pm_t *pm)
+{
+    if (pm->ops->lock != NULL)
+    {
+        pm->ops->lock(pm->ops->arg);
+    }
+}
+
+static void mtb_ml_npu_pm_unlock(const mtb_ml_npu_pm_t *pm)
+{
+    if (pm->ops->unlock != NULL)
+    {
+        pm->ops->unlock(pm->ops->arg);
+    }
+}
+
+static uint64_t mtb_ml_npu_pm_cycles(const mtb_ml_npu_pm_t *pm)
+{
+    return (pm->ops->get_cycles != NULL) ? pm->ops->get_cycles(pm->ops->arg) : 0;
+}
+
+/*******************************************************************************
+ * Public Functions
+*******************************************************************************/
+cy_rslt_t mtb_ml_npu_pm_init(mtb_ml_npu_pm_t *pm, const mtb_ml_npu_pm_ops_t *ops, uint32_t idle_timeout_ms)
+{
+    if ((pm == NULL) || (ops == NULL) || (ops->power_on == NULL) || (ops->power_off == NULL))
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    pm->ops = ops;
+    pm->state = MTB_ML_NPU_PM_IDLE;
+    pm->idle_timeout_ms = idle_timeout_ms;
+    pm->users = 0;
+    pm->idle_since_ms = (ops->get_time_ms != NULL) ? ops->get_time_ms(ops->arg) : 0;
+    pm->stats = (mtb_ml_npu_pm_stats_t){0};
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+void mtb_ml_npu_pm_set_idle_timeout(mtb_ml_npu_pm_t *pm, uint32_t idle_timeout_ms)
+{
+    if ((pm != NULL) && (pm->ops != NULL))
+    {
+        mtb_ml_npu_pm_lock(pm);
+        pm->idle_timeout_ms = idle_timeout_ms;
+        mtb_ml_npu_pm_unlock(pm);
+    }
+}
+
+cy_rslt_t mtb_ml_npu_pm_acquire(mtb_ml_npu_pm_t *pm)
+{
+    cy_rslt_t result = MTB_ML_RESULT_SUCCESS;
+
+    if ((pm == NULL) || (pm->ops == NULL))
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    mtb_ml_npu_pm_lock(pm);
+    if (pm->state == MTB_ML_NPU_PM_OFF)
+    {
+        uint64_t start = mtb_ml_npu_pm_cycles(pm);
+        result = pm->ops->power_on(pm->ops->arg);
+        if (result == MTB_ML_RESULT_SUCCESS)
+        {
+            uint64_t latency = mtb_ml_npu_pm_cycles(pm) - start;
+            pm->stats.wake_count++;
+            pm->stats.last_wake_cycles = latency;
+            pm->stats.sum_wake_cycles += latency;
+            if (latency > pm->stats.max_wake_cycles)
+            {
+                pm->stats.max_wake_cycles = latency;
+            }
+        }
+        else
+        {
+            result = MTB_ML_RESULT_NPU_INIT_ERROR;
+        }
+    }
+    if (result == MTB_ML_RESULT_SUCCESS)
+    {
+        pm->users++;
+        pm->state = MTB_ML_NPU_PM_ACTIVE;
+    }
+    mtb_ml_npu_pm_unlock(pm);
+    return result;
+}
+
+void mtb_ml_npu_pm_release(mtb_ml_npu_pm_t *pm)
+{
+    if ((pm == NULL) || (pm->ops == NULL))
+    {
+        return;
+    }
+
+    mtb_ml_npu_pm_lock(pm);
+    if (pm->users > 0)
+    {
+        pm->users--;
+        if (pm->users == 0)
+        {
+            pm->state = MTB_ML_NPU_PM_IDLE;
+            pm->idle_since_ms = (pm->ops->get_time_ms != NULL) ? pm->ops->get_time_ms(pm->ops->arg) : 0;
+        }
+    }
+    mtb_ml_npu_pm_unlock(pm);
+}
+
+bool mtb_ml_npu_pm_process(mtb_ml_npu_pm_t *pm, uint32_t *idle_left_ms)
+{
+    bool powered_off = false;
+
+    if (idle_left_ms != NULL)
+    {
+        *idle_left_ms = 0;
+    }
+    if ((pm == NULL) || (pm->ops == NULL) || (pm->ops->get_time_ms == NULL))
+    {
+        return false;
+    }
+
+    if (pm->ops->try_lock != NULL)
+    {
+        /* Held by an acquire or release in progress, which restarts the idle period anyway */
+        if (!pm->ops->try_lock(pm->ops->arg))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        mtb_ml_npu_pm_lock(pm);
+    }
+    if ((pm->state == MTB_ML_NPU_PM_IDLE) && (pm->idle_timeout_ms != MTB_ML_NPU_PM_ALWAYS_ON))
+    {
+        /* Unsigned difference stays valid across time base wrap */
+        uint32_t idle_ms = pm->ops->get_time_ms(pm->ops->arg) - pm->idle_since_ms;
+        if (idle_ms >= pm->idle_timeout_ms)
+        {
+            pm->ops->power_off(pm->ops->arg);
+            pm->state = MTB_ML_NPU_PM_OFF;
+            pm->stats.off_count++;
+            powered_off = true;
+        }
+        else if (idle_left_ms != NULL)
+        {
+            *idle_left_ms = pm->idle_timeout_ms - idle_ms;
+        }
+    }
+    mtb_ml_npu_pm_unlock(pm);
+    return powered_off;
+}
+
+cy_rslt_t mtb_ml_npu_pm_suspend(mtb_ml_npu_pm_t *pm)
+{
+    cy_rslt_t result = MTB_ML_RESULT_SUCCESS;
+
+    if ((pm == NULL) || (pm->ops == NULL))
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    mtb_ml_npu_pm_lock(pm);
+    if (pm->state == MTB_ML_NPU_PM_ACTIVE)
+    {
+        result = MTB_ML_RESULT_BAD_ARG;
+    }
+    else if (pm->state == MTB_ML_NPU_PM_IDLE)
+    {
+        pm->ops->power_off(pm->ops->arg);
+        pm->state = MTB_ML_NPU_PM_OFF;
+        pm->stats.off_count++;
+    }
+    mtb_ml_npu_pm_unlock(pm);
+    return result;
+}
@@ -0,0 +1,294 @@
+/***************************************************************************//**
+* \file mtb_ml_regression.c
+*
+* \brief
+* This file contains the regression evaluation of ML models against reference outputs
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <inttypes.h>
+#include "mtb_ml_common.h"
+#include "mtb_ml_regression.h"
+
+/*******************************************************************************
+ * Private Functions
+*******************************************************************************/
+/* Value i of an array of type_size elements, int8/int16 quantized or float */
+static float regression_value(const void *data, int type_size, uint32_t i)
+{
+    switch(type_size)
+    {
+        case sizeof(int8_t):
+            return (float)((const int8_t *)data)[i];
+        case sizeof(int16_t):
+            return (float)((const int16_t *)data)[i];
+        default:
+            return ((const float *)data)[i];
+    }
+}
+
+/* Element size of the reference outputs, taken from their type rather than from the model */
+static int regression_type_size(mtb_ml_x_data_type_t type)
+{
+    switch(type)
+    {
+        case MTB_ML_X_DATA_INT8:
+            return (int)sizeof(int8_t);
+        case MTB_ML_X_DATA_INT16:
+            return (int)sizeof(int16_t);
+        default:
+            return (int)sizeof(float);
+    }
+}
+
+static float regression_dequantize(const mtb_ml_model_t *model, float value)
+{
+    if(model->output_type_size == sizeof(float))
+    {
+        return value;
+    }
+    return (value - (float)model->output_zero_point) * model->output_scale;
+}
+
+/* Compares the model output with one reference */
+static void regression_compare(mtb_ml_regression_t *ctx, const void *ref)
+{
+    const mtb_ml_model_t *model = ctx->model;
+    int ref_type_size = regression_type_size(ctx->y_type);
+    uint32_t out_max = 0, ref_max = 0;
+    float out_max_val = 0.0f, ref_max_val = 0.0f;
+
+    for(uint32_t i = 0; i < (uint32_t)model->output_size; i++)
+    {
+        float out = regression_dequantize(model, regression_value(model->output, model->output_type_size, i));
+        float expected = regression_value(ref, ref_type_size, i);
+        float error;
+
+        if(ctx->y_type != MTB_ML_X_DATA_FLOAT32)
+        {
+            expected = regression_dequantize(model, expected);
+        }
+        error = fabsf(out - expected);
+        ctx->abs_error_sum += error;
+        if(error > ctx->summary.max_abs_error)
+        {
+            ctx->summary.max_abs_error = error;
+            ctx->summary.max_error_sample = ctx->summary.samples;
+        }
+
+        /* Top-1, the first of equal values wins as in mtb_ml_utils_find_max() */
+        if((i == 0) || (out > out_max_val))
+        {
+            out_max = i;
+            out_max_val = out;
+        }
+        if((i == 0) || (expected > ref_max_val))
+        {
+            ref_max = i;
+            ref_max_val = expected;
+        }
+    }
+    ctx->outputs += (uint64_t)model->output_size;
+    if(out_max == ref_max)
+    {
+        ctx->summary.correct++;
+    }
+    ctx->summary.samples++;
+}
+
+/*******************************************************************************
+ * Public Functions
+*******************************************************************************/
+cy_rslt_t mtb_ml_regression_init(mtb_ml_regression_t *ctx, mtb_ml_model_t *model, mtb_ml_x_data_type_t y_type)
+{
+    if((ctx == NULL) || (model == NULL) || (model->output_size <= 0))
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    if((y_type != MTB_ML_X_DATA_FLOAT32) && (y_type != MTB_ML_X_DATA_INT8) && (y_type != MTB_ML_X_DATA_INT16))
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    /* Quantized references are compared in the model output quantization */
+    if((y_type != MTB_ML_X_DATA_FLOAT32) && (regression_type_size(y_type) != model->output_type_size))
+    {
+        printf("ERROR: Reference data size (%d) does not match model output size (%d).\r\n",
+               regression_type_size(y_type), model->output_type_size);
+        return MTB_ML_RESULT_MISMATCH_DATA_TYPE;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->model = model;
+    ctx->y_type = y_type;
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_regression_add(mtb_ml_regression_t *ctx, const mtb_ml_x_file_header_t *x_info,
+                                const void *x_samples, const void *y_samples, uint32_t count)
+{
+    mtb_ml_model_t *model;
+    int ref_type_size;
+    uint32_t slices;
+    size_t slice_bytes;
+    uint64_t start = 0, end = 0;
+    cy_rslt_t result;
+
+    if((ctx == NULL) || (ctx->model == NULL) || (x_info == NULL) || (x_samples == NULL) || (y_samples == NULL))
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    model = ctx->model;
+    ref_type_size = regression_type_size(ctx->y_type);
+
+    /* Streaming RNN samples are run one time step slice at a time */
+    slices = (x_info->recurrent_ts_size > 1) ? (uint32_t)x_info->recurrent_ts_size : 1;
+    if((x_info->input_size <= 0) || ((uint32_t)x_info->input_size % slices != 0) ||
+       ((uint32_t)x_info->input_size / slices != (uint32_t)model->input_size))
+    {
+        printf("ERROR: regression input size (%d) does not match model input size (%d)\r\n",
+               (int)x_info->input_size, model->input_size);
+        return MTB_ML_RESULT_INPUT_ERROR;
+    }
+    slice_bytes = (size_t)model->input_size * (size_t)model->input_type_size;
+
+    for(uint32_t s = 0; s < count; s++)
+    {
+        const uint8_t *x = (const uint8_t *)x_samples + (size_t)s * slices * slice_bytes;
+
+        if(slices > 1)
+        {
+            result = mtb_ml_model_rnn_reset_all_parameters(model);
+            if(result != MTB_ML_RESULT_SUCCESS)
+            {
+                return result;
+            }
+        }
+        for(uint32_t t = 0; t < slices; t++)
+        {
+            mtb_ml_model_profile_get_tsc(&start);
+            result = mtb_ml_model_run(model, (MTB_ML_DATA_T *)(x + t * slice_bytes));
+            mtb_ml_model_profile_get_tsc(&end);
+            if(result != MTB_ML_RESULT_SUCCESS)
+            {
+                return result;
+            }
+            ctx->summary.infer_cycles += end - start;
+        }
+        regression_compare(ctx, (const uint8_t *)y_samples + (size_t)s * model->output_size * ref_type_size);
+    }
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_regression_get_summary(const mtb_ml_regression_t *ctx, mtb_ml_regression_summary_t *summary)
+{
+    if((ctx == NULL) || (summary == NULL))
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    *summary = ctx->summary;
+    summary->accuracy = (summary->samples > 0) ? (float)summary->correct / (float)summary->samples : 0.0f;
+    summary->mean_abs_error = (ctx->outputs > 0) ? (float)(ctx->abs_error_sum / (double)ctx->outputs) : 0.0f;
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_regression_run_dataset(mtb_ml_model_t *model, mtb_ml_dataset_t *dataset,
+                                        mtb_ml_regression_summary_t *summary)
+{
+    mtb_ml_regression_t ctx;
+    cy_rslt_t result;
+
+    if((dataset == NULL) || (dataset->y_samples == NULL) || (summary == NULL))
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    result = mtb_ml_dataset_validate(dataset, model);
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        return result;
+    }
+    result = mtb_ml_regression_init(&ctx, model, dataset->y_type);
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        return result;
+    }
+
+    result = mtb_ml_regression_add(&ctx, dataset->x_header, dataset->x_samples, dataset->y_samples, dataset->num_samples);
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        return result;
+    }
+    return mtb_ml_regression_get_summary(&ctx, summary);
+}
+
+cy_rslt_t mtb_ml_regression_run(mtb_ml_model_t *model, const void *x_data, size_t x_size,
+                                const void *y_data, size_t y_size, mtb_ml_x_data_type_t y_type,
+                                mtb_ml_regression_summary_t *summary)
+{
+    mtb_ml_dataset_t dataset;
+    cy_rslt_t result;
+
+    if((model == NULL) || (y_data == NULL))
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    result = mtb_ml_dataset_open(&dataset, x_data, x_size, y_data, y_size);
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        return result;
+    }
+
+    /* y_type applies to reference results without header */
+    if(dataset.y_type == MTB_ML_X_DATA_UNKNOWN)
+    {
+        dataset.y_type = y_type;
+        dataset.output_size = model->output_size;
+    }
+    return mtb_ml_regression_run_dataset(model, &dataset, summary);
+}
+
+cy_rslt_t mtb_ml_regression_log(const mtb_ml_regression_summary_t *summary)
+{
+    if(summary == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    printf("REGRESSION_INFO, samples=%-8" PRIu32 ", accuracy=%-8.4f, max_abs_error=%-10.6f, mean_abs_error=%-10.6f, max_error_sample=%-8" PRIu32 ", infer_cycles=%" PRIu64 "\r\n",
+           summary->samples, summary->accuracy, summary->max_abs_error, summary->mean_abs_error,
+           summary->max_error_sample, summary->infer_cycles);
+    return MTB_ML_RESULT_SUCCESS;
+}
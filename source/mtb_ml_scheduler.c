@@ -0,0 +1,268 @@
+/***************************************************************************//**
+* \file mtb_ml_scheduler.c
+*
+* \brief
+* This file contains the deadline-aware frame scheduler of ML models
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include "mtb_ml_common.h"
+#include "mtb_ml_scheduler.h"
+
+/*******************************************************************************
+ * Private Functions
+*******************************************************************************/
+static uint64_t scheduler_tsc(void)
+{
+    uint64_t now = 0;
+    mtb_ml_model_profile_get_tsc(&now);
+    return now;
+}
+
+/* Average latency of the profiled inferences, 0 if the model was not profiled */
+static uint64_t scheduler_profiled_cycles(const mtb_ml_model_t *model)
+{
+    if (model == NULL || model->m_sum_frames == 0)
+    {
+        return 0;
+    }
+    return model->m_cpu_sum_cycles / model->m_sum_frames;
+}
+
+static void scheduler_update_estimate(uint64_t *est, uint64_t cycles)
+{
+    if (*est == 0)
+    {
+        *est = cycles;
+    }
+    else
+    {
+        *est = *est - (*est >> MTB_ML_SCHEDULER_EWMA_SHIFT) + (cycles >> MTB_ML_SCHEDULER_EWMA_SHIFT);
+    }
+}
+
+/* A model skipped for its estimate is never measured again, so that one latency spike would keep
+ * it out for good. Its estimate decays toward the fastest latency seen until it is tried again. */
+static void scheduler_decay_estimate(uint64_t *est, uint64_t min_cycles)
+{
+    if (*est > min_cycles)
+    {
+        *est -= (*est - min_cycles + (1U << MTB_ML_SCHEDULER_EWMA_SHIFT) - 1U) >> MTB_ML_SCHEDULER_EWMA_SHIFT;
+    }
+}
+
+static void scheduler_overload(mtb_ml_scheduler_t *sched)
+{
+    sched->in_time = 0;
+    if (sched->stats.decimation < sched->config.max_decimation)
+    {
+        sched->stats.decimation *= 2U;
+        if (sched->stats.decimation > sched->config.max_decimation)
+        {
+            sched->stats.decimation = sched->config.max_decimation;
+        }
+    }
+}
+
+static void scheduler_in_time(mtb_ml_scheduler_t *sched)
+{
+    if (sched->stats.decimation > 1U && ++sched->in_time >= sched->config.recover_frames)
+    {
+        sched->stats.decimation /= 2U;
+        sched->in_time = 0;
+    }
+}
+
+/*******************************************************************************
+ * Public Functions
+*******************************************************************************/
+cy_rslt_t mtb_ml_scheduler_init(mtb_ml_scheduler_t *sched, mtb_ml_model_t *model,
+                                const mtb_ml_scheduler_config_t *config)
+{
+    if (sched == NULL || model == NULL || config == NULL || config->deadline_cycles == 0)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    /* The fallback model runs on the input buffer of the primary model */
+    if (config->fallback != NULL &&
+        (config->fallback->input_size != model->input_size ||
+         config->fallback->input_type_size != model->input_type_size))
+    {
+        return MTB_ML_RESULT_INPUT_ERROR;
+    }
+
+    memset(sched, 0, sizeof(*sched));
+    sched->model = model;
+    sched->config = *config;
+    if (sched->config.max_decimation == 0)
+    {
+        sched->config.max_decimation = 1;
+    }
+    sched->stats.decimation = 1;
+    sched->stats.est_cycles = scheduler_profiled_cycles(model);
+    sched->stats.est_fallback_cycles = scheduler_profiled_cycles(config->fallback);
+    sched->min_cycles = sched->stats.est_cycles;
+    sched->min_fallback_cycles = sched->stats.est_fallback_cycles;
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_scheduler_submit(mtb_ml_scheduler_t *sched, MTB_ML_DATA_T *input, uint64_t arrival,
+                                  mtb_ml_scheduler_decision_t *decision, mtb_ml_model_t **model)
+{
+    mtb_ml_scheduler_stats_t *stats;
+    mtb_ml_model_t *run_model;
+    uint64_t *est, *min_cycles;
+    uint64_t start, end, waited, latency;
+    uint32_t gate_skipped;
+    cy_rslt_t result;
+
+    if (sched == NULL || sched->model == NULL || input == NULL || decision == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    if (model != NULL)
+    {
+        *model = NULL;
+    }
+
+    stats = &sched->stats;
+    stats->frames++;
+    if (stats->decimation > 1U && (sched->phase++ % stats->decimation) != 0U)
+    {
+        stats->decimated++;
+        scheduler_decay_estimate(&stats->est_cycles, sched->min_cycles);
+        scheduler_decay_estimate(&stats->est_fallback_cycles, sched->min_fallback_cycles);
+        *decision = MTB_ML_SCHEDULER_DECIMATED;
+        return MTB_ML_RESULT_SUCCESS;
+    }
+
+    start = scheduler_tsc();
+    waited = (start > arrival) ? start - arrival : 0;
+    if (waited + stats->est_cycles <= sched->config.deadline_cycles)
+    {
+        run_model = sched->model;
+        est = &stats->est_cycles;
+        min_cycles = &sched->min_cycles;
+        *decision = MTB_ML_SCHEDULER_RUN;
+    }
+    else if (sched->config.fallback != NULL &&
+             waited + stats->est_fallback_cycles <= sched->config.deadline_cycles)
+    {
+        run_model = sched->config.fallback;
+        est = &stats->est_fallback_cycles;
+        min_cycles = &sched->min_fallback_cycles;
+        scheduler_decay_estimate(&stats->est_cycles, sched->min_cycles);
+        *decision = MTB_ML_SCHEDULER_RUN_FALLBACK;
+    }
+    else
+    {
+        stats->dropped_late++;
+        scheduler_decay_estimate(&stats->est_cycles, sched->min_cycles);
+        scheduler_decay_estimate(&stats->est_fallback_cycles, sched->min_fallback_cycles);
+        scheduler_overload(sched);
+        *decision = MTB_ML_SCHEDULER_DROPPED_LATE;
+        return MTB_ML_RESULT_SUCCESS;
+    }
+
+    gate_skipped = run_model->input_gate.stats.skipped;
+    result = mtb_ml_model_run(run_model, input);
+    end = scheduler_tsc();
+    if (result != MTB_ML_RESULT_SUCCESS)
+    {
+        return result;
+    }
+    /* A frame skipped by the input gate says nothing about the inference latency */
+    if (run_model->input_gate.stats.skipped == gate_skipped)
+    {
+        scheduler_update_estimate(est, end - start);
+        if (*min_cycles == 0 || end - start < *min_cycles)
+        {
+            *min_cycles = end - start;
+        }
+    }
+
+    if (*decision == MTB_ML_SCHEDULER_RUN)
+    {
+        stats->runs++;
+    }
+    else
+    {
+        stats->fallback_runs++;
+    }
+    latency = (end > arrival) ? end - arrival : 0;
+    if (latency > stats->max_latency_cycles)
+    {
+        stats->max_latency_cycles = latency;
+    }
+    if (latency > sched->config.deadline_cycles)
+    {
+        stats->deadline_misses++;
+        scheduler_overload(sched);
+    }
+    else
+    {
+        scheduler_in_time(sched);
+    }
+    if (model != NULL)
+    {
+        *model = run_model;
+    }
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_scheduler_get_stats(const mtb_ml_scheduler_t *sched, mtb_ml_scheduler_stats_t *stats)
+{
+    if (sched == NULL || stats == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    *stats = sched->stats;
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+cy_rslt_t mtb_ml_scheduler_log(const mtb_ml_scheduler_stats_t *stats)
+{
+    if (stats == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    printf("SCHEDULER_INFO, frames=%-8" PRIu32 ", runs=%-8" PRIu32 ", fallback_runs=%-8" PRIu32 ", dropped_late=%-6" PRIu32 ", decimated=%-6" PRIu32 ", deadline_misses=%-6" PRIu32 ", max_latency_cycles=%" PRIu64 "\r\n",
+           stats->frames, stats->runs, stats->fallback_runs, stats->dropped_late, stats->decimated,
+           stats->deadline_misses, stats->max_latency_cycles);
+    return MTB_ML_RESULT_SUCCESS;
+}
@@ -0,0 +1,181 @@
+/***************************************************************************//**
+* \file mtb_ml_type_ops.cpp
+*
+* \brief
+* This file contains the data type kernels bound to a model object at init, which
+* spare the run-time type detection build a type switch per call
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "mtb_ml.h"
+#include "mtb_ml_model_impl.h"
+
+#include <limits>
+
+/*******************************************************************************
+ * Private Functions
+*******************************************************************************/
+/* Rounds half away from zero and saturates, as the int8/int16 converters always did */
+template <typename T>
+static cy_rslt_t type_quantize(const float *in, void *out, int size, float scale, int zero_point)
+{
+    T *dst = static_cast<T *>(out);
+
+    if (in == NULL || out == NULL || size <= 0)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    for (int i = 0; i < size; i++)
+    {
+        float val = (in[i] / scale) + zero_point;
+        val += val > 0.0f ? 0.5f : -0.5f;
+        int32_t q = (int32_t)val;
+        if (q > std::numeric_limits<T>::max())
+        {
+            q = std::numeric_limits<T>::max();
+        }
+        else if (q < std::numeric_limits<T>::min())
+        {
+            q = std::numeric_limits<T>::min();
+        }
+        dst[i] = (T)q;
+    }
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+/* Float model input is taken as is */
+template <>
+cy_rslt_t type_quantize<float>(const float *in, void *out, int size, float scale, int zero_point)
+{
+    (void)scale;
+    (void)zero_point;
+    if (in == NULL || out == NULL || size <= 0)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    if (out != in)
+    {
+        memcpy(out, in, (size_t)size * sizeof(float));
+    }
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+template <typename T>
+static void type_dequantize(const void *in, float *out, int size, float scale, int zero_point)
+{
+    const T *src = static_cast<const T *>(in);
+
+    for (int i = 0; i < size; i++)
+    {
+        out[i] = ((int)src[i] - zero_point) * scale;
+    }
+}
+
+template <>
+void type_dequantize<float>(const void *in, float *out, int size, float scale, int zero_point)
+{
+    (void)scale;
+    (void)zero_point;
+    if (size > 0 && out != in)
+    {
+        memcpy(out, in, (size_t)size * sizeof(float));
+    }
+}
+
+template <typename T>
+static int type_find_max(const void *in, int size)
+{
+    const T *src = static_cast<const T *>(in);
+    int max_idx = -1;
+
+    if (src != NULL && size > 0)
+    {
+        T max_val = src[0];
+
+        max_idx = 0;
+        for (int i = 1; i < size; i++)
+        {
+            if (src[i] > max_val)
+            {
+                max_idx = i;
+                max_val = src[i];
+            }
+        }
+    }
+    return max_idx;
+}
+
+template <typename T>
+static void type_copy(void *dst, const void *src, int size)
+{
+    if (size > 0)
+    {
+        memcpy(dst, src, (size_t)size * sizeof(T));
+    }
+}
+
+static const mtb_ml_type_ops_t type_ops_int8 =
+{
+    sizeof(int8_t), type_quantize<int8_t>, type_dequantize<int8_t>, type_find_max<int8_t>, type_copy<int8_t>
+};
+
+static const mtb_ml_type_ops_t type_ops_int16 =
+{
+    sizeof(int16_t), type_quantize<int16_t>, type_dequantize<int16_t>, type_find_max<int16_t>, type_copy<int16_t>
+};
+
+static const mtb_ml_type_ops_t type_ops_flt =
+{
+    sizeof(float), type_quantize<float>, type_dequantize<float>, type_find_max<float>, type_copy<float>
+};
+
+/*******************************************************************************
+ * Public Functions
+*******************************************************************************/
+extern "C" const mtb_ml_type_ops_t *mtb_ml_type_ops_get(int type_size)
+{
+    switch (type_size)
+    {
+        case sizeof(int8_t):
+            return &type_ops_int8;
+        case sizeof(int16_t):
+            return &type_ops_int16;
+        default:
+            /* Anything else is taken as float, as the type switches of mtb_ml_utils always did */
+            return &type_ops_flt;
+    }
+}
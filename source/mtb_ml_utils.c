@@ -41,8 +41,10 @@
 #include <stdio.h>
 #include <inttypes.h>
 #include <limits.h>
-#include "mtb_ml_common.h"
-#include "mtb_ml_utils.h"
+#include <math.h>
+#include <string.h>
+#include "mtb_ml.h"
+#include "mtb_ml_model_impl.h"
 
 #if defined(COMPONENT_CMSIS_DSP)
 #include "arm_math.h"
@@ -88,91 +90,29 @@ do { \
     return MTB_ML_RESULT_SUCCESS; \
 } while(0)
 
-/* This function converts an array of floating-point to a 8-bits fixed-point integer for TFLiteU. */
-static cy_rslt_t mtb_ml_utils_convert_flt_to_int8(const float* in, int8_t *out, int size, float scale, int zero_point)
-{
-    int loop_count;
-    float val;
-
-    /* Sanity check of input parameters */
-    if (in == NULL || out == NULL || size <= 0)
-    {
-        return MTB_ML_RESULT_BAD_ARG;
-    }
-
-#if defined(COMPONENT_CMSIS_DSP)
-    /* Process 4 output at one time */
-    loop_count = size;
-    while (loop_count > 0)
-    {
-        val = *in++;
-        val = (val / scale) + zero_point;
-        val += val > 0.0f ? 0.5f : -0.5f;
-        *out++ = (int8_t) (__SSAT((int32_t) (val), 8));
-        loop_count--;
-    }
-#else
-    loop_count = size;
-    while (loop_count > 0)
-    {
-        val = (*in++ / scale) + zero_point;
-        val += val > 0.0f ? 0.5f : -0.5f;
-        if ((int32_t) val > SCHAR_MAX)
-            *out++ = SCHAR_MAX;
-        else if ((int32_t) val < SCHAR_MIN)
-            *out++ = SCHAR_MIN;
-        else
-            *out++ = (int8_t) (val);
-
-        loop_count--;
-    }
-#endif /* COMPONENT_CMSIS_DSP */
-
-    return MTB_ML_RESULT_SUCCESS;
-}
+/* Elements between the checks against the early exit limit */
+#define INPUT_DELTA_BLOCK   (64)
 
-/* This function converts an array of floating-point to a 16-bits fixed-point integer for TFLiteU. */
-static cy_rslt_t mtb_ml_utils_convert_flt_to_int16(const float* in, int16_t *out, int size, float scale, int zero_point)
-{
-    int loop_count;
-    float val;
-
-    /* Sanity check of input parameters */
-    if (in == NULL || out == NULL || size <= 0)
-    {
-        return MTB_ML_RESULT_BAD_ARG;
-    }
-
-#if defined(COMPONENT_CMSIS_DSP)
-    /* Process 4 output at one time */
-    loop_count = size;
-    while (loop_count > 0)
-    {
-        val = *in++;
-        val = (val / scale) + zero_point;
-        val += val > 0.0f ? 0.5f : -0.5f;
-        *out++ = (int16_t) (__SSAT((int32_t) (val), 16));
-        loop_count--;
-    }
-#else
-    loop_count = size;
-    while (loop_count > 0)
-    {
-        val = (*in++ / scale) + zero_point;
-        val += val > 0.0f ? 0.5f : -0.5f;
-        if ((int32_t) val > SHRT_MAX)
-            *out++ = SHRT_MAX;
-        else if ((int32_t) val < SHRT_MIN)
-            *out++ = SHRT_MIN;
-        else
-            *out++ = (int16_t) (val);
-
-        loop_count--;
-    }
-#endif /* COMPONENT_CMSIS_DSP */
-
-    return MTB_ML_RESULT_SUCCESS;
-}
+/* Distance of two arrays up to the first block exceeding limit. i, end and dist are
+ * declared by the caller, which may process part of a block before. */
+#define INPUT_DELTA_BLOCK_TAIL(a, b, metric, dist_t) \
+do { \
+    if (metric == MTB_ML_INPUT_DELTA_MAX_ABS) \
+    { \
+        for (; i < end; i++) \
+        { \
+            dist_t d = (a[i] > b[i]) ? (dist_t)(a[i] - b[i]) : (dist_t)(b[i] - a[i]); \
+            dist = (d > dist) ? d : dist; \
+        } \
+    } \
+    else \
+    { \
+        for (; i < end; i++) \
+        { \
+            dist += (a[i] > b[i]) ? (dist_t)(a[i] - b[i]) : (dist_t)(b[i] - a[i]); \
+        } \
+    } \
+} while(0)
 
 /*******************************************************************************
  * Public Functions
@@ -280,6 +220,76 @@ int mtb_ml_utils_find_max_int8(const int8_t* in, int size)
     return max_idx;
 }
 
+uint32_t mtb_ml_utils_input_delta_int8(const int8_t* a, const int8_t* b, int size,
+                                       mtb_ml_input_delta_metric_t metric, uint32_t limit)
+{
+    uint32_t dist = 0;
+    int i = 0, end;
+
+    if (a == NULL || b == NULL || size <= 0)
+    {
+        return UINT32_MAX;
+    }
+
+    while (i < size && dist <= limit)
+    {
+        end = (size - i > INPUT_DELTA_BLOCK) ? i + INPUT_DELTA_BLOCK : size;
+#if defined(COMPONENT_CMSIS_DSP) && defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+        if (metric == MTB_ML_INPUT_DELTA_L1)
+        {
+            /* Sum of absolute differences of 4 elements at a time, offset to unsigned */
+            for (; i + 4 <= end; i += 4)
+            {
+                uint32_t x, y;
+                memcpy(&x, &a[i], sizeof(x));
+                memcpy(&y, &b[i], sizeof(y));
+                dist = __USADA8(x ^ 0x80808080U, y ^ 0x80808080U, dist);
+            }
+        }
+#endif
+        INPUT_DELTA_BLOCK_TAIL(a, b, metric, uint32_t);
+    }
+    return dist;
+}
+
+uint32_t mtb_ml_utils_input_delta_int16(const int16_t* a, const int16_t* b, int size,
+                                        mtb_ml_input_delta_metric_t metric, uint32_t limit)
+{
+    uint32_t dist = 0;
+    int i = 0, end;
+
+    if (a == NULL || b == NULL || size <= 0)
+    {
+        return UINT32_MAX;
+    }
+
+    while (i < size && dist <= limit)
+    {
+        end = (size - i > INPUT_DELTA_BLOCK) ? i + INPUT_DELTA_BLOCK : size;
+        INPUT_DELTA_BLOCK_TAIL(a, b, metric, uint32_t);
+    }
+    return dist;
+}
+
+float mtb_ml_utils_input_delta_flt(const float* a, const float* b, int size,
+                                   mtb_ml_input_delta_metric_t metric, float limit)
+{
+    float dist = 0.0f;
+    int i = 0, end;
+
+    if (a == NULL || b == NULL || size <= 0)
+    {
+        return INFINITY;
+    }
+
+    while (i < size && dist <= limit)
+    {
+        end = (size - i > INPUT_DELTA_BLOCK) ? i + INPUT_DELTA_BLOCK : size;
+        INPUT_DELTA_BLOCK_TAIL(a, b, metric, float);
+    }
+    return dist;
+}
+
 cy_rslt_t mtb_ml_utils_print_model_info(const mtb_ml_model_t *obj)
 {
     if (obj == NULL) {
@@ -295,22 +305,24 @@ cy_rslt_t mtb_ml_utils_print_model_info(const mtb_ml_model_t *obj)
     return MTB_ML_RESULT_SUCCESS;
 }
 
+/* Kernels bound by mtb_ml_model_init(), resolved here for model objects set up by hand */
+static const mtb_ml_type_ops_t *utils_input_ops(const mtb_ml_model_t *obj)
+{
+    return (obj->input_ops != NULL) ? obj->input_ops : mtb_ml_type_ops_get(obj->input_type_size);
+}
+
+static const mtb_ml_type_ops_t *utils_output_ops(const mtb_ml_model_t *obj)
+{
+    return (obj->output_ops != NULL) ? obj->output_ops : mtb_ml_type_ops_get(obj->output_type_size);
+}
+
 cy_rslt_t mtb_ml_utils_model_quantize(const mtb_ml_model_t *obj, const float* input_data, MTB_ML_DATA_T* quantized_values)
 {
     if (obj == NULL || input_data == NULL || quantized_values == NULL) {
         return MTB_ML_RESULT_BAD_ARG;
     }
-    int32_t size = obj->input_size;
-    const float *value = input_data;
-    switch(obj->input_type_size)
-    {
-        case sizeof(int8_t):
-            return mtb_ml_utils_convert_flt_to_int8(value, (int8_t *)quantized_values, size, obj->input_scale, obj->input_zero_point);
-        case sizeof(int16_t):
-            return mtb_ml_utils_convert_flt_to_int16(value, (int16_t *)quantized_values, size, obj->input_scale, obj->input_zero_point);
-        default:
-            return MTB_ML_RESULT_SUCCESS;
-    }
+    return utils_input_ops(obj)->quantize(input_data, quantized_values, obj->input_size,
+                                          obj->input_scale, obj->input_zero_point);
 }
 
 cy_rslt_t mtb_ml_utils_model_dequantize(const mtb_ml_model_t *obj, float* dequantized_values)
@@ -318,33 +330,92 @@ cy_rslt_t mtb_ml_utils_model_dequantize(const mtb_ml_model_t *obj, float* dequan
     if (obj == NULL || dequantized_values == NULL) {
         return MTB_ML_RESULT_BAD_ARG;
     }
-    int size = obj->output_size;
-    MTB_ML_DATA_T *value = obj->output;
+    /* The output elements are of the model output type, whatever MTB_ML_DATA_T is */
+    utils_output_ops(obj)->dequantize(obj->output, dequantized_values, obj->output_size,
+                                      obj->output_scale, obj->output_zero_point);
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+int mtb_ml_utils_model_find_max(const mtb_ml_model_t *obj)
+{
+    if (obj == NULL || obj->output == NULL) {
+        return -1;
+    }
+    return utils_output_ops(obj)->find_max(obj->output, obj->output_size);
+}
+
+cy_rslt_t mtb_ml_utils_print_memory_report(const mtb_ml_memory_report_t *report,
+                                           const mtb_ml_tensor_memory_t *tensors, uint32_t count)
+{
+    if (report == NULL || (tensors == NULL && count != 0)) {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+
+    printf("MEMORY_INFO, arena_size=%-8" PRIu32 ", arena_used=%-8" PRIu32 ", persistent=%-8" PRIu32 ", scratch=%-8" PRIu32 ", wrapper_heap=%" PRIu32 "\r\n",
+           report->arena_size, report->arena_used, report->persistent_bytes, report->scratch_bytes,
+           report->wrapper_heap_bytes);
+    printf("MEMORY_INFO, tensor_data=%-8" PRIu32 ", node_metadata=%-8" PRIu32 ", op_data=%-8" PRIu32 ", resource_variables=%-8" PRIu32 ", operators=%-6" PRIu32 ", tensors=%" PRIu32 "\r\n",
+           report->tensor_data_bytes, report->node_metadata_bytes, report->op_data_bytes,
+           report->resource_variable_bytes, report->operator_count, report->tensor_count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        printf("TENSOR_INFO, index=%-6" PRId32 ", offset=%-8" PRId32 ", bytes=%-8" PRIu32 ", first_use=%-6" PRId32 ", last_use=%" PRId32 "\r\n",
+               tensors[i].index, tensors[i].offset, tensors[i].bytes, tensors[i].first_use, tensors[i].last_use);
+    }
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+#if defined(COMPONENT_ML_HOST)
+cy_rslt_t mtb_ml_utils_save_memory_report(const char *path, const mtb_ml_memory_report_t *report,
+                                          const mtb_ml_tensor_memory_t *tensors, uint32_t count)
+{
+    size_t len;
+    FILE *f;
+    int err;
+
+    if (path == NULL || report == NULL || (tensors == NULL && count != 0)) {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    f = fopen(path, "w");
+    if (f == NULL) {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
 
-    if (obj->output_type_size != sizeof(float))
+    len = strlen(path);
+    if (len >= 4 && strcmp(path + len - 4, ".csv") == 0)
     {
-        int zero_point = obj->output_zero_point;
-        float scale = obj->output_scale;
-        while ( size > 0 )
+        fprintf(f, "index,offset,bytes,first_use,last_use\n");
+        for (uint32_t i = 0; i < count; i++)
         {
-            if (obj->output_type_size == sizeof(int8_t))
-            {
-                *dequantized_values++ = ((int)(*((int8_t *)value++)) - zero_point) * scale;
-            }
-            else
-            {
-                *dequantized_values++ = ((int)(*((int16_t *)value++)) - zero_point) * scale;
-            }
-            size--;
+            fprintf(f, "%" PRId32 ",%" PRId32 ",%" PRIu32 ",%" PRId32 ",%" PRId32 "\n",
+                    tensors[i].index, tensors[i].offset, tensors[i].bytes, tensors[i].first_use, tensors[i].last_use);
         }
     }
     else
-    {   /* Copy the value over */
-        while ( size > 0 )
+    {
+        fprintf(f, "{\n  \"arena_size\": %" PRIu32 ",\n  \"arena_used\": %" PRIu32 ",\n", report->arena_size, report->arena_used);
+        fprintf(f, "  \"persistent_bytes\": %" PRIu32 ",\n  \"scratch_bytes\": %" PRIu32 ",\n",
+                report->persistent_bytes, report->scratch_bytes);
+        fprintf(f, "  \"tensor_data_bytes\": %" PRIu32 ",\n  \"node_metadata_bytes\": %" PRIu32 ",\n",
+                report->tensor_data_bytes, report->node_metadata_bytes);
+        fprintf(f, "  \"op_data_bytes\": %" PRIu32 ",\n  \"resource_variable_bytes\": %" PRIu32 ",\n",
+                report->op_data_bytes, report->resource_variable_bytes);
+        fprintf(f, "  \"wrapper_heap_bytes\": %" PRIu32 ",\n  \"operator_count\": %" PRIu32 ",\n",
+                report->wrapper_heap_bytes, report->operator_count);
+        fprintf(f, "  \"tensor_count\": %" PRIu32 ",\n  \"tensors\": [", report->tensor_count);
+        for (uint32_t i = 0; i < count; i++)
         {
-            *dequantized_values++ = *((float *)value++);
-            size--;
+            fprintf(f, "%s\n    {\"index\": %" PRId32 ", \"offset\": %" PRId32 ", \"bytes\": %" PRIu32 ", \"first_use\": %" PRId32 ", \"last_use\": %" PRId32 "}",
+                    (i == 0) ? "" : ",", tensors[i].index, tensors[i].offset, tensors[i].bytes,
+                    tensors[i].first_use, tensors[i].last_use);
         }
+        fprintf(f, "%s]\n}\n", (count == 0) ? "" : "\n  ");
+    }
+
+    err = ferror(f);
+    if (fclose(f) != 0 || err != 0) {
+        return MTB_ML_RESULT_BAD_ARG;
     }
     return MTB_ML_RESULT_SUCCESS;
 }
+#endif
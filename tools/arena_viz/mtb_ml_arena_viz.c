@@ -0,0 +1,668 @@
+/***************************************************************************//**
+* \file mtb_ml_arena_viz.c
+*
+* \brief
+* Host tool showing how a model is laid out in its tensor arena. It takes the
+* tensors of mtb_ml_model_get_memory_report(), from a model loaded with the
+* host build or from a CSV of mtb_ml_utils_save_memory_report(). It prints
+* every tensor with its offset, size and operator interval, and the bytes the
+* plan wastes against the live bytes of its worst operator. It compares the
+* plan with offline planners and points at the tensors that keep the peak up.
+* An HTML page draws the arena occupancy over the operators.
+*
+* Usage:
+*   mtb_ml_arena_viz (--model FILE.tflite [--arena BYTES] [--save REPORT] | --csv FILE.csv)
+*                    [--html FILE.html]
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <getopt.h>
+#include "mtb_ml.h"
+
+/*******************************************************************************
+ * Macros
+*******************************************************************************/
+/* Buffer alignment of the TFLM memory planner */
+#define VIZ_ALIGN               (16U)
+#define VIZ_ALIGN_UP(x)         (((x) + VIZ_ALIGN - 1U) & ~(VIZ_ALIGN - 1U))
+
+/* Entries of the rankings printed */
+#define VIZ_TOP                 (5U)
+
+/* Plot area of the HTML page */
+#define VIZ_PLOT_WIDTH          (960.0)
+#define VIZ_PLOT_HEIGHT         (420.0)
+
+/*******************************************************************************
+ * Typedefs
+*******************************************************************************/
+/* Tensor planned in the arena head, offsets relative to the start of the plan */
+typedef struct
+{
+    int32_t index;
+    uint32_t offset;
+    uint32_t bytes;
+    uint32_t first;
+    uint32_t last;
+} viz_tensor_t;
+
+typedef struct
+{
+    const char *name;
+    viz_tensor_t *tensors;
+    uint32_t count;
+    uint32_t ops;
+    uint32_t peak;                  /* end of the highest tensor */
+} viz_plan_t;
+
+typedef int (*viz_order_t)(const void *a, const void *b);
+
+/*******************************************************************************
+ * Private Functions
+*******************************************************************************/
+static void viz_usage(void)
+{
+    fprintf(stderr, "usage: mtb_ml_arena_viz (--model FILE.tflite [--arena BYTES] [--save REPORT] | --csv FILE.csv) "
+                    "[--html FILE.html]\n");
+    exit(2);
+}
+
+static bool viz_live(const viz_tensor_t *t, uint32_t op)
+{
+    return t->first <= op && op <= t->last;
+}
+
+static bool viz_overlap_time(const viz_tensor_t *a, const viz_tensor_t *b)
+{
+    return a->first <= b->last && b->first <= a->last;
+}
+
+static uint32_t viz_peak(const viz_plan_t *plan)
+{
+    uint32_t peak = 0;
+
+    for(uint32_t i = 0; i < plan->count; i++)
+    {
+        uint32_t end = plan->tensors[i].offset + plan->tensors[i].bytes;
+        peak = (end > peak) ? end : peak;
+    }
+    return peak;
+}
+
+/* Sum of the tensors live at op, the lower bound of any plan at that op */
+static uint32_t viz_live_bytes(const viz_plan_t *plan, uint32_t op)
+{
+    uint32_t bytes = 0;
+
+    for(uint32_t i = 0; i < plan->count; i++)
+    {
+        if(viz_live(&plan->tensors[i], op))
+        {
+            bytes += VIZ_ALIGN_UP(plan->tensors[i].bytes);
+        }
+    }
+    return bytes;
+}
+
+/* End of the highest tensor live at op */
+static uint32_t viz_high_water(const viz_plan_t *plan, uint32_t op)
+{
+    uint32_t high = 0;
+
+    for(uint32_t i = 0; i < plan->count; i++)
+    {
+        const viz_tensor_t *t = &plan->tensors[i];
+        if(viz_live(t, op) && t->offset + t->bytes > high)
+        {
+            high = t->offset + t->bytes;
+        }
+    }
+    return high;
+}
+
+/* Op with the most live bytes */
+static uint32_t viz_peak_op(const viz_plan_t *plan, uint32_t *live_peak)
+{
+    uint32_t peak_op = 0;
+
+    *live_peak = 0;
+    for(uint32_t op = 0; op < plan->ops; op++)
+    {
+        uint32_t live = viz_live_bytes(plan, op);
+        if(live > *live_peak)
+        {
+            *live_peak = live;
+            peak_op = op;
+        }
+    }
+    return peak_op;
+}
+
+static int viz_by_size(const void *a, const void *b)
+{
+    const viz_tensor_t *ta = a, *tb = b;
+
+    if(ta->bytes != tb->bytes)
+    {
+        return (ta->bytes > tb->bytes) ? -1 : 1;
+    }
+    return ta->index - tb->index;
+}
+
+static int viz_by_first_use(const void *a, const void *b)
+{
+    const viz_tensor_t *ta = a, *tb = b;
+
+    if(ta->first != tb->first)
+    {
+        return (ta->first < tb->first) ? -1 : 1;
+    }
+    return viz_by_size(a, b);
+}
+
+static int viz_by_lifetime(const void *a, const void *b)
+{
+    const viz_tensor_t *ta = a, *tb = b;
+    uint32_t la = ta->last - ta->first, lb = tb->last - tb->first;
+
+    if(la != lb)
+    {
+        return (la > lb) ? -1 : 1;
+    }
+    return viz_by_size(a, b);
+}
+
+static int viz_by_offset(const void *a, const void *b)
+{
+    const viz_tensor_t *ta = *(const viz_tensor_t * const *)a, *tb = *(const viz_tensor_t * const *)b;
+
+    return (ta->offset > tb->offset) - (ta->offset < tb->offset);
+}
+
+/* Offline planner: the tensors are placed in the given order, each at the lowest
+ * aligned offset free of the placed tensors it is live with */
+static bool viz_plan_greedy(const viz_plan_t *current, viz_order_t order, const char *name, viz_plan_t *plan)
+{
+    const viz_tensor_t **placed;
+
+    plan->name = name;
+    plan->count = current->count;
+    plan->ops = current->ops;
+    plan->tensors = malloc((current->count + 1U) * sizeof(viz_tensor_t));
+    placed = malloc((current->count + 1U) * sizeof(viz_tensor_t *));
+    if(plan->tensors == NULL || placed == NULL)
+    {
+        free(plan->tensors);
+        free(placed);
+        return false;
+    }
+    memcpy(plan->tensors, current->tensors, current->count * sizeof(viz_tensor_t));
+    qsort(plan->tensors, plan->count, sizeof(viz_tensor_t), order);
+
+    for(uint32_t i = 0; i < plan->count; i++)
+    {
+        viz_tensor_t *t = &plan->tensors[i];
+        uint32_t conflicts = 0, offset = 0;
+
+        for(uint32_t j = 0; j < i; j++)
+        {
+            if(viz_overlap_time(t, &plan->tensors[j]))
+            {
+                placed[conflicts++] = &plan->tensors[j];
+            }
+        }
+        qsort(placed, conflicts, sizeof(placed[0]), viz_by_offset);
+        for(uint32_t j = 0; j < conflicts; j++)
+        {
+            if(offset + t->bytes <= placed[j]->offset)
+            {
+                break;
+            }
+            if(placed[j]->offset + placed[j]->bytes > offset)
+            {
+                offset = VIZ_ALIGN_UP(placed[j]->offset + placed[j]->bytes);
+            }
+        }
+        t->offset = offset;
+    }
+    free(placed);
+    plan->peak = viz_peak(plan);
+    return true;
+}
+
+/* Tensors of the arena head with a lifetime, offsets made relative to the lowest one */
+static bool viz_plan_from_report(const mtb_ml_memory_report_t *report, const mtb_ml_tensor_memory_t *tensors,
+                                 uint32_t count, viz_plan_t *plan)
+{
+    uint32_t head_end = UINT32_MAX, base = UINT32_MAX;
+
+    memset(plan, 0, sizeof(*plan));
+    plan->name = "current";
+    plan->tensors = malloc((count + 1U) * sizeof(viz_tensor_t));
+    if(plan->tensors == NULL)
+    {
+        return false;
+    }
+    /* Variable tensors and other persistent data are allocated from the arena tail */
+    if(report != NULL && report->arena_size > report->persistent_bytes)
+    {
+        head_end = report->arena_size - report->persistent_bytes;
+    }
+    for(uint32_t i = 0; i < count; i++)
+    {
+        const mtb_ml_tensor_memory_t *t = &tensors[i];
+
+        if(t->offset < 0 || t->bytes == 0 || t->first_use < 0 || t->last_use < t->first_use ||
+           (uint32_t)t->offset >= head_end)
+        {
+            continue;
+        }
+        plan->tensors[plan->count++] = (viz_tensor_t){ t->index, (uint32_t)t->offset, t->bytes,
+                                                       (uint32_t)t->first_use, (uint32_t)t->last_use };
+        base = ((uint32_t)t->offset < base) ? (uint32_t)t->offset : base;
+        plan->ops = ((uint32_t)t->last_use + 1U > plan->ops) ? (uint32_t)t->last_use + 1U : plan->ops;
+    }
+    if(report != NULL && report->operator_count > plan->ops)
+    {
+        plan->ops = report->operator_count;
+    }
+    for(uint32_t i = 0; i < plan->count; i++)
+    {
+        plan->tensors[i].offset -= base;
+    }
+    plan->peak = viz_peak(plan);
+    return true;
+}
+
+static mtb_ml_tensor_memory_t *viz_read_csv(const char *path, uint32_t *count)
+{
+    mtb_ml_tensor_memory_t *tensors = NULL, *grown;
+    uint32_t capacity = 0;
+    char line[256];
+    FILE *f = fopen(path, "r");
+
+    *count = 0;
+    if(f == NULL)
+    {
+        fprintf(stderr, "ERROR: cannot open %s\n", path);
+        return NULL;
+    }
+    while(fgets(line, sizeof(line), f) != NULL)
+    {
+        mtb_ml_tensor_memory_t t;
+
+        /* The header and malformed lines are skipped */
+        if(sscanf(line, "%" SCNd32 ",%" SCNd32 ",%" SCNu32 ",%" SCNd32 ",%" SCNd32,
+                  &t.index, &t.offset, &t.bytes, &t.first_use, &t.last_use) != 5)
+        {
+            continue;
+        }
+        if(*count == capacity)
+        {
+            capacity = (capacity == 0) ? 64U : capacity * 2U;
+            grown = realloc(tensors, capacity * sizeof(*tensors));
+            if(grown == NULL)
+            {
+                free(tensors);
+                fclose(f);
+                return NULL;
+            }
+            tensors = grown;
+        }
+        tensors[(*count)++] = t;
+    }
+    fclose(f);
+    return tensors;
+}
+
+#if defined(MTB_ML_ARENA_VIZ_MODEL)
+static mtb_ml_tensor_memory_t *viz_read_model(const char *path, int arena_size, const char *save_path,
+                                              mtb_ml_memory_report_t *report, uint32_t *count)
+{
+    mtb_ml_tensor_memory_t *tensors = NULL;
+    mtb_ml_model_bin_t *bin = NULL;
+    mtb_ml_model_t *model = NULL;
+    cy_rslt_t result;
+
+    *count = 0;
+    result = mtb_ml_model_bin_from_file(path, arena_size, &bin);
+    if(result == MTB_ML_RESULT_SUCCESS)
+    {
+        result = mtb_ml_model_init(bin, NULL, &model);
+    }
+    if(result == MTB_ML_RESULT_SUCCESS)
+    {
+        result = mtb_ml_model_get_memory_report(model, report, NULL, 0);
+    }
+    if(result == MTB_ML_RESULT_SUCCESS)
+    {
+        tensors = malloc((report->tensor_count + 1U) * sizeof(*tensors));
+        result = (tensors != NULL) ? mtb_ml_model_get_memory_report(model, report, tensors, report->tensor_count)
+                                   : MTB_ML_RESULT_ALLOC_ERR;
+    }
+    if(result == MTB_ML_RESULT_SUCCESS && save_path != NULL)
+    {
+        result = mtb_ml_utils_save_memory_report(save_path, report, tensors, report->tensor_count);
+    }
+    if(result == MTB_ML_RESULT_SUCCESS)
+    {
+        *count = report->tensor_count;
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: memory report of %s failed (0x%x)\n", path, (unsigned int)result);
+        free(tensors);
+        tensors = NULL;
+    }
+    if(model != NULL)
+    {
+        mtb_ml_model_deinit(model);
+    }
+    if(bin != NULL)
+    {
+        mtb_ml_model_bin_free(bin);
+    }
+    return tensors;
+}
+#endif
+
+static void viz_print_tensors(const mtb_ml_tensor_memory_t *tensors, uint32_t count)
+{
+    printf("%8s %10s %10s %10s %10s\n", "tensor", "offset", "bytes", "first_use", "last_use");
+    for(uint32_t i = 0; i < count; i++)
+    {
+        printf("%8" PRId32 " %10" PRId32 " %10" PRIu32 " %10" PRId32 " %10" PRId32 "\n",
+               tensors[i].index, tensors[i].offset, tensors[i].bytes, tensors[i].first_use, tensors[i].last_use);
+    }
+}
+
+/* Ops where the plan is furthest above the live bytes */
+static void viz_print_gaps(const viz_plan_t *plan)
+{
+    bool *shown = calloc(plan->ops + 1U, sizeof(bool));
+
+    if(shown == NULL)
+    {
+        return;
+    }
+    printf("\nlargest planning gaps (high water above the live bytes of the op):\n");
+    for(uint32_t n = 0; n < VIZ_TOP; n++)
+    {
+        uint32_t worst_op = 0, worst_gap = 0;
+
+        for(uint32_t op = 0; op < plan->ops; op++)
+        {
+            uint32_t high = viz_high_water(plan, op), live = viz_live_bytes(plan, op);
+            if(!shown[op] && high > live && high - live > worst_gap)
+            {
+                worst_gap = high - live;
+                worst_op = op;
+            }
+        }
+        if(worst_gap == 0)
+        {
+            break;
+        }
+        shown[worst_op] = true;
+        printf("  op %-5" PRIu32 " high_water=%-9" PRIu32 " live=%-9" PRIu32 " gap=%" PRIu32 "\n", worst_op,
+               viz_high_water(plan, worst_op), viz_live_bytes(plan, worst_op), worst_gap);
+    }
+    free(shown);
+}
+
+/* Tensors live across the peak op that neither start nor end there, the candidates for a
+ * reordering that ends them earlier or starts them later */
+static void viz_print_reorderings(const viz_plan_t *plan, uint32_t peak_op)
+{
+    bool *shown = calloc(plan->count + 1U, sizeof(bool));
+
+    if(shown == NULL)
+    {
+        return;
+    }
+    printf("\ntensors held across the peak op %" PRIu32 ":\n", peak_op);
+    for(uint32_t n = 0; n < VIZ_TOP; n++)
+    {
+        const viz_tensor_t *best = NULL;
+        uint32_t best_i = 0;
+
+        for(uint32_t i = 0; i < plan->count; i++)
+        {
+            const viz_tensor_t *t = &plan->tensors[i];
+            if(!shown[i] && t->first < peak_op && t->last > peak_op && (best == NULL || t->bytes > best->bytes))
+            {
+                best = t;
+                best_i = i;
+            }
+        }
+        if(best == NULL)
+        {
+            if(n == 0)
+            {
+                printf("  none, the peak is set by the tensors of op %" PRIu32 " itself\n", peak_op);
+            }
+            break;
+        }
+        shown[best_i] = true;
+        printf("  tensor %-5" PRId32 " %9" PRIu32 " bytes, live over ops %" PRIu32 "..%" PRIu32
+               ": its last user op %" PRIu32 " moved before op %" PRIu32 ", or its first user op %" PRIu32
+               " after it, frees it at the peak if the graph allows\n",
+               best->index, best->bytes, best->first, best->last, best->last, peak_op, best->first);
+    }
+    free(shown);
+}
+
+static void viz_svg(FILE *f, const viz_plan_t *plan, uint32_t scale_bytes)
+{
+    double cell = VIZ_PLOT_WIDTH / (double)((plan->ops != 0) ? plan->ops : 1U);
+    double scale = VIZ_PLOT_HEIGHT / (double)((scale_bytes != 0) ? scale_bytes : 1U);
+
+    fprintf(f, "<h2>%s plan: %" PRIu32 " bytes</h2>\n", plan->name, plan->peak);
+    fprintf(f, "<svg width=\"%.0f\" height=\"%.0f\" style=\"border:1px solid #888\">\n", VIZ_PLOT_WIDTH, VIZ_PLOT_HEIGHT);
+    for(uint32_t i = 0; i < plan->count; i++)
+    {
+        const viz_tensor_t *t = &plan->tensors[i];
+        double h = (double)t->bytes * scale;
+
+        fprintf(f, "<rect x=\"%.2f\" y=\"%.2f\" width=\"%.2f\" height=\"%.2f\" fill=\"hsl(%" PRIu32 ",65%%,55%%)\" stroke=\"#333\" stroke-width=\"0.3\">"
+                   "<title>tensor %" PRId32 ": offset %" PRIu32 ", %" PRIu32 " bytes, ops %" PRIu32 "..%" PRIu32 "</title></rect>\n",
+                (double)t->first * cell, VIZ_PLOT_HEIGHT - (double)t->offset * scale - h,
+                (double)(t->last - t->first + 1U) * cell, (h < 1.0) ? 1.0 : h, ((uint32_t)t->index * 47U) % 360U,
+                t->index, t->offset, t->bytes, t->first, t->last);
+    }
+    /* Live bytes per op, the lower bound of any plan */
+    fprintf(f, "<polyline fill=\"none\" stroke=\"black\" stroke-dasharray=\"4,2\" points=\"");
+    for(uint32_t op = 0; op < plan->ops; op++)
+    {
+        double y = VIZ_PLOT_HEIGHT - (double)viz_live_bytes(plan, op) * scale;
+        fprintf(f, "%.2f,%.2f %.2f,%.2f ", (double)op * cell, y, (double)(op + 1U) * cell, y);
+    }
+    fprintf(f, "\"/>\n</svg>\n");
+}
+
+static bool viz_html(const char *path, const viz_plan_t *current, const viz_plan_t *best, uint32_t live_peak)
+{
+    uint32_t scale_bytes = current->peak;
+    FILE *f = fopen(path, "w");
+
+    if(f == NULL)
+    {
+        return false;
+    }
+    fprintf(f, "<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\"><title>Arena memory plan</title></head>\n"
+               "<body style=\"font-family:sans-serif\">\n<h1>Arena memory plan</h1>\n"
+               "<p>x: operator, y: arena offset. The dashed line gives the live bytes per operator, "
+               "the lower bound of any plan (%" PRIu32 " bytes at the peak).</p>\n", live_peak);
+    viz_svg(f, current, scale_bytes);
+    if(best != NULL)
+    {
+        viz_svg(f, best, scale_bytes);
+    }
+    fprintf(f, "</body></html>\n");
+    return fclose(f) == 0;
+}
+
+/*******************************************************************************
+ * Main
+*******************************************************************************/
+int main(int argc, char **argv)
+{
+    static const struct option options[] =
+    {
+        { "model",      required_argument, NULL, 'm' },
+        { "arena",      required_argument, NULL, 'a' },
+        { "save",       required_argument, NULL, 's' },
+        { "csv",        required_argument, NULL, 'c' },
+        { "html",       required_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    static const struct
+    {
+        const char *name;
+        viz_order_t order;
+    } planners[] =
+    {
+        { "greedy by size", viz_by_size },
+        { "greedy by first use", viz_by_first_use },
+        { "greedy by lifetime", viz_by_lifetime },
+    };
+    const char *model_path = NULL, *csv_path = NULL, *html_path = NULL, *save_path = NULL;
+    unsigned long arena_size = 1024UL * 1024UL;
+    mtb_ml_memory_report_t report;
+    mtb_ml_tensor_memory_t *tensors = NULL;
+    viz_plan_t current, alternative, best;
+    bool have_report = false, have_best = false;
+    uint32_t count = 0, live_peak, peak_op;
+    int opt;
+
+    while((opt = getopt_long(argc, argv, "", options, NULL)) != -1)
+    {
+        switch(opt)
+        {
+            case 'm': model_path = optarg; break;
+            case 'a': arena_size = strtoul(optarg, NULL, 0); break;
+            case 's': save_path = optarg; break;
+            case 'c': csv_path = optarg; break;
+            case 'h': html_path = optarg; break;
+            default: viz_usage();
+        }
+    }
+    if((model_path == NULL) == (csv_path == NULL) || arena_size == 0 || arena_size > INT32_MAX)
+    {
+        viz_usage();
+    }
+
+    if(model_path != NULL)
+    {
+#if defined(MTB_ML_ARENA_VIZ_MODEL)
+        if(mtb_ml_init(0) != MTB_ML_RESULT_SUCCESS)
+        {
+            return 1;
+        }
+        tensors = viz_read_model(model_path, (int)arena_size, save_path, &report, &count);
+        have_report = true;
+#else
+        (void)save_path;
+        fprintf(stderr, "ERROR: built without tflite-micro, use --csv with a saved memory report\n");
+        return 1;
+#endif
+    }
+    else
+    {
+        tensors = viz_read_csv(csv_path, &count);
+    }
+    if(tensors == NULL || !viz_plan_from_report(have_report ? &report : NULL, tensors, count, &current))
+    {
+        free(tensors);
+        return 1;
+    }
+
+    viz_print_tensors(tensors, count);
+    if(have_report)
+    {
+        printf("\n");
+        mtb_ml_utils_print_memory_report(&report, NULL, 0);
+    }
+
+    peak_op = viz_peak_op(&current, &live_peak);
+    printf("\nplanned tensors=%" PRIu32 ", operators=%" PRIu32 ", plan peak=%" PRIu32 " bytes, live peak=%" PRIu32
+           " bytes at op %" PRIu32 ", wasted=%" PRIu32 " bytes\n",
+           current.count, current.ops, current.peak, live_peak, peak_op,
+           (current.peak > live_peak) ? current.peak - live_peak : 0U);
+    viz_print_gaps(&current);
+
+    printf("\noffline planners:\n");
+    for(uint32_t p = 0; p < sizeof(planners) / sizeof(planners[0]); p++)
+    {
+        if(!viz_plan_greedy(&current, planners[p].order, planners[p].name, &alternative))
+        {
+            break;
+        }
+        printf("  %-20s peak=%-9" PRIu32 " %s\n", alternative.name, alternative.peak,
+               (alternative.peak < current.peak) ? "lower than the current plan" : "");
+        if(alternative.peak < current.peak && (!have_best || alternative.peak < best.peak))
+        {
+            if(have_best)
+            {
+                free(best.tensors);
+            }
+            best = alternative;
+            have_best = true;
+        }
+        else
+        {
+            free(alternative.tensors);
+        }
+    }
+    if(have_best)
+    {
+        printf("  %s saves %" PRIu32 " bytes\n", best.name, current.peak - best.peak);
+    }
+    viz_print_reorderings(&current, peak_op);
+
+    if(html_path != NULL && !viz_html(html_path, &current, have_best ? &best : NULL, live_peak))
+    {
+        fprintf(stderr, "ERROR: cannot write %s\n", html_path);
+    }
+    if(have_best)
+    {
+        free(best.tensors);
+    }
+    free(current.tensors);
+    free(tensors);
+    return 0;
+}
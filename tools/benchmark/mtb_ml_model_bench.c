@@ -0,0 +1,311 @@
+/***************************************************************************//**
+* \file mtb_ml_model_bench.c
+*
+* \brief
+* End-to-end benchmark of a model. Times are counted with
+* mtb_ml_model_profile_get_tsc() and converted with mtb_ml_cpu_clk_freq.
+*
+* The heap use is sampled with mallinfo() after each phase, where the C library
+* provides it, so short-lived allocations within a phase are not seen.
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "mtb_ml.h"
+#include "mtb_ml_model_bench.h"
+
+#if defined(__GLIBC__) || defined(__NEWLIB__)
+#include <malloc.h>
+#define BENCH_HAVE_MALLINFO         (1)
+#else
+#define BENCH_HAVE_MALLINFO         (0)
+#endif
+
+/*******************************************************************************
+ * Typedefs
+*******************************************************************************/
+typedef struct
+{
+    const char *key;            /* JSON key */
+    size_t offset;              /* Offset in mtb_ml_model_bench_result_t */
+    bool is_float;              /* float, else int32_t */
+    bool higher_is_better;      /* Regresses when smaller */
+} bench_metric_t;
+
+/*******************************************************************************
+ * Private variables
+*******************************************************************************/
+static const bench_metric_t bench_metrics[] =
+{
+    { "init_us",      offsetof(mtb_ml_model_bench_result_t, init_us),      true,  false },
+    { "alloc_us",     offsetof(mtb_ml_model_bench_result_t, alloc_us),     true,  false },
+    { "first_run_us", offsetof(mtb_ml_model_bench_result_t, first_run_us), true,  false },
+    { "p50_us",       offsetof(mtb_ml_model_bench_result_t, p50_us),       true,  false },
+    { "p99_us",       offsetof(mtb_ml_model_bench_result_t, p99_us),       true,  false },
+    { "max_us",       offsetof(mtb_ml_model_bench_result_t, max_us),       true,  false },
+    { "throughput",   offsetof(mtb_ml_model_bench_result_t, throughput),   true,  true  },
+    { "arena_used",   offsetof(mtb_ml_model_bench_result_t, arena_used),   false, false },
+    { "arena_size",   offsetof(mtb_ml_model_bench_result_t, arena_size),   false, false },
+    { "heap_peak",    offsetof(mtb_ml_model_bench_result_t, heap_peak),    false, false },
+};
+
+#define BENCH_METRICS_NUM           (sizeof(bench_metrics) / sizeof(bench_metrics[0]))
+
+/*******************************************************************************
+ * Private Functions
+*******************************************************************************/
+static float bench_us(uint64_t cycles)
+{
+    return (float)((double)cycles * 1e6 / (double)mtb_ml_cpu_clk_freq);
+}
+
+static void bench_sample_heap(mtb_ml_model_bench_result_t *result)
+{
+#if (BENCH_HAVE_MALLINFO == 1)
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || (__GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+#else
+    struct mallinfo info = mallinfo();
+#endif
+    if((int32_t)info.uordblks > result->heap_peak)
+    {
+        result->heap_peak = (int32_t)info.uordblks;
+    }
+#else
+    (void)result;
+#endif
+}
+
+static int bench_compare_cycles(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static float bench_metric_value(const mtb_ml_model_bench_result_t *result, const bench_metric_t *metric)
+{
+    const uint8_t *field = (const uint8_t *)result + metric->offset;
+
+    return metric->is_float ? *(const float *)field : (float)*(const int32_t *)field;
+}
+
+/* Value of "key": number in a flat JSON object */
+static bool bench_json_number(const char *json, const char *key, float *value)
+{
+    char pattern[32];
+    const char *p;
+    char *end;
+
+    snprintf(pattern, sizeof(pattern), "\"%s\"", key);
+    p = strstr(json, pattern);
+    if(p == NULL)
+    {
+        return false;
+    }
+    p += strlen(pattern);
+    while((*p == ' ') || (*p == ':'))
+    {
+        p++;
+    }
+    *value = strtof(p, &end);
+    return end != p;
+}
+
+/* Input of run i: samples in turn, slice by slice for streaming RNN */
+static MTB_ML_DATA_T *bench_input(mtb_ml_dataset_t *dataset, mtb_ml_model_t *model, uint32_t i)
+{
+    const void *x;
+    uint32_t frames;
+
+    if((dataset == NULL) || (dataset->num_samples == 0))
+    {
+        return model->input;
+    }
+    frames = dataset->num_samples * dataset->slices;
+    i %= frames;
+    (void)mtb_ml_dataset_get_slice(dataset, i / dataset->slices, i % dataset->slices, &x);
+    return (MTB_ML_DATA_T *)x;
+}
+
+/*******************************************************************************
+ * Public Functions
+*******************************************************************************/
+cy_rslt_t mtb_ml_model_bench_run(const mtb_ml_model_bin_t *bin, const mtb_ml_model_buffer_t *buffer,
+                                 mtb_ml_dataset_t *dataset, const mtb_ml_model_bench_config_t *config,
+                                 mtb_ml_model_bench_result_t *result)
+{
+    mtb_ml_model_t *model = NULL;
+    uint64_t *cycles;
+    uint64_t start = 0, end = 0, sum = 0;
+    cy_rslt_t rslt;
+
+    if((bin == NULL) || (config == NULL) || (config->runs == 0) || (result == NULL) || (mtb_ml_cpu_clk_freq == 0))
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    memset(result, 0, sizeof(*result));
+    result->heap_peak = (BENCH_HAVE_MALLINFO == 1) ? 0 : -1;
+    cycles = (uint64_t *)malloc(config->runs * sizeof(uint64_t));
+    if(cycles == NULL)
+    {
+        return MTB_ML_RESULT_ALLOC_ERR;
+    }
+    bench_sample_heap(result);
+
+    mtb_ml_model_profile_get_tsc(&start);
+    rslt = mtb_ml_model_init(bin, buffer, &model);
+    mtb_ml_model_profile_get_tsc(&end);
+    if(rslt != MTB_ML_RESULT_SUCCESS)
+    {
+        free(cycles);
+        return rslt;
+    }
+    bench_sample_heap(result);
+    memcpy(result->name, model->name, sizeof(result->name));
+    result->init_us = bench_us(end - start);
+    result->alloc_us = bench_us(model->m_alloc_cycles);
+    result->arena_used = model->buffer_size;
+    result->arena_size = ((buffer != NULL) && (buffer->tensor_arena_size != 0)) ? (int32_t)buffer->tensor_arena_size
+                                                                                : (int32_t)bin->arena_size;
+    if(dataset != NULL)
+    {
+        rslt = mtb_ml_dataset_validate(dataset, model);
+    }
+
+    /* First inference, then warm-up and measured runs */
+    for(uint32_t i = 0; (rslt == MTB_ML_RESULT_SUCCESS) && (i < 1 + config->warmup_runs + config->runs); i++)
+    {
+        MTB_ML_DATA_T *input = bench_input(dataset, model, i);
+
+        mtb_ml_model_profile_get_tsc(&start);
+        rslt = mtb_ml_model_run(model, input);
+        mtb_ml_model_profile_get_tsc(&end);
+        if(i == 0)
+        {
+            result->first_run_us = bench_us(end - start);
+            bench_sample_heap(result);
+        }
+        else if(i > config->warmup_runs)
+        {
+            cycles[i - 1 - config->warmup_runs] = end - start;
+            sum += end - start;
+        }
+    }
+    bench_sample_heap(result);
+    mtb_ml_model_deinit(model);
+    if(rslt != MTB_ML_RESULT_SUCCESS)
+    {
+        free(cycles);
+        return rslt;
+    }
+
+    qsort(cycles, config->runs, sizeof(uint64_t), bench_compare_cycles);
+    result->runs = config->runs;
+    result->p50_us = bench_us(cycles[(config->runs - 1) / 2]);
+    result->p99_us = bench_us(cycles[(uint32_t)((uint64_t)(config->runs - 1) * 99 / 100)]);
+    result->max_us = bench_us(cycles[config->runs - 1]);
+    result->throughput = (sum != 0) ? (float)((double)config->runs * mtb_ml_cpu_clk_freq / (double)sum) : 0.0f;
+    free(cycles);
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+void mtb_ml_model_bench_write_json(const mtb_ml_model_bench_result_t *result, FILE *out)
+{
+    if((result == NULL) || (out == NULL))
+    {
+        return;
+    }
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"model\": \"%s\",\n", result->name);
+    fprintf(out, "  \"library_version\": \"%d.%d.%d\",\n", MTB_ML_MIDDLEWARE_VERSION_MAJOR,
+            MTB_ML_MIDDLEWARE_VERSION_MINOR, MTB_ML_MIDDLEWARE_VERSION_PATCH);
+    fprintf(out, "  \"cpu_clk_freq\": %" PRIu32 ",\n", mtb_ml_cpu_clk_freq);
+    fprintf(out, "  \"runs\": %" PRIu32 ",\n", result->runs);
+    for(size_t i = 0; i < BENCH_METRICS_NUM; i++)
+    {
+        if(bench_metrics[i].is_float)
+        {
+            fprintf(out, "  \"%s\": %.3f%s\n", bench_metrics[i].key, bench_metric_value(result, &bench_metrics[i]),
+                    (i + 1 < BENCH_METRICS_NUM) ? "," : "");
+        }
+        else
+        {
+            fprintf(out, "  \"%s\": %d%s\n", bench_metrics[i].key, (int)bench_metric_value(result, &bench_metrics[i]),
+                    (i + 1 < BENCH_METRICS_NUM) ? "," : "");
+        }
+    }
+    fprintf(out, "}\n");
+}
+
+int mtb_ml_model_bench_compare(const mtb_ml_model_bench_result_t *result, const char *baseline,
+                               float tolerance, FILE *out)
+{
+    int regressions = 0;
+
+    if((result == NULL) || (baseline == NULL) || (out == NULL))
+    {
+        return -1;
+    }
+
+    for(size_t i = 0; i < BENCH_METRICS_NUM; i++)
+    {
+        const bench_metric_t *metric = &bench_metrics[i];
+        float value = bench_metric_value(result, metric);
+        float base;
+        bool regressed;
+
+        if(!bench_json_number(baseline, metric->key, &base))
+        {
+            fprintf(out, "ERROR: baseline has no %s\n", metric->key);
+            return -1;
+        }
+        /* Unknown heap use is not compared */
+        if((value < 0.0f) || (base < 0.0f))
+        {
+            continue;
+        }
+        regressed = metric->higher_is_better ? (value < base * (1.0f - tolerance))
+                                             : (value > base * (1.0f + tolerance));
+        fprintf(out, "%-14s %14.3f %14.3f %+8.2f%%%s\n", metric->key, base, value,
+                (base != 0.0f) ? (value - base) * 100.0f / base : 0.0f, regressed ? "  REGRESSION" : "");
+        if(regressed)
+        {
+            regressions++;
+        }
+    }
+    return regressions;
+}
@@ -0,0 +1,135 @@
+/***************************************************************************//**
+* \file mtb_ml_model_bench.h
+*
+* \brief
+* End-to-end benchmark of a model: initialization, tensor allocation, first
+* inference and steady-state latency, arena and heap usage. The same code runs
+* on the host (mtb_ml_model_bench_main.c) and on the target.
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#if !defined(__MTB_ML_MODEL_BENCH_H__)
+#define __MTB_ML_MODEL_BENCH_H__
+
+#include <stdio.h>
+#include "mtb_ml_common.h"
+#include "mtb_ml_model.h"
+#include "mtb_ml_dataset_reader.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Structures
+******************************************************************************/
+/**
+ * Model benchmark configuration
+ */
+typedef struct
+{
+    uint32_t warmup_runs;       /**< Inferences after the first one, not measured */
+    uint32_t runs;              /**< Measured inferences */
+} mtb_ml_model_bench_config_t;
+
+/**
+ * Model benchmark result, times in microseconds
+ */
+typedef struct
+{
+    char name[MTB_ML_MODEL_NAME_LEN];   /**< Model name */
+    float init_us;              /**< mtb_ml_model_init() */
+    float alloc_us;             /**< Tensor allocation within mtb_ml_model_init() */
+    float first_run_us;         /**< First inference */
+    float p50_us;               /**< Median of the measured inferences */
+    float p99_us;               /**< 99th percentile of the measured inferences */
+    float max_us;               /**< Slowest measured inference */
+    float throughput;           /**< Inferences per second */
+    uint32_t runs;              /**< Measured inferences */
+    int32_t arena_used;         /**< Tensor arena bytes used */
+    int32_t arena_size;         /**< Tensor arena bytes provisioned */
+    int32_t heap_peak;          /**< Highest heap use sampled between the phases, -1 if unknown */
+} mtb_ml_model_bench_result_t;
+
+/*******************************************************************************
+ * Function Prototypes
+*******************************************************************************/
+/**
+ * \brief : Initializes a model, runs it and deletes it again, measuring every phase.
+ *          mtb_ml_init() must be called first.
+ *
+ * \param[in]   bin         : Model binary.
+ * \param[in]   buffer      : Tensor arena, see mtb_ml_model_init(). Optional.
+ * \param[in]   dataset     : Input samples, used in turn (time step slices for streaming
+ *                            RNN). Optional, a zero input is used without.
+ * \param[in]   config      : Benchmark configuration.
+ * \param[out]  result      : Benchmark result.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ *                          : MTB_ML_RESULT_ALLOC_ERR - if memory allocation failure.
+ *                          : otherwise - error of mtb_ml_model_init(), mtb_ml_dataset_validate() or
+ *                                        mtb_ml_model_run().
+ */
+cy_rslt_t mtb_ml_model_bench_run(const mtb_ml_model_bin_t *bin, const mtb_ml_model_buffer_t *buffer,
+                                 mtb_ml_dataset_t *dataset, const mtb_ml_model_bench_config_t *config,
+                                 mtb_ml_model_bench_result_t *result);
+
+/**
+ * \brief : Writes a benchmark result as JSON.
+ *
+ * \param[in]   result      : Benchmark result.
+ * \param[in]   out         : Output stream.
+ */
+void mtb_ml_model_bench_write_json(const mtb_ml_model_bench_result_t *result, FILE *out);
+
+/**
+ * \brief : Compares a benchmark result with a baseline written by mtb_ml_model_bench_write_json().
+ *          Times, arena and heap regress when larger, the throughput when smaller, than the
+ *          baseline by more than the tolerance.
+ *
+ * \param[in]   result      : Benchmark result.
+ * \param[in]   baseline    : Baseline JSON text.
+ * \param[in]   tolerance   : Allowed relative change, e.g. 0.05 for 5 %.
+ * \param[in]   out         : Output stream of the comparison report.
+ *
+ * \return                  : Number of regressions, -1 if the baseline cannot be parsed.
+ */
+int mtb_ml_model_bench_compare(const mtb_ml_model_bench_result_t *result, const char *baseline,
+                               float tolerance, FILE *out);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __MTB_ML_MODEL_BENCH_H__ */
@@ -0,0 +1,198 @@
+/***************************************************************************//**
+* \file mtb_ml_model_bench_main.c
+*
+* \brief
+* Host runner of the end-to-end model benchmark. The model file is memory
+* mapped, see mtb_ml_model_bin_from_file().
+*
+* Usage:
+*   mtb_ml_model_bench --model MODEL_FILE --arena BYTES [-x X_FILE] [--runs N]
+*                      [--warmup N] [-o JSON_FILE] [--baseline JSON_FILE]
+*                      [--tolerance PERCENT]
+*
+* With --baseline the exit code is 3 when a metric regressed by more than the
+* tolerance (5 % by default).
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include "mtb_ml.h"
+#include "mtb_ml_model_bench.h"
+
+#if !defined(COMPONENT_ML_TFLM)
+#error "mtb_ml_model_bench loads the model from a file and requires COMPONENT_ML_TFLM"
+#endif
+
+#define BENCH_EXIT_REGRESSION       (3)
+
+/*******************************************************************************
+ * Private Functions
+*******************************************************************************/
+static char *bench_load_file(const char *path, size_t *size)
+{
+    FILE *f = fopen(path, "rb");
+    char *data = NULL;
+    long end;
+
+    if((f == NULL) || (fseek(f, 0, SEEK_END) != 0) || ((end = ftell(f)) < 0))
+    {
+        fprintf(stderr, "ERROR: cannot read %s\n", path);
+        exit(1);
+    }
+    *size = (size_t)end;
+    data = malloc(*size + 1);
+    fseek(f, 0, SEEK_SET);
+    if((data == NULL) || (fread(data, 1, *size, f) != *size))
+    {
+        fprintf(stderr, "ERROR: cannot read %s\n", path);
+        exit(1);
+    }
+    data[*size] = '\0';
+    fclose(f);
+    return data;
+}
+
+static void bench_usage(void)
+{
+    fprintf(stderr, "usage: mtb_ml_model_bench --model MODEL_FILE --arena BYTES [-x X_FILE] [--runs N] [--warmup N] "
+                    "[-o JSON_FILE] [--baseline JSON_FILE] [--tolerance PERCENT]\n");
+    exit(2);
+}
+
+/*******************************************************************************
+ * Main
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    static const struct option options[] =
+    {
+        { "model",     required_argument, NULL, 'm' },
+        { "arena",     required_argument, NULL, 'a' },
+        { "runs",      required_argument, NULL, 'r' },
+        { "warmup",    required_argument, NULL, 'w' },
+        { "baseline",  required_argument, NULL, 'b' },
+        { "tolerance", required_argument, NULL, 't' },
+        { NULL, 0, NULL, 0 }
+    };
+    const char *model_path = NULL, *x_path = NULL, *out_path = NULL, *baseline_path = NULL;
+    mtb_ml_model_bench_config_t config = { .warmup_runs = 10, .runs = 100 };
+    mtb_ml_model_bench_result_t result;
+    mtb_ml_dataset_t dataset;
+    float tolerance = 5.0f;
+    long arena_size = 0;
+    mtb_ml_model_bin_t *model_bin;
+    FILE *out = stdout;
+    cy_rslt_t rslt;
+    int opt, ret = 0;
+
+    while((opt = getopt_long(argc, argv, "x:o:", options, NULL)) != -1)
+    {
+        switch(opt)
+        {
+            case 'm': model_path = optarg; break;
+            case 'a': arena_size = strtol(optarg, NULL, 0); break;
+            case 'r': config.runs = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'w': config.warmup_runs = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'b': baseline_path = optarg; break;
+            case 't': tolerance = strtof(optarg, NULL); break;
+            case 'x': x_path = optarg; break;
+            case 'o': out_path = optarg; break;
+            default: bench_usage();
+        }
+    }
+    if((model_path == NULL) || (arena_size <= 0) || (config.runs == 0))
+    {
+        bench_usage();
+    }
+
+    rslt = mtb_ml_model_bin_from_file(model_path, (int)arena_size, &model_bin);
+    if(rslt != MTB_ML_RESULT_SUCCESS)
+    {
+        fprintf(stderr, "ERROR: cannot load model %s (0x%x)\n", model_path, (unsigned int)rslt);
+        return 1;
+    }
+    if((x_path != NULL) && (mtb_ml_dataset_open_files(&dataset, x_path, NULL) != MTB_ML_RESULT_SUCCESS))
+    {
+        return 1;
+    }
+
+    if(mtb_ml_init(0) != MTB_ML_RESULT_SUCCESS)
+    {
+        return 1;
+    }
+    rslt = mtb_ml_model_bench_run(model_bin, NULL, (x_path != NULL) ? &dataset : NULL, &config, &result);
+    if(rslt != MTB_ML_RESULT_SUCCESS)
+    {
+        fprintf(stderr, "ERROR: mtb_ml_model_bench_run failed (0x%x)\n", (unsigned int)rslt);
+        return 1;
+    }
+
+    if((out_path != NULL) && ((out = fopen(out_path, "w")) == NULL))
+    {
+        perror(out_path);
+        return 1;
+    }
+    mtb_ml_model_bench_write_json(&result, out);
+    if(out != stdout)
+    {
+        fclose(out);
+    }
+
+    if(baseline_path != NULL)
+    {
+        size_t baseline_size;
+        char *baseline = bench_load_file(baseline_path, &baseline_size);
+        int regressions = mtb_ml_model_bench_compare(&result, baseline, tolerance / 100.0f, stderr);
+
+        if(regressions < 0)
+        {
+            fprintf(stderr, "ERROR: invalid baseline %s\n", baseline_path);
+            ret = 1;
+        }
+        else if(regressions > 0)
+        {
+            fprintf(stderr, "%d regression(s) against %s\n", regressions, baseline_path);
+            ret = BENCH_EXIT_REGRESSION;
+        }
+        free(baseline);
+    }
+
+    if(x_path != NULL)
+    {
+        mtb_ml_dataset_close(&dataset);
+    }
+    mtb_ml_model_bin_free(model_bin);
+    return ret;
+}
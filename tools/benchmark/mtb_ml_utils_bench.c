@@ -0,0 +1,297 @@
+/***************************************************************************//**
+* \file mtb_ml_utils_bench.c
+*
+* \brief
+* Benchmarks of the mtb_ml_utils hot paths. Each kernel is run over element
+* counts of min_count to max_count, for each data type and for aligned and
+* unaligned buffers, until min_cycles are measured.
+*
+* Aligned buffers start on a 32-byte boundary (cache line and SIMD width),
+* unaligned buffers one element after it, which keeps the natural alignment
+* of the data type.
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "mtb_ml.h"
+#include "mtb_ml_utils_bench.h"
+
+/*******************************************************************************
+ * Macros
+*******************************************************************************/
+#define BENCH_ALIGN                 (32U)
+
+/* Measurement of 0.1 s when config->min_cycles is 0 */
+#define BENCH_DEFAULT_CYCLES_DIV    (10U)
+
+/*******************************************************************************
+ * Typedefs
+*******************************************************************************/
+typedef enum
+{
+    BENCH_QUANTIZE,
+    BENCH_DEQUANTIZE,
+    BENCH_FIND_MAX,
+    BENCH_INPUT_DELTA,
+} bench_kernel_t;
+
+typedef struct
+{
+    bench_kernel_t kernel;
+    const char *name;
+    const char *type;
+    int type_size;
+} bench_case_t;
+
+/*******************************************************************************
+ * Private variables
+*******************************************************************************/
+static const bench_case_t bench_cases[] =
+{
+    /* Quantization of float input data, the float model input is not converted */
+    { BENCH_QUANTIZE,   "quantize",   "int8",    sizeof(int8_t)  },
+    { BENCH_QUANTIZE,   "quantize",   "int16",   sizeof(int16_t) },
+    { BENCH_DEQUANTIZE, "dequantize", "int8",    sizeof(int8_t)  },
+    { BENCH_DEQUANTIZE, "dequantize", "int16",   sizeof(int16_t) },
+    { BENCH_DEQUANTIZE, "dequantize", "float32", sizeof(float)   },
+    { BENCH_FIND_MAX,   "find_max",   "int8",    sizeof(int8_t)  },
+    { BENCH_FIND_MAX,   "find_max",   "int16",   sizeof(int16_t) },
+    { BENCH_FIND_MAX,   "find_max",   "float32", sizeof(float)   },
+    /* Input-delta gate on an unchanged input, the full scan without early exit */
+    { BENCH_INPUT_DELTA, "input_delta", "int8",    sizeof(int8_t)  },
+    { BENCH_INPUT_DELTA, "input_delta", "int16",   sizeof(int16_t) },
+    { BENCH_INPUT_DELTA, "input_delta", "float32", sizeof(float)   },
+};
+
+static volatile int bench_sink;
+
+/*******************************************************************************
+ * Private Functions
+*******************************************************************************/
+static void bench_fill(uint8_t *data, int type_size, uint32_t count)
+{
+    uint32_t seed = 0x2545F491U;
+
+    for(uint32_t i = 0; i < count; i++)
+    {
+        seed = seed * 1664525U + 1013904223U;
+        switch(type_size)
+        {
+            case sizeof(int8_t):
+                ((int8_t *)data)[i] = (int8_t)(seed >> 24);
+                break;
+            case sizeof(int16_t):
+                ((int16_t *)data)[i] = (int16_t)(seed >> 16);
+                break;
+            default:
+                ((float *)data)[i] = (float)(int32_t)seed / 2147483648.0f;
+                break;
+        }
+    }
+}
+
+static void bench_iteration(const bench_case_t *bench, mtb_ml_model_t *model, uint8_t *data,
+                            float *values, uint32_t count)
+{
+    switch(bench->kernel)
+    {
+        case BENCH_QUANTIZE:
+            (void)mtb_ml_utils_model_quantize(model, values, (MTB_ML_DATA_T *)data);
+            break;
+        case BENCH_DEQUANTIZE:
+            (void)mtb_ml_utils_model_dequantize(model, values);
+            break;
+        case BENCH_FIND_MAX:
+            switch(bench->type_size)
+            {
+                case sizeof(int8_t):
+                    bench_sink = mtb_ml_utils_find_max_int8((const int8_t *)data, (int)count);
+                    break;
+                case sizeof(int16_t):
+                    bench_sink = mtb_ml_utils_find_max_int16((const int16_t *)data, (int)count);
+                    break;
+                default:
+                    bench_sink = mtb_ml_utils_find_max_flt((const float *)data, (int)count);
+                    break;
+            }
+            break;
+        case BENCH_INPUT_DELTA:
+            switch(bench->type_size)
+            {
+                case sizeof(int8_t):
+                    bench_sink = (int)mtb_ml_utils_input_delta_int8((const int8_t *)data, (const int8_t *)values,
+                                                                    (int)count, MTB_ML_INPUT_DELTA_L1, 0U);
+                    break;
+                case sizeof(int16_t):
+                    bench_sink = (int)mtb_ml_utils_input_delta_int16((const int16_t *)data, (const int16_t *)values,
+                                                                     (int)count, MTB_ML_INPUT_DELTA_L1, 0U);
+                    break;
+                default:
+                    bench_sink = (int)mtb_ml_utils_input_delta_flt((const float *)data, values,
+                                                                   (int)count, MTB_ML_INPUT_DELTA_L1, 0.0f);
+                    break;
+            }
+            break;
+    }
+}
+
+static void bench_measure(const bench_case_t *bench, bool aligned, uint32_t count, uint64_t min_cycles,
+                          uint8_t *data_buf, float *values_buf, bool *first, FILE *out)
+{
+    static mtb_ml_model_t model;
+    uint8_t *data = data_buf + (aligned ? 0 : bench->type_size);
+    float *values = values_buf + (aligned ? 0 : 1);
+    uint64_t start, end, cycles = 0, iterations = 1, done = 0;
+    char name[64];
+    double ns;
+
+    memset(&model, 0, sizeof(model));
+    model.input_size = (int)count;
+    model.input_type_size = bench->type_size;
+    model.input_scale = 1.0f / 64.0f;
+    model.input_zero_point = 3;
+    model.output_size = (int)count;
+    model.output_type_size = bench->type_size;
+    model.output_scale = 1.0f / 64.0f;
+    model.output_zero_point = 3;
+    model.output = (MTB_ML_DATA_T *)data;
+
+    bench_fill(data, bench->type_size, count);
+    bench_fill((uint8_t *)values, sizeof(float), count);
+    if(bench->kernel == BENCH_INPUT_DELTA)
+    {
+        memcpy(values, data, (size_t)count * (size_t)bench->type_size);
+    }
+
+    /* Warm-up, then doubling runs until min_cycles are measured */
+    bench_iteration(bench, &model, data, values, count);
+    while(cycles < min_cycles)
+    {
+        mtb_ml_model_profile_get_tsc(&start);
+        for(uint64_t i = 0; i < iterations; i++)
+        {
+            bench_iteration(bench, &model, data, values, count);
+        }
+        mtb_ml_model_profile_get_tsc(&end);
+        cycles += end - start;
+        done += iterations;
+        iterations *= 2;
+    }
+
+    snprintf(name, sizeof(name), "BM_%s/%s/%s/%" PRIu32, bench->name, bench->type,
+             aligned ? "aligned" : "unaligned", count);
+    ns = (double)cycles * 1e9 / (double)mtb_ml_cpu_clk_freq / (double)done;
+    fprintf(out, "%s    {\n", *first ? "" : ",\n");
+    fprintf(out, "      \"name\": \"%s\",\n", name);
+    fprintf(out, "      \"run_name\": \"%s\",\n", name);
+    fprintf(out, "      \"run_type\": \"iteration\",\n");
+    fprintf(out, "      \"iterations\": %" PRIu64 ",\n", done);
+    fprintf(out, "      \"real_time\": %.3f,\n", ns);
+    fprintf(out, "      \"cpu_time\": %.3f,\n", ns);
+    fprintf(out, "      \"time_unit\": \"ns\",\n");
+    fprintf(out, "      \"elements\": %" PRIu32 ",\n", count);
+    fprintf(out, "      \"cycles_per_element\": %.4f\n", (double)cycles / (double)done / (double)count);
+    fprintf(out, "    }");
+    *first = false;
+}
+
+/*******************************************************************************
+ * Public Functions
+*******************************************************************************/
+cy_rslt_t mtb_ml_utils_bench_run(const mtb_ml_utils_bench_config_t *config, FILE *out)
+{
+    /* Room for float elements and the unaligned offset */
+    size_t bytes;
+    uint8_t *data_mem, *values_mem;
+    uint8_t *data_buf;
+    float *values_buf;
+    uint64_t min_cycles;
+    bool first = true;
+
+    if((config == NULL) || (out == NULL) || (config->min_count == 0) || (config->max_count < config->min_count) ||
+       (mtb_ml_cpu_clk_freq == 0))
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    bytes = ((size_t)config->max_count + 1) * sizeof(float) + BENCH_ALIGN;
+    data_mem = malloc(bytes);
+    values_mem = malloc(bytes);
+    if((data_mem == NULL) || (values_mem == NULL))
+    {
+        free(data_mem);
+        free(values_mem);
+        return MTB_ML_RESULT_ALLOC_ERR;
+    }
+    data_buf = (uint8_t *)(((uintptr_t)data_mem + BENCH_ALIGN - 1) & ~(uintptr_t)(BENCH_ALIGN - 1));
+    values_buf = (float *)(((uintptr_t)values_mem + BENCH_ALIGN - 1) & ~(uintptr_t)(BENCH_ALIGN - 1));
+    min_cycles = (config->min_cycles != 0) ? config->min_cycles : mtb_ml_cpu_clk_freq / BENCH_DEFAULT_CYCLES_DIV;
+
+    fprintf(out, "{\n  \"context\": {\n");
+    fprintf(out, "    \"library\": \"mtb_ml_utils\",\n");
+    fprintf(out, "    \"library_version\": \"%d.%d.%d\",\n", MTB_ML_MIDDLEWARE_VERSION_MAJOR,
+            MTB_ML_MIDDLEWARE_VERSION_MINOR, MTB_ML_MIDDLEWARE_VERSION_PATCH);
+    fprintf(out, "    \"cpu_clk_freq\": %" PRIu32 ",\n", mtb_ml_cpu_clk_freq);
+#if defined(COMPONENT_CMSIS_DSP)
+    fprintf(out, "    \"cmsis_dsp\": true\n");
+#else
+    fprintf(out, "    \"cmsis_dsp\": false\n");
+#endif
+    fprintf(out, "  },\n  \"benchmarks\": [\n");
+
+    for(size_t c = 0; c < sizeof(bench_cases) / sizeof(bench_cases[0]); c++)
+    {
+        for(int aligned = 1; aligned >= 0; aligned--)
+        {
+            for(uint64_t count = config->min_count; count <= config->max_count; count *= 10)
+            {
+                char name[64];
+
+                snprintf(name, sizeof(name), "BM_%s/%s/%s/", bench_cases[c].name, bench_cases[c].type,
+                         aligned ? "aligned" : "unaligned");
+                if((config->filter != NULL) && (strstr(name, config->filter) == NULL))
+                {
+                    continue;
+                }
+                bench_measure(&bench_cases[c], aligned != 0, (uint32_t)count, min_cycles,
+                              data_buf, values_buf, &first, out);
+            }
+        }
+    }
+    fprintf(out, "\n  ]\n}\n");
+
+    free(data_mem);
+    free(values_mem);
+    return MTB_ML_RESULT_SUCCESS;
+}
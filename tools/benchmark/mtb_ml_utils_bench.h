@@ -0,0 +1,85 @@
+/***************************************************************************//**
+* \file mtb_ml_utils_bench.h
+*
+* \brief
+* Benchmarks of the mtb_ml_utils hot paths: quantize, dequantize and find_max.
+* The same code runs on the host (mtb_ml_utils_bench_main.c) and on the target,
+* timed with mtb_ml_model_profile_get_tsc().
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#if !defined(__MTB_ML_UTILS_BENCH_H__)
+#define __MTB_ML_UTILS_BENCH_H__
+
+#include <stdio.h>
+#include "mtb_ml_common.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Structures
+******************************************************************************/
+/**
+ * Benchmark configuration
+ */
+typedef struct
+{
+    uint32_t min_count;         /**< Smallest element count, counts go up by decades */
+    uint32_t max_count;         /**< Largest element count */
+    uint64_t min_cycles;        /**< Minimum measured cycles of each benchmark, 0 for 0.1 s */
+    const char *filter;         /**< Runs the benchmarks whose name contains filter, NULL for all */
+} mtb_ml_utils_bench_config_t;
+
+/*******************************************************************************
+ * Function Prototypes
+*******************************************************************************/
+/**
+ * \brief : Runs the benchmarks and writes their results as Google Benchmark JSON,
+ *          with cycles_per_element as user counter. mtb_ml_init() must be called first.
+ *
+ * \param[in]   config      : Benchmark configuration.
+ * \param[in]   out         : Output stream of the JSON document.
+ *
+ * \return                  : MTB_ML_RESULT_SUCCESS - success
+ *                          : MTB_ML_RESULT_BAD_ARG - if input parameter is invalid.
+ *                          : MTB_ML_RESULT_ALLOC_ERR - if the buffers of max_count elements cannot be allocated.
+ */
+cy_rslt_t mtb_ml_utils_bench_run(const mtb_ml_utils_bench_config_t *config, FILE *out);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __MTB_ML_UTILS_BENCH_H__ */
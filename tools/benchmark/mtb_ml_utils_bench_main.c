@@ -0,0 +1,114 @@
+/***************************************************************************//**
+* \file mtb_ml_utils_bench_main.c
+*
+* \brief
+* Host runner of the mtb_ml_utils benchmarks.
+*
+* Usage:
+*   mtb_ml_utils_bench [--min-count N] [--max-count N] [--min-time-ms MS]
+*                      [--filter SUBSTRING] [-o JSON_FILE]
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include "mtb_ml.h"
+#include "mtb_ml_utils_bench.h"
+
+/*******************************************************************************
+ * Private Functions
+*******************************************************************************/
+static void bench_usage(void)
+{
+    fprintf(stderr, "usage: mtb_ml_utils_bench [--min-count N] [--max-count N] [--min-time-ms MS] "
+                    "[--filter SUBSTRING] [-o JSON_FILE]\n");
+    exit(2);
+}
+
+/*******************************************************************************
+ * Main
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    static const struct option options[] =
+    {
+        { "min-count",   required_argument, NULL, 'n' },
+        { "max-count",   required_argument, NULL, 'm' },
+        { "min-time-ms", required_argument, NULL, 't' },
+        { "filter",      required_argument, NULL, 'f' },
+        { NULL, 0, NULL, 0 }
+    };
+    mtb_ml_utils_bench_config_t config = { .min_count = 10, .max_count = 1000000, .min_cycles = 0, .filter = NULL };
+    const char *out_path = NULL;
+    unsigned long min_time_ms = 0;
+    FILE *out = stdout;
+    cy_rslt_t result;
+    int opt;
+
+    while((opt = getopt_long(argc, argv, "o:", options, NULL)) != -1)
+    {
+        switch(opt)
+        {
+            case 'n': config.min_count = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'm': config.max_count = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 't': min_time_ms = strtoul(optarg, NULL, 0); break;
+            case 'f': config.filter = optarg; break;
+            case 'o': out_path = optarg; break;
+            default: bench_usage();
+        }
+    }
+
+    if(mtb_ml_init(0) != MTB_ML_RESULT_SUCCESS)
+    {
+        return 1;
+    }
+    config.min_cycles = (uint64_t)min_time_ms * mtb_ml_cpu_clk_freq / 1000U;
+
+    if((out_path != NULL) && ((out = fopen(out_path, "w")) == NULL))
+    {
+        perror(out_path);
+        return 1;
+    }
+    result = mtb_ml_utils_bench_run(&config, out);
+    if(out != stdout)
+    {
+        fclose(out);
+    }
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        fprintf(stderr, "ERROR: mtb_ml_utils_bench_run failed (0x%x)\n", (unsigned int)result);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,274 @@
+/***************************************************************************//**
+* \file mtb_ml_npu_pm_test.c
+*
+* \brief
+* Host test of the NPU power manager against the simulated power controller:
+* acquire and release counting, idle timeout power down, suspend, time base
+* wrap and a state machine held by another task. Returns non-zero on failure.
+*
+* Usage:
+*   mtb_ml_npu_pm_test
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <stdint.h>
+#include "mtb_ml_npu_pm.h"
+#include "mtb_ml_npu_pm_sim.h"
+
+/*******************************************************************************
+ * Macros
+*******************************************************************************/
+#define TEST_IDLE_TIMEOUT_MS    (100u)
+
+#define TEST_CHECK(cond)                                                        \
+    do                                                                          \
+    {                                                                           \
+        if (!(cond))                                                            \
+        {                                                                       \
+            printf("FAIL %s:%d: %s\n", __func__, __LINE__, #cond);              \
+            test_failures++;                                                    \
+        }                                                                       \
+    } while (0)
+
+/*******************************************************************************
+ * Private variables
+*******************************************************************************/
+static int test_failures;
+static mtb_ml_npu_pm_sim_t test_sim;
+static mtb_ml_npu_pm_ops_t test_ops;
+static mtb_ml_npu_pm_t test_pm;
+
+/*******************************************************************************
+ * Private Functions
+*******************************************************************************/
+static void test_setup(uint32_t now_ms, uint32_t idle_timeout_ms)
+{
+    mtb_ml_npu_pm_sim_init(&test_sim, &test_ops, now_ms);
+    TEST_CHECK(mtb_ml_npu_pm_init(&test_pm, &test_ops, idle_timeout_ms) == MTB_ML_RESULT_SUCCESS);
+}
+
+static void test_bad_args(void)
+{
+    mtb_ml_npu_pm_ops_t ops = {0};
+
+    TEST_CHECK(mtb_ml_npu_pm_init(NULL, &test_ops, 0) == MTB_ML_RESULT_BAD_ARG);
+    TEST_CHECK(mtb_ml_npu_pm_init(&test_pm, NULL, 0) == MTB_ML_RESULT_BAD_ARG);
+    TEST_CHECK(mtb_ml_npu_pm_init(&test_pm, &ops, 0) == MTB_ML_RESULT_BAD_ARG);
+    TEST_CHECK(mtb_ml_npu_pm_acquire(NULL) == MTB_ML_RESULT_BAD_ARG);
+    TEST_CHECK(mtb_ml_npu_pm_suspend(NULL) == MTB_ML_RESULT_BAD_ARG);
+    TEST_CHECK(!mtb_ml_npu_pm_process(NULL, NULL));
+}
+
+static void test_counting(void)
+{
+    test_setup(0, TEST_IDLE_TIMEOUT_MS);
+    TEST_CHECK(test_pm.state == MTB_ML_NPU_PM_IDLE);
+
+    TEST_CHECK(mtb_ml_npu_pm_acquire(&test_pm) == MTB_ML_RESULT_SUCCESS);
+    TEST_CHECK(mtb_ml_npu_pm_acquire(&test_pm) == MTB_ML_RESULT_SUCCESS);
+    TEST_CHECK(test_pm.users == 2);
+    TEST_CHECK(test_pm.state == MTB_ML_NPU_PM_ACTIVE);
+
+    mtb_ml_npu_pm_release(&test_pm);
+    TEST_CHECK(test_pm.users == 1);
+    TEST_CHECK(test_pm.state == MTB_ML_NPU_PM_ACTIVE);
+
+    mtb_ml_npu_pm_release(&test_pm);
+    TEST_CHECK(test_pm.users == 0);
+    TEST_CHECK(test_pm.state == MTB_ML_NPU_PM_IDLE);
+
+    /* Unbalanced release does not underflow */
+    mtb_ml_npu_pm_release(&test_pm);
+    TEST_CHECK(test_pm.users == 0);
+    TEST_CHECK(test_pm.state == MTB_ML_NPU_PM_IDLE);
+
+    /* Powered from the start, no power up */
+    TEST_CHECK(test_sim.power_on_count == 0);
+    TEST_CHECK(test_pm.stats.wake_count == 0);
+    TEST_CHECK(test_sim.lock_errors == 0);
+    TEST_CHECK(!test_sim.held);
+}
+
+static void test_idle_timeout(void)
+{
+    uint32_t idle_left_ms = 0;
+
+    test_setup(1000, TEST_IDLE_TIMEOUT_MS);
+
+    TEST_CHECK(mtb_ml_npu_pm_acquire(&test_pm) == MTB_ML_RESULT_SUCCESS);
+    mtb_ml_npu_pm_sim_advance(&test_sim, 5 * TEST_IDLE_TIMEOUT_MS);
+    TEST_CHECK(!mtb_ml_npu_pm_process(&test_pm, NULL));
+    TEST_CHECK(test_sim.powered);
+
+    /* Idle period starts at the release, not at init */
+    mtb_ml_npu_pm_release(&test_pm);
+    mtb_ml_npu_pm_sim_advance(&test_sim, TEST_IDLE_TIMEOUT_MS - 1);
+    TEST_CHECK(!mtb_ml_npu_pm_process(&test_pm, &idle_left_ms));
+    TEST_CHECK(test_sim.powered);
+    /* A timer firing early on tick rounding is re-armed for the time left */
+    TEST_CHECK(idle_left_ms == 1);
+
+    mtb_ml_npu_pm_sim_advance(&test_sim, 1);
+    TEST_CHECK(mtb_ml_npu_pm_process(&test_pm, &idle_left_ms));
+    TEST_CHECK(idle_left_ms == 0);
+    TEST_CHECK(!test_sim.powered);
+    TEST_CHECK(test_pm.state == MTB_ML_NPU_PM_OFF);
+    TEST_CHECK(test_sim.power_off_count == 1);
+    TEST_CHECK(test_pm.stats.off_count == 1);
+
+    /* Already off */
+    mtb_ml_npu_pm_sim_advance(&test_sim, TEST_IDLE_TIMEOUT_MS);
+    TEST_CHECK(!mtb_ml_npu_pm_process(&test_pm, NULL));
+    TEST_CHECK(test_sim.power_off_count == 1);
+
+    /* Next acquire powers up and records the wake latency */
+    test_sim.wake_cycles = 1234;
+    TEST_CHECK(mtb_ml_npu_pm_acquire(&test_pm) == MTB_ML_RESULT_SUCCESS);
+    TEST_CHECK(test_sim.powered);
+    TEST_CHECK(test_sim.power_on_count == 1);
+    TEST_CHECK(test_pm.stats.wake_count == 1);
+    TEST_CHECK(test_pm.stats.last_wake_cycles == 1234);
+    TEST_CHECK(test_pm.stats.max_wake_cycles == 1234);
+    mtb_ml_npu_pm_release(&test_pm);
+    TEST_CHECK(test_sim.lock_errors == 0);
+}
+
+static void test_always_on(void)
+{
+    test_setup(0, MTB_ML_NPU_PM_ALWAYS_ON);
+
+    mtb_ml_npu_pm_sim_advance(&test_sim, UINT32_MAX / 2);
+    TEST_CHECK(!mtb_ml_npu_pm_process(&test_pm, NULL));
+    TEST_CHECK(test_sim.powered);
+
+    /* Enabled later, measured from the last release */
+    mtb_ml_npu_pm_set_idle_timeout(&test_pm, TEST_IDLE_TIMEOUT_MS);
+    TEST_CHECK(mtb_ml_npu_pm_process(&test_pm, NULL));
+    TEST_CHECK(!test_sim.powered);
+}
+
+static void test_suspend(void)
+{
+    test_setup(0, MTB_ML_NPU_PM_ALWAYS_ON);
+
+    TEST_CHECK(mtb_ml_npu_pm_acquire(&test_pm) == MTB_ML_RESULT_SUCCESS);
+    TEST_CHECK(mtb_ml_npu_pm_suspend(&test_pm) == MTB_ML_RESULT_BAD_ARG);
+    TEST_CHECK(test_sim.powered);
+    TEST_CHECK(test_pm.state == MTB_ML_NPU_PM_ACTIVE);
+
+    mtb_ml_npu_pm_release(&test_pm);
+    TEST_CHECK(mtb_ml_npu_pm_suspend(&test_pm) == MTB_ML_RESULT_SUCCESS);
+    TEST_CHECK(!test_sim.powered);
+    TEST_CHECK(test_pm.state == MTB_ML_NPU_PM_OFF);
+
+    /* Suspend of a powered down NPU does nothing */
+    TEST_CHECK(mtb_ml_npu_pm_suspend(&test_pm) == MTB_ML_RESULT_SUCCESS);
+    TEST_CHECK(test_sim.power_off_count == 1);
+    TEST_CHECK(test_sim.lock_errors == 0);
+}
+
+static void test_wrap(void)
+{
+    test_setup(UINT32_MAX - 10, TEST_IDLE_TIMEOUT_MS);
+
+    TEST_CHECK(mtb_ml_npu_pm_acquire(&test_pm) == MTB_ML_RESULT_SUCCESS);
+    mtb_ml_npu_pm_release(&test_pm);
+    TEST_CHECK(test_pm.idle_since_ms == UINT32_MAX - 10);
+
+    /* Time base wraps to 89, 99 ms idle */
+    mtb_ml_npu_pm_sim_advance(&test_sim, TEST_IDLE_TIMEOUT_MS - 1);
+    TEST_CHECK(test_sim.now_ms < TEST_IDLE_TIMEOUT_MS);
+    TEST_CHECK(!mtb_ml_npu_pm_process(&test_pm, NULL));
+    TEST_CHECK(test_sim.powered);
+
+    mtb_ml_npu_pm_sim_advance(&test_sim, 1);
+    TEST_CHECK(mtb_ml_npu_pm_process(&test_pm, NULL));
+    TEST_CHECK(!test_sim.powered);
+}
+
+static void test_held(void)
+{
+    uint32_t idle_left_ms = 0;
+
+    test_setup(0, TEST_IDLE_TIMEOUT_MS);
+
+    /* Held by another task, the timer callback skips the period instead of blocking */
+    mtb_ml_npu_pm_sim_advance(&test_sim, TEST_IDLE_TIMEOUT_MS);
+    test_sim.held = true;
+    TEST_CHECK(!mtb_ml_npu_pm_process(&test_pm, &idle_left_ms));
+    TEST_CHECK(idle_left_ms == 0);
+    TEST_CHECK(test_sim.powered);
+    TEST_CHECK(test_sim.held);
+
+    test_sim.held = false;
+    TEST_CHECK(mtb_ml_npu_pm_process(&test_pm, NULL));
+    TEST_CHECK(!test_sim.powered);
+    TEST_CHECK(!test_sim.held);
+}
+
+static void test_power_on_error(void)
+{
+    test_setup(0, TEST_IDLE_TIMEOUT_MS);
+
+    TEST_CHECK(mtb_ml_npu_pm_suspend(&test_pm) == MTB_ML_RESULT_SUCCESS);
+    test_sim.fail_power_on = true;
+    TEST_CHECK(mtb_ml_npu_pm_acquire(&test_pm) == MTB_ML_RESULT_NPU_INIT_ERROR);
+    TEST_CHECK(test_pm.state == MTB_ML_NPU_PM_OFF);
+    TEST_CHECK(test_pm.users == 0);
+    TEST_CHECK(test_pm.stats.wake_count == 0);
+
+    test_sim.fail_power_on = false;
+    TEST_CHECK(mtb_ml_npu_pm_acquire(&test_pm) == MTB_ML_RESULT_SUCCESS);
+    TEST_CHECK(test_pm.users == 1);
+    mtb_ml_npu_pm_release(&test_pm);
+    TEST_CHECK(test_sim.lock_errors == 0);
+}
+
+/*******************************************************************************
+ * Public Functions
+*******************************************************************************/
+int main(void)
+{
+    test_bad_args();
+    test_counting();
+    test_idle_timeout();
+    test_always_on();
+    test_suspend();
+    test_wrap();
+    test_held();
+    test_power_on_error();
+
+    printf("NPU_PM_TEST_INFO, failures=%d\r\n", test_failures);
+    return (test_failures == 0) ? 0 : 1;
+}
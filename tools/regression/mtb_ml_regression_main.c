@@ -0,0 +1,159 @@
+/***************************************************************************//**
+* \file mtb_ml_regression_main.c
+*
+* \brief
+* Host executable of the ML middleware regression. Runs a TFLM model over an x
+* data file and compares its outputs with a y data file, using the same engine
+* as the device.
+*
+* Usage:
+*   mtb_ml_regression --model MODEL_FILE --arena BYTES -x X_FILE -y Y_FILE [--y-float]
+*                     [--min-accuracy A] [--max-abs-error E]
+*
+* X_FILE holds mtb_ml_x_file_header_t followed by the samples. Y_FILE holds the
+* reference outputs, optionally after a mtb_ml_y_file_header_t. Without header
+* they are quantized as the model output, or float with --y-float. Both files
+* are memory mapped. The exit status is 1 when the top-1 accuracy is below
+* --min-accuracy or the max absolute error above --max-abs-error.
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <getopt.h>
+#include "mtb_ml.h"
+
+#if !defined(COMPONENT_ML_TFLM)
+#error "mtb_ml_regression loads the model from a file and requires COMPONENT_ML_TFLM"
+#endif
+
+/*******************************************************************************
+ * Private Functions
+*******************************************************************************/
+static void regression_usage(void)
+{
+    fprintf(stderr, "usage: mtb_ml_regression --model MODEL_FILE --arena BYTES -x X_FILE -y Y_FILE [--y-float] "
+                    "[--min-accuracy A] [--max-abs-error E]\n");
+    exit(2);
+}
+
+/*******************************************************************************
+ * Main
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    static const struct option options[] =
+    {
+        { "model",         required_argument, NULL, 'm' },
+        { "arena",         required_argument, NULL, 'a' },
+        { "y-float",       no_argument,       NULL, 'f' },
+        { "min-accuracy",  required_argument, NULL, 'A' },
+        { "max-abs-error", required_argument, NULL, 'E' },
+        { NULL, 0, NULL, 0 }
+    };
+    const char *model_path = NULL, *x_path = NULL, *y_path = NULL;
+    bool y_float = false;
+    float min_accuracy = 0.0f, max_abs_error = INFINITY;
+    long arena_size = 0;
+    mtb_ml_model_bin_t *model_bin;
+    mtb_ml_dataset_t dataset;
+    mtb_ml_model_t *model = NULL;
+    mtb_ml_regression_summary_t summary;
+    cy_rslt_t result;
+    int opt;
+
+    while((opt = getopt_long(argc, argv, "x:y:", options, NULL)) != -1)
+    {
+        switch(opt)
+        {
+            case 'm': model_path = optarg; break;
+            case 'a': arena_size = strtol(optarg, NULL, 0); break;
+            case 'f': y_float = true; break;
+            case 'A': min_accuracy = strtof(optarg, NULL); break;
+            case 'E': max_abs_error = strtof(optarg, NULL); break;
+            case 'x': x_path = optarg; break;
+            case 'y': y_path = optarg; break;
+            default: regression_usage();
+        }
+    }
+    if((model_path == NULL) || (x_path == NULL) || (y_path == NULL) || (arena_size <= 0))
+    {
+        regression_usage();
+    }
+
+    result = mtb_ml_model_bin_from_file(model_path, (int)arena_size, &model_bin);
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        fprintf(stderr, "ERROR: cannot load model %s (0x%x)\n", model_path, (unsigned int)result);
+        return 1;
+    }
+    if(mtb_ml_dataset_open_files(&dataset, x_path, y_path) != MTB_ML_RESULT_SUCCESS)
+    {
+        return 1;
+    }
+
+    result = mtb_ml_model_init(model_bin, NULL, &model);
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        fprintf(stderr, "ERROR: mtb_ml_model_init failed (0x%x)\n", (unsigned int)result);
+        return 1;
+    }
+
+    /* Reference results without header are quantized as the model output unless --y-float */
+    if(y_float && (dataset.y_type == MTB_ML_X_DATA_UNKNOWN))
+    {
+        dataset.y_type = MTB_ML_X_DATA_FLOAT32;
+        dataset.output_size = model->output_size;
+    }
+
+    result = mtb_ml_regression_run_dataset(model, &dataset, &summary);
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        fprintf(stderr, "ERROR: mtb_ml_regression_run failed (0x%x)\n", (unsigned int)result);
+        return 1;
+    }
+    mtb_ml_regression_log(&summary);
+
+    mtb_ml_model_deinit(model);
+    mtb_ml_model_bin_free(model_bin);
+    mtb_ml_dataset_close(&dataset);
+    if((summary.accuracy < min_accuracy) || (summary.max_abs_error > max_abs_error))
+    {
+        fprintf(stderr, "ERROR: regression outside of the limits\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,345 @@
+/***************************************************************************//**
+* \file mtb_ml_scheduler_sim.c
+*
+* \brief
+* Host simulation of the deadline scheduler under synthetic load. A synthetic
+* engine stands in for mtb_ml_model_run(), frames arrive periodically and a
+* burst of other work preempts the inference task every few frames.
+*
+* Usage:
+*   mtb_ml_scheduler_sim [--frames N] [--period-us US] [--infer-us US] [--fallback-us US]
+*                        [--deadline-us US] [--load-us US] [--load-every N]
+*                        [--max-decimation N] [--recover N] [--no-scheduler]
+*                        [--virtual-time] [--max-misses N]
+*                        [--spike-at N --spike-us US [--max-recovery N]]
+*                        [--mismatched-fallback] [--gate-every N]
+*
+* With --virtual-time the work advances a simulated clock instead of spinning,
+* so that a run is deterministic and instant. The exit status is 1 when the
+* deadline misses exceed --max-misses. --spike-at makes the first primary
+* inference from frame N on take --spike-us once, the exit status is then also
+* 1 unless the primary model runs again within --max-recovery frames.
+* --mismatched-fallback gives the fallback model a larger input than the
+* primary model, the exit status is then 0 only if the scheduler rejects it.
+* --gate-every N makes the input gate of the models skip the inference of all
+* but every Nth frame, the skipped frames return at once.
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <getopt.h>
+#include <time.h>
+#include "mtb_ml.h"
+#include "mtb_ml_scheduler.h"
+
+#define SIM_NS_PER_S                (1000000000ULL)
+
+/*******************************************************************************
+ * Public variables
+*******************************************************************************/
+/* The sim keeps its own clock in place of host/mtb_ml_host.c, in ns as there */
+uint32_t SystemCoreClock = (uint32_t)SIM_NS_PER_S;
+
+/*******************************************************************************
+ * Private variables
+*******************************************************************************/
+static bool sim_virtual_time;
+static uint64_t sim_now;
+static uint64_t sim_spike_cycles;       /* Latency of the next primary inference if not 0 */
+static bool sim_gated;                  /* The input gate skips the inference of the frame */
+static mtb_ml_model_t sim_primary = { .name = "primary", .input_size = 1, .input_type_size = sizeof(float) };
+static mtb_ml_model_t sim_fallback = { .name = "fallback", .input_size = 1, .input_type_size = sizeof(float) };
+static uint64_t sim_primary_cycles;
+static uint64_t sim_fallback_cycles;
+
+/*******************************************************************************
+ * Private Functions
+*******************************************************************************/
+static void sim_usage(void)
+{
+    fprintf(stderr, "usage: mtb_ml_scheduler_sim [--frames N] [--period-us US] [--infer-us US] [--fallback-us US] "
+                    "[--deadline-us US] [--load-us US] [--load-every N] [--max-decimation N] [--recover N] "
+                    "[--no-scheduler] [--virtual-time] [--max-misses N] "
+                    "[--spike-at N --spike-us US [--max-recovery N]] [--mismatched-fallback] [--gate-every N]\n");
+    exit(2);
+}
+
+static uint64_t sim_tsc(void)
+{
+    uint64_t now = 0;
+    mtb_ml_model_profile_get_tsc(&now);
+    return now;
+}
+
+static void sim_wait_until(uint64_t end)
+{
+    if(sim_virtual_time)
+    {
+        sim_now = (end > sim_now) ? end : sim_now;
+    }
+    while(sim_tsc() < end)
+    {
+    }
+}
+
+static void sim_busy(uint64_t cycles)
+{
+    sim_wait_until(sim_tsc() + cycles);
+}
+
+static uint64_t sim_us_to_cycles(unsigned long us)
+{
+    return (uint64_t)us * mtb_ml_cpu_clk_freq / 1000000U;
+}
+
+static double sim_cycles_to_us(uint64_t cycles)
+{
+    return (double)cycles * 1e6 / (double)mtb_ml_cpu_clk_freq;
+}
+
+/*******************************************************************************
+ * Synthetic clock and inference engine
+*******************************************************************************/
+int mtb_ml_model_profile_get_tsc(uint64_t *val)
+{
+    struct timespec ts;
+
+    if(sim_virtual_time)
+    {
+        *val = sim_now;
+    }
+    else
+    {
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        *val = (uint64_t)ts.tv_sec * SIM_NS_PER_S + (uint64_t)ts.tv_nsec;
+    }
+    return 0;
+}
+
+cy_rslt_t mtb_ml_model_run(mtb_ml_model_t *object, MTB_ML_DATA_T *input)
+{
+    if(object == NULL || input == NULL)
+    {
+        return MTB_ML_RESULT_BAD_ARG;
+    }
+    if(object->input_gate.enabled)
+    {
+        object->input_gate.stats.frames++;
+        if(sim_gated)
+        {
+            /* Answered with the cached output */
+            object->input_gate.stats.skipped++;
+            return MTB_ML_RESULT_SUCCESS;
+        }
+    }
+    if(object == &sim_fallback)
+    {
+        sim_busy(sim_fallback_cycles);
+    }
+    else
+    {
+        sim_busy((sim_spike_cycles != 0) ? sim_spike_cycles : sim_primary_cycles);
+        sim_spike_cycles = 0;
+    }
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Main
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    static const struct option options[] =
+    {
+        { "frames",         required_argument, NULL, 'n' },
+        { "period-us",      required_argument, NULL, 'p' },
+        { "infer-us",       required_argument, NULL, 'i' },
+        { "fallback-us",    required_argument, NULL, 'f' },
+        { "deadline-us",    required_argument, NULL, 'd' },
+        { "load-us",        required_argument, NULL, 'l' },
+        { "load-every",     required_argument, NULL, 'e' },
+        { "max-decimation", required_argument, NULL, 'm' },
+        { "recover",        required_argument, NULL, 'r' },
+        { "no-scheduler",   no_argument,       NULL, 'x' },
+        { "virtual-time",   no_argument,       NULL, 'v' },
+        { "max-misses",     required_argument, NULL, 'M' },
+        { "spike-at",       required_argument, NULL, 'S' },
+        { "spike-us",       required_argument, NULL, 's' },
+        { "max-recovery",   required_argument, NULL, 'R' },
+        { "mismatched-fallback", no_argument,  NULL, 'X' },
+        { "gate-every",     required_argument, NULL, 'g' },
+        { NULL, 0, NULL, 0 }
+    };
+    unsigned long frames = 2000, period_us = 1000, infer_us = 700, fallback_us = 200, deadline_us = 3000;
+    unsigned long load_us = 2500, load_every = 8, max_decimation = 4, recover = 16;
+    unsigned long max_misses = ULONG_MAX;
+    unsigned long spike_at = ULONG_MAX, spike_us = 0, max_recovery = ULONG_MAX;
+    unsigned long spike_frame = ULONG_MAX, recovery = ULONG_MAX;
+    unsigned long gate_every = 0;
+    bool ok;
+    bool use_scheduler = true;
+    bool mismatched_fallback = false;
+    mtb_ml_scheduler_config_t config;
+    mtb_ml_scheduler_t sched;
+    mtb_ml_scheduler_stats_t stats;
+    /* The synthetic engine never reads the input, of any MTB_ML_DATA_T */
+    float input[1] = { 0 };
+    uint64_t period, load, start;
+    cy_rslt_t result;
+    int opt;
+
+    while((opt = getopt_long(argc, argv, "", options, NULL)) != -1)
+    {
+        switch(opt)
+        {
+            case 'n': frames = strtoul(optarg, NULL, 0); break;
+            case 'p': period_us = strtoul(optarg, NULL, 0); break;
+            case 'i': infer_us = strtoul(optarg, NULL, 0); break;
+            case 'f': fallback_us = strtoul(optarg, NULL, 0); break;
+            case 'd': deadline_us = strtoul(optarg, NULL, 0); break;
+            case 'l': load_us = strtoul(optarg, NULL, 0); break;
+            case 'e': load_every = strtoul(optarg, NULL, 0); break;
+            case 'm': max_decimation = strtoul(optarg, NULL, 0); break;
+            case 'r': recover = strtoul(optarg, NULL, 0); break;
+            case 'x': use_scheduler = false; break;
+            case 'v': sim_virtual_time = true; break;
+            case 'M': max_misses = strtoul(optarg, NULL, 0); break;
+            case 'S': spike_at = strtoul(optarg, NULL, 0); break;
+            case 's': spike_us = strtoul(optarg, NULL, 0); break;
+            case 'R': max_recovery = strtoul(optarg, NULL, 0); break;
+            case 'X': mismatched_fallback = true; break;
+            case 'g': gate_every = strtoul(optarg, NULL, 0); break;
+            default: sim_usage();
+        }
+    }
+    if(period_us == 0 || deadline_us == 0)
+    {
+        sim_usage();
+    }
+
+    if(mtb_ml_init(0) != MTB_ML_RESULT_SUCCESS)
+    {
+        return 1;
+    }
+    sim_primary_cycles = sim_us_to_cycles(infer_us);
+    sim_fallback_cycles = sim_us_to_cycles(fallback_us);
+    period = sim_us_to_cycles(period_us);
+    sim_primary.input_gate.enabled = (gate_every != 0);
+    sim_fallback.input_gate.enabled = (gate_every != 0);
+    load = sim_us_to_cycles(load_us);
+
+    /* Without a scheduler every frame runs the primary model, however late */
+    memset(&config, 0, sizeof(config));
+    config.deadline_cycles = use_scheduler ? sim_us_to_cycles(deadline_us) : UINT64_MAX;
+    config.fallback = (use_scheduler && fallback_us != 0) ? &sim_fallback : NULL;
+    config.max_decimation = use_scheduler ? (uint32_t)max_decimation : 1U;
+    config.recover_frames = (uint32_t)recover;
+    if(mismatched_fallback)
+    {
+        /* The fallback model would read past the input of the primary model */
+        sim_fallback.input_size = sim_primary.input_size + 1;
+        config.fallback = &sim_fallback;
+        result = mtb_ml_scheduler_init(&sched, &sim_primary, &config);
+        printf("SIM_INFO, mismatched fallback %s\n",
+               (result == MTB_ML_RESULT_INPUT_ERROR) ? "rejected" : "accepted");
+        return (result == MTB_ML_RESULT_INPUT_ERROR) ? 0 : 1;
+    }
+    result = mtb_ml_scheduler_init(&sched, &sim_primary, &config);
+    if(result != MTB_ML_RESULT_SUCCESS)
+    {
+        fprintf(stderr, "ERROR: mtb_ml_scheduler_init failed (0x%x)\n", (unsigned int)result);
+        return 1;
+    }
+
+    start = sim_tsc() + period;
+    for(unsigned long k = 0; k < frames; k++)
+    {
+        uint64_t arrival = start + (uint64_t)k * period;
+        mtb_ml_scheduler_decision_t decision;
+
+        /* Idle until the frame arrives, unless the task is behind */
+        sim_wait_until(arrival);
+        /* Other work preempting the inference task */
+        if(load_every != 0 && (k % load_every) == 0)
+        {
+            sim_busy(load);
+        }
+        sim_gated = (gate_every != 0 && (k % gate_every) != 0);
+        if(k == spike_at)
+        {
+            sim_spike_cycles = sim_us_to_cycles(spike_us);
+        }
+        result = mtb_ml_scheduler_submit(&sched, (MTB_ML_DATA_T *)input, arrival, &decision, NULL);
+        if(result != MTB_ML_RESULT_SUCCESS)
+        {
+            fprintf(stderr, "ERROR: mtb_ml_scheduler_submit failed (0x%x)\n", (unsigned int)result);
+            return 1;
+        }
+        /* Frames from the spike until the primary model runs again */
+        if(decision == MTB_ML_SCHEDULER_RUN)
+        {
+            if(spike_frame != ULONG_MAX && recovery == ULONG_MAX)
+            {
+                recovery = k - spike_frame;
+            }
+            if(k >= spike_at && spike_frame == ULONG_MAX && sim_spike_cycles == 0)
+            {
+                spike_frame = k;
+            }
+        }
+    }
+
+    (void)mtb_ml_scheduler_get_stats(&sched, &stats);
+    (void)mtb_ml_scheduler_log(&stats);
+    printf("SIM_INFO, scheduler=%s, deadline_us=%lu, max_latency_us=%.1f\n",
+           use_scheduler ? "on" : "off", deadline_us, sim_cycles_to_us(stats.max_latency_cycles));
+    ok = (stats.deadline_misses <= max_misses);
+    if(spike_at != ULONG_MAX)
+    {
+        if(recovery == ULONG_MAX)
+        {
+            printf("SIM_INFO, spike_frame=%ld, primary model not run again after the spike\n",
+                   (spike_frame == ULONG_MAX) ? -1L : (long)spike_frame);
+            ok = false;
+        }
+        else
+        {
+            printf("SIM_INFO, spike_frame=%lu, recovery_frames=%lu\n", spike_frame, recovery);
+            ok = ok && (recovery <= max_recovery);
+        }
+    }
+    return ok ? 0 : 1;
+}
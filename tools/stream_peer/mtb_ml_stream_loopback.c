@@ -0,0 +1,423 @@
+/***************************************************************************//**
+* \file mtb_ml_stream_loopback.c
+*
+* \brief
+* Loopback test of the stream protocol: the reference host peer runs as a child
+* process against an in-process device, the stream of the host build over a
+* Unix socket. A synthetic model stands in for mtb_ml_model_run(), so the test
+* builds without tflite-micro. Each scenario checks the exit status of the
+* peer, which compares the results with a reference file. Returns non-zero on
+* failure.
+*
+* Usage:
+*   mtb_ml_stream_loopback PEER_EXECUTABLE
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "mtb_ml_stream.h"
+#include "mtb_ml_stream_impl.h"
+
+/*******************************************************************************
+ * Macros
+*******************************************************************************/
+#define LOOPBACK_INPUT_SIZE     (16)
+#define LOOPBACK_OUTPUT_SIZE    (10)
+#define LOOPBACK_FRAMES         (50)
+#define LOOPBACK_TIMEOUT_MS     (5000)
+#define LOOPBACK_RX_FRAMES      (8)
+
+#if defined(COMPONENT_ML_FLOAT32)
+#define LOOPBACK_X_DATA_TYPE    MTB_ML_X_DATA_FLOAT32
+#elif defined(COMPONENT_ML_INT8x8)
+#define LOOPBACK_X_DATA_TYPE    MTB_ML_X_DATA_INT8
+#elif defined(COMPONENT_ML_INT16x8)
+#define LOOPBACK_X_DATA_TYPE    MTB_ML_X_DATA_INT16
+#else
+#error "mtb_ml_stream_loopback requires a build of a single data type"
+#endif
+
+/*******************************************************************************
+ * Typedefs
+*******************************************************************************/
+typedef enum
+{
+    LOOPBACK_SEQUENTIAL,            /* mtb_ml_stream_input_data() and mtb_ml_stream_output_data() */
+    LOOPBACK_RUNNER                 /* mtb_ml_stream_run() */
+} loopback_device_t;
+
+typedef struct
+{
+    const char *name;
+    loopback_device_t device;
+    mtb_ml_stream_config_t config;
+    const char *peer_args[4];       /* Extra peer arguments */
+    bool bad_ref;                   /* Reference result corrupted, the peer must fail */
+} loopback_scenario_t;
+
+/*******************************************************************************
+ * Private variables
+*******************************************************************************/
+static MTB_ML_DATA_T loopback_frames[LOOPBACK_FRAMES][LOOPBACK_INPUT_SIZE];
+static MTB_ML_DATA_T loopback_ref[LOOPBACK_FRAMES][LOOPBACK_OUTPUT_SIZE];
+static MTB_ML_DATA_T loopback_output[LOOPBACK_OUTPUT_SIZE];
+static mtb_ml_model_t loopback_model;
+static char loopback_dir[] = "/tmp/mtb_ml_loopback_XXXXXX";
+static char loopback_socket[64];
+static char loopback_x_path[64];
+static char loopback_ref_path[64];
+static char loopback_out_path[64];
+
+static const loopback_scenario_t loopback_scenarios[] =
+{
+    { "v1 sequential",  LOOPBACK_SEQUENTIAL, { 0 }, { NULL }, false },
+    { "v1 mismatch",    LOOPBACK_SEQUENTIAL, { 0 }, { NULL }, true },
+    { "v1 runner",      LOOPBACK_RUNNER, { 0 }, { NULL }, false },
+    { "v2 batch",       LOOPBACK_SEQUENTIAL, { .batch_frames = LOOPBACK_RX_FRAMES }, { "--codec", "none", NULL }, false },
+    { "v2 runner",      LOOPBACK_RUNNER, { .batch_frames = LOOPBACK_RX_FRAMES }, { "--codec", "none", NULL }, false },
+    { "v2 runner lz4",  LOOPBACK_RUNNER, { .batch_frames = LOOPBACK_RX_FRAMES, .codecs = MTB_ML_STREAM_CODEC_LZ4 },
+                        { "--codec", "lz4", NULL }, false },
+    { "v2 mismatch",    LOOPBACK_RUNNER, { .batch_frames = LOOPBACK_RX_FRAMES }, { NULL }, true },
+    { "v2 top-k",       LOOPBACK_RUNNER, { .batch_frames = LOOPBACK_RX_FRAMES, .output_mode = MTB_ML_STREAM_OUTPUT_TOPK,
+                        .top_k = 3 }, { NULL }, false },
+    { "v2 top-k mismatch", LOOPBACK_RUNNER, { .batch_frames = LOOPBACK_RX_FRAMES, .output_mode = MTB_ML_STREAM_OUTPUT_TOPK,
+                        .top_k = 3 }, { NULL }, true },
+};
+
+/*******************************************************************************
+ * Private Functions
+*******************************************************************************/
+/* Synthetic inference, a fixed linear layer of small weights */
+static void loopback_infer(const MTB_ML_DATA_T *input, MTB_ML_DATA_T *output)
+{
+    for(int j = 0; j < LOOPBACK_OUTPUT_SIZE; j++)
+    {
+        int32_t acc = 0;
+        for(int i = 0; i < LOOPBACK_INPUT_SIZE; i++)
+        {
+            acc += (int32_t)input[i] * (((i + 3 * j) % 5) - 2);
+        }
+        output[j] = (MTB_ML_DATA_T)(acc / LOOPBACK_INPUT_SIZE);
+    }
+}
+
+static bool loopback_write(const char *path, const void *header, size_t header_size, const void *data, size_t size)
+{
+    FILE *f = fopen(path, "wb");
+    bool ok = (f != NULL);
+
+    if(ok && (header != NULL))
+    {
+        ok = (fwrite(header, header_size, 1, f) == 1);
+    }
+    if(ok)
+    {
+        ok = (fwrite(data, size, 1, f) == 1);
+    }
+    if(f != NULL)
+    {
+        fclose(f);
+    }
+    return ok;
+}
+
+static bool loopback_setup(void)
+{
+    mtb_ml_x_file_header_t header;
+    uint32_t seed = 12345;
+
+    /* Slowly varying signal with some noise, so that the codecs have something to find */
+    for(int n = 0; n < LOOPBACK_FRAMES; n++)
+    {
+        for(int i = 0; i < LOOPBACK_INPUT_SIZE; i++)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            loopback_frames[n][i] = (MTB_ML_DATA_T)(((n + i) % 16) * 6 - 48 + (int)((seed >> 28) & 0x3));
+        }
+        loopback_infer(loopback_frames[n], loopback_ref[n]);
+    }
+
+    memset(&header, 0, sizeof(header));
+    header.num_of_samples = LOOPBACK_FRAMES;
+    header.input_size = LOOPBACK_INPUT_SIZE;
+    header.recurrent_ts_size = -1;
+    header.data_type = LOOPBACK_X_DATA_TYPE;
+
+    if(mkdtemp(loopback_dir) == NULL)
+    {
+        return false;
+    }
+    snprintf(loopback_socket, sizeof(loopback_socket), "%s/sock", loopback_dir);
+    snprintf(loopback_x_path, sizeof(loopback_x_path), "%s/x.bin", loopback_dir);
+    snprintf(loopback_ref_path, sizeof(loopback_ref_path), "%s/ref.bin", loopback_dir);
+    snprintf(loopback_out_path, sizeof(loopback_out_path), "%s/out.bin", loopback_dir);
+    if(!loopback_write(loopback_x_path, &header, sizeof(header), loopback_frames, sizeof(loopback_frames)))
+    {
+        return false;
+    }
+
+    loopback_model.input_size = LOOPBACK_INPUT_SIZE;
+    loopback_model.output_size = LOOPBACK_OUTPUT_SIZE;
+    loopback_model.input_type_size = sizeof(MTB_ML_DATA_T);
+    loopback_model.output_type_size = sizeof(MTB_ML_DATA_T);
+    loopback_model.output = loopback_output;
+    return true;
+}
+
+static void loopback_cleanup(void)
+{
+    unlink(loopback_socket);
+    unlink(loopback_x_path);
+    unlink(loopback_ref_path);
+    unlink(loopback_out_path);
+    rmdir(loopback_dir);
+}
+
+static pid_t loopback_start_peer(const char *peer_path, const loopback_scenario_t *scenario)
+{
+    const char *argv[16] = { peer_path, "--unix", loopback_socket, "-x", loopback_x_path,
+                             "--ref", loopback_ref_path, "-o", loopback_out_path };
+    int argc = 9;
+    pid_t pid;
+
+    for(int i = 0; scenario->peer_args[i] != NULL; i++)
+    {
+        argv[argc++] = scenario->peer_args[i];
+    }
+    argv[argc] = NULL;
+
+    fflush(stdout);
+    pid = fork();
+    if(pid == 0)
+    {
+        execv(peer_path, (char *const *)argv);
+        perror("mtb_ml_stream_loopback: exec");
+        _exit(127);
+    }
+    return pid;
+}
+
+static cy_rslt_t loopback_run_sequential(mtb_ml_stream_interface_t *iface)
+{
+    MTB_ML_DATA_T frames[LOOPBACK_RX_FRAMES][LOOPBACK_INPUT_SIZE];
+    MTB_ML_DATA_T results[LOOPBACK_RX_FRAMES][LOOPBACK_OUTPUT_SIZE];
+    cy_rslt_t result = MTB_ML_RESULT_SUCCESS;
+    uint32_t done = 0;
+
+    while((result == MTB_ML_RESULT_SUCCESS) && (done < iface->x_data_info.num_of_samples))
+    {
+        uint32_t count = 1;
+
+        if(iface->protocol_version == 2)
+        {
+            result = mtb_ml_stream_input_batch(iface, frames, &count, LOOPBACK_TIMEOUT_MS);
+        }
+        else
+        {
+            result = mtb_ml_stream_input_data(iface, frames, LOOPBACK_TIMEOUT_MS);
+        }
+        for(uint32_t i = 0; (result == MTB_ML_RESULT_SUCCESS) && (i < count); i++)
+        {
+            result = mtb_ml_model_run(&loopback_model, frames[i]);
+            memcpy(results[i], loopback_output, sizeof(results[i]));
+        }
+        if(result == MTB_ML_RESULT_SUCCESS)
+        {
+            result = (iface->protocol_version == 2) ?
+                     mtb_ml_stream_output_batch(iface, results, count, LOOPBACK_TIMEOUT_MS) :
+                     mtb_ml_stream_output_data(iface, results, LOOPBACK_TIMEOUT_MS);
+        }
+        done += count;
+    }
+    return result;
+}
+
+/* The peer output file holds the reference results, reduced as the device sent them */
+static bool loopback_check_out(const loopback_scenario_t *scenario, const MTB_ML_DATA_T ref[][LOOPBACK_OUTPUT_SIZE])
+{
+    uint32_t mode = scenario->config.output_mode;
+    size_t record = (mode == MTB_ML_STREAM_OUTPUT_FULL) ? sizeof(ref[0]) :
+                    mtb_ml_stream_reduced_bytes(mode, scenario->config.top_k, LOOPBACK_OUTPUT_SIZE, LOOPBACK_X_DATA_TYPE);
+    uint8_t expected[sizeof(ref[0]) + MTB_ML_STREAM_V2_TOPK_MAX * (sizeof(uint32_t) + sizeof(float))];
+    uint8_t actual[sizeof(expected)];
+    FILE *f = fopen(loopback_out_path, "rb");
+    bool ok = (f != NULL);
+
+    for(int i = 0; ok && (i < LOOPBACK_FRAMES); i++)
+    {
+        if(mode == MTB_ML_STREAM_OUTPUT_FULL)
+        {
+            memcpy(expected, ref[i], record);
+        }
+        else
+        {
+            mtb_ml_stream_reduce(mode, scenario->config.top_k, ref[i], LOOPBACK_OUTPUT_SIZE, LOOPBACK_X_DATA_TYPE,
+                                 expected);
+        }
+        ok = (fread(actual, record, 1, f) == 1) && (memcmp(actual, expected, record) == 0);
+    }
+    ok = ok && (fgetc(f) == EOF);
+    if(f != NULL)
+    {
+        fclose(f);
+    }
+    if(!ok)
+    {
+        printf("LOOPBACK_INFO, scenario=%s, output file does not hold the expected results\r\n", scenario->name);
+    }
+    return ok;
+}
+
+/* Device side of a scenario, returns whether the peer exit status was the expected one */
+static bool loopback_run(const char *peer_path, const loopback_scenario_t *scenario)
+{
+    MTB_ML_DATA_T ref[LOOPBACK_FRAMES][LOOPBACK_OUTPUT_SIZE];
+    mtb_data_streaming_interface_t interface_obj;
+    mtb_ml_stream_tag_t stream_tag;
+    mtb_ml_stream_interface_t iface;
+    mtb_ml_stream_config_t config = scenario->config;
+    cy_rslt_t result;
+    int status = 0;
+    bool peer_ok;
+    pid_t pid;
+
+    memcpy(ref, loopback_ref, sizeof(ref));
+    if(scenario->bad_ref)
+    {
+        /* Lowest output of a frame becomes its largest, which a top-k reduction notices too */
+        MTB_ML_DATA_T *bad = ref[LOOPBACK_FRAMES / 2];
+        int lo = 0, hi = 0;
+        for(int j = 1; j < LOOPBACK_OUTPUT_SIZE; j++)
+        {
+            lo = (bad[j] < bad[lo]) ? j : lo;
+            hi = (bad[j] > bad[hi]) ? j : hi;
+        }
+        bad[lo] = (MTB_ML_DATA_T)(bad[hi] + 1);
+    }
+    if(!loopback_write(loopback_ref_path, NULL, 0, ref, sizeof(ref)))
+    {
+        return false;
+    }
+
+    pid = loopback_start_peer(peer_path, scenario);
+    if(pid < 0)
+    {
+        return false;
+    }
+
+    memset(&interface_obj, 0, sizeof(interface_obj));
+    memset(&iface, 0, sizeof(iface));
+    iface.interface_obj = &interface_obj;
+    iface.stream_tag = &stream_tag;
+    config.transport = &mtb_ml_stream_fd_transport;
+    config.rx_buffer_size = sizeof(loopback_frames[0]) * LOOPBACK_RX_FRAMES;
+
+    result = mtb_ml_stream_unix_connect(&interface_obj, loopback_socket);
+    if(result == MTB_ML_RESULT_SUCCESS)
+    {
+        result = mtb_ml_stream_init_ex(&iface, &loopback_model, &config);
+    }
+    if(result == MTB_ML_RESULT_SUCCESS)
+    {
+        result = (scenario->device == LOOPBACK_RUNNER) ?
+                 mtb_ml_stream_run(&iface, &loopback_model, LOOPBACK_TIMEOUT_MS, NULL) :
+                 loopback_run_sequential(&iface);
+    }
+    if(result == MTB_ML_RESULT_SUCCESS)
+    {
+        result = mtb_ml_inform_host_done(&iface, LOOPBACK_TIMEOUT_MS);
+    }
+    mtb_ml_stream_host_close(&interface_obj);
+
+    if(waitpid(pid, &status, 0) != pid)
+    {
+        return false;
+    }
+    peer_ok = WIFEXITED(status) && (WEXITSTATUS(status) == 0);
+    printf("LOOPBACK_INFO, scenario=%s, device_result=0x%08x, peer_exit=%d\r\n", scenario->name,
+           (unsigned)result, WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+
+    /* The device does not know the reference, it completes either way */
+    return (result == MTB_ML_RESULT_SUCCESS) && (peer_ok != scenario->bad_ref) &&
+           (!peer_ok || loopback_check_out(scenario, (const MTB_ML_DATA_T (*)[LOOPBACK_OUTPUT_SIZE])ref));
+}
+
+/*******************************************************************************
+ * Public Functions
+*******************************************************************************/
+/* Synthetic engine of the device side */
+cy_rslt_t mtb_ml_model_run(mtb_ml_model_t *object, MTB_ML_DATA_T *input)
+{
+    loopback_infer(input, object->output);
+    return MTB_ML_RESULT_SUCCESS;
+}
+
+int main(int argc, char *argv[])
+{
+    int failures = 0;
+
+    if(argc != 2)
+    {
+        fprintf(stderr, "usage: mtb_ml_stream_loopback PEER_EXECUTABLE\n");
+        return 2;
+    }
+    /* A peer failing a scenario closes the socket, the device sees a write error instead of dying */
+    signal(SIGPIPE, SIG_IGN);
+    if(!loopback_setup())
+    {
+        perror("mtb_ml_stream_loopback: setup");
+        loopback_cleanup();
+        return 1;
+    }
+
+    for(size_t i = 0; i < sizeof(loopback_scenarios) / sizeof(loopback_scenarios[0]); i++)
+    {
+        if(!loopback_run(argv[1], &loopback_scenarios[i]))
+        {
+            printf("FAIL %s\n", loopback_scenarios[i].name);
+            failures++;
+        }
+    }
+    loopback_cleanup();
+
+    printf("LOOPBACK_INFO, failures=%d\r\n", failures);
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,1065 @@
+/***************************************************************************//**
+* \file mtb_ml_stream_peer.c
+*
+* \brief
+* Reference host peer of ML validation data streaming. Implements the host side
+* of the stream protocol (v1 and the batched v2) over a TCP socket, a Unix
+* socket or a serial device (board UART or the pty of a host build).
+*
+* Usage:
+*   mtb_ml_stream_peer (--tcp PORT | --unix PATH | --serial DEVICE)
+*                      -x X_FILE [-o OUT_FILE] [--batch K | --v1]
+*                      [--codec none|delta16|lz4|auto] [--ref REF_FILE]
+*
+* X_FILE holds mtb_ml_x_file_header_t followed by the frames. Results are
+* written to OUT_FILE in frame order, in a reduced output mode (hash or top-k)
+* as the reduced records sent by the device. With --ref the results are
+* compared with REF_FILE and the exit status is 1 on any mismatch, as on a CRC
+* error.
+*
+*******************************************************************************
+* (c) 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnity Cypress against all liability.
+*******************************************************************************/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <time.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include "mtb_ml_dataset.h"
+#include "mtb_ml_stream_impl.h"
+
+/*******************************************************************************
+ * Macros
+*******************************************************************************/
+#define PEER_LZ4_HASH_BITS      (12)
+#define PEER_LZ4_MIN_MATCH      (4)
+/* Format end conditions: the last match starts 12 bytes and ends 5 bytes before the end */
+#define PEER_LZ4_MFLIMIT        (12)
+#define PEER_LZ4_LAST_LITERALS  (5)
+
+/*******************************************************************************
+ * Typedefs
+*******************************************************************************/
+/* Result batch sent reduced that did not match the reference */
+typedef struct
+{
+    uint32_t seq;
+    uint32_t first;                 /* Index of its first result */
+    uint32_t count;
+} peer_pending_t;
+
+typedef struct
+{
+    int fd;
+    FILE *out;
+    const uint8_t *frames;          /* Dataset frames */
+    uint32_t num_frames;            /* Frames (time step slices for streaming RNN) in the dataset */
+    uint32_t num_samples;           /* Results expected from the device */
+    uint32_t frame_bytes;
+    uint32_t result_bytes;
+    uint32_t frames_sent;
+    uint32_t results;
+    uint32_t crc_errors;
+    uint64_t tx_bytes;
+    uint64_t rx_bytes;
+    uint32_t codec;                 /* Negotiated MTB_ML_STREAM_CODEC_*, 0 for raw frames */
+    uint8_t *code_buf;              /* Coded batch */
+    uint8_t *check_buf;             /* In place decoding check of the coded batch */
+    size_t check_size;
+    uint64_t frame_payload_bytes;   /* Frame bytes before and after coding */
+    uint64_t coded_payload_bytes;
+    mtb_ml_x_data_type_t data_type;
+    uint32_t output_mode;           /* Negotiated MTB_ML_STREAM_OUTPUT_* */
+    uint32_t top_k;
+    mtb_ml_x_data_type_t output_type; /* Element type of the results, from the model output */
+    uint32_t result_values;         /* Values of one result */
+    uint32_t reduced_bytes;         /* Bytes of a reduced result */
+    const uint8_t *ref;             /* Reference results, compared with the received ones */
+    uint8_t *all_reduced;           /* Reduced results of the whole dataset, as sent by the device */
+    peer_pending_t *pending;        /* Batches with mismatching results, their full results are requested */
+    uint32_t num_pending;
+    uint32_t mismatches;            /* Results not matching the reference */
+    uint32_t resent;                /* Batches sent again in full */
+    uint64_t result_payload_bytes;  /* Result bytes before and after reduction */
+    uint64_t reduced_payload_bytes;
+} peer_t;
+
+/*******************************************************************************
+ * Private Functions
+*******************************************************************************/
+static void peer_fail(const char *msg)
+{
+    fprintf(stderr, "mtb_ml_stream_peer: %s%s%s\n", msg, errno ? ": " : "", errno ? strerror(errno) : "");
+    exit(1);
+}
+
+static void peer_send(peer_t *peer, const void *data, size_t size)
+{
+    const uint8_t *p = (const uint8_t *)data;
+
+    while(size > 0)
+    {
+        ssize_t n = write(peer->fd, p, size);
+        if(n < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            peer_fail("write failed");
+        }
+        p += n;
+        size -= (size_t)n;
+        peer->tx_bytes += (uint64_t)n;
+    }
+}
+
+static void peer_recv(peer_t *peer, void *data, size_t size)
+{
+    uint8_t *p = (uint8_t *)data;
+
+    while(size > 0)
+    {
+        ssize_t n = read(peer->fd, p, size);
+        if(n < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            peer_fail("read failed");
+        }
+        if(n == 0)
+        {
+            errno = 0;
+            peer_fail("device closed the connection");
+        }
+        p += n;
+        size -= (size_t)n;
+        peer->rx_bytes += (uint64_t)n;
+    }
+}
+
+/* Device debug output shares the link, so protocol strings (with their
+ * terminating NUL) are searched for in the byte stream. Returns the index
+ * of the matching token. */
+static int peer_wait_token(peer_t *peer, const char *const tokens[], int count)
+{
+    uint8_t window[32] = {0};
+    size_t fill = 0;
+
+    for(;;)
+    {
+        uint8_t c;
+        peer_recv(peer, &c, 1);
+        if(fill == sizeof(window))
+        {
+            memmove(window, window + 1, sizeof(window) - 1);
+            fill--;
+        }
+        window[fill++] = c;
+
+        for(int i = 0; i < count; i++)
+        {
+            size_t len = strlen(tokens[i]) + 1;
+            if((fill >= len) && (memcmp(window + fill - len, tokens[i], len) == 0))
+            {
+                return i;
+            }
+        }
+    }
+}
+
+static void peer_expect(peer_t *peer, const char *token)
+{
+    const char *const tokens[] = { token };
+    (void)peer_wait_token(peer, tokens, 1);
+}
+
+/* Searches the byte stream for the next v2 batch header */
+static void peer_recv_v2_hdr(peer_t *peer, mtb_ml_stream_v2_hdr_t *hdr)
+{
+    uint32_t magic = 0;
+
+    while(magic != MTB_ML_STREAM_V2_MAGIC)
+    {
+        uint8_t c;
+        peer_recv(peer, &c, 1);
+        magic = (magic >> 8) | ((uint32_t)c << 24);
+    }
+    hdr->magic = magic;
+    peer_recv(peer, (uint8_t *)hdr + sizeof(hdr->magic), sizeof(*hdr) - sizeof(hdr->magic));
+}
+
+static void peer_store_results(peer_t *peer, const void *data, uint32_t count)
+{
+    if(peer->out != NULL)
+    {
+        fwrite(data, peer->result_bytes, count, peer->out);
+    }
+    for(uint32_t i = 0; (peer->ref != NULL) && (i < count) && (peer->results + i < peer->num_samples); i++)
+    {
+        if(memcmp((const uint8_t *)data + (size_t)i * peer->result_bytes,
+                  peer->ref + (size_t)(peer->results + i) * peer->result_bytes, peer->result_bytes) != 0)
+        {
+            peer->mismatches++;
+        }
+    }
+    peer->results += count;
+}
+
+static void peer_run_v1(peer_t *peer)
+{
+    static const char *const tokens[] = { ML_CT_FRAME_REQ_STRING, ML_CT_RESULT_STRING };
+    uint8_t *result = malloc(peer->result_bytes);
+    /* Time step slices of a streaming RNN are requested one by one for a result */
+    uint32_t slices = (peer->num_samples > 0) ? (peer->num_frames / peer->num_samples) : 1;
+
+    if(result == NULL)
+    {
+        peer_fail("out of memory");
+    }
+    while(peer->results < peer->num_samples)
+    {
+        if(peer_wait_token(peer, tokens, 2) == 0)
+        {
+            if(peer->frames_sent >= peer->num_frames)
+            {
+                errno = 0;
+                peer_fail("device requested more frames than the dataset holds");
+            }
+            /* Protocol v1 is strictly sequential */
+            if(peer->frames_sent >= (peer->results + 1) * slices)
+            {
+                errno = 0;
+                peer_fail("device requested a frame before the result of the previous one");
+            }
+            peer_send(peer, peer->frames + (size_t)peer->frames_sent * peer->frame_bytes, peer->frame_bytes);
+            peer->frames_sent++;
+        }
+        else
+        {
+            peer_recv(peer, result, peer->result_bytes);
+            peer_store_results(peer, result, 1);
+        }
+    }
+    free(result);
+}
+
+static size_t peer_encode_delta16(uint8_t *dst, const uint8_t *src, size_t size)
+{
+    uint8_t *out = dst;
+    uint16_t prev = 0;
+
+    for(size_t i = 0; i + 1 < size; i += 2)
+    {
+        uint16_t sample = (uint16_t)(src[i] | (src[i + 1] << 8));
+        int16_t delta = (int16_t)(uint16_t)(sample - prev);
+        uint32_t zz = (uint16_t)(((uint16_t)delta << 1) ^ (uint16_t)(delta >> 15));
+
+        prev = sample;
+        while(zz >= 0x80)
+        {
+            *out++ = (uint8_t)(zz | 0x80);
+            zz >>= 7;
+        }
+        *out++ = (uint8_t)zz;
+    }
+    return (size_t)(out - dst);
+}
+
+static uint8_t *peer_lz4_length(uint8_t *out, size_t len)
+{
+    for(; len >= 255; len -= 255)
+    {
+        *out++ = 255;
+    }
+    *out++ = (uint8_t)len;
+    return out;
+}
+
+static uint8_t *peer_lz4_sequence(uint8_t *out, const uint8_t *literals, size_t lit_len, size_t offset, size_t match_len)
+{
+    uint8_t *token = out++;
+    size_t match_code = (match_len > 0) ? match_len - PEER_LZ4_MIN_MATCH : 0;
+
+    *token = (uint8_t)(((lit_len < 15) ? lit_len : 15) << 4);
+    if(lit_len >= 15)
+    {
+        out = peer_lz4_length(out, lit_len - 15);
+    }
+    memcpy(out, literals, lit_len);
+    out += lit_len;
+    if(match_len == 0)
+    {
+        return out;
+    }
+
+    *out++ = (uint8_t)offset;
+    *out++ = (uint8_t)(offset >> 8);
+    *token |= (uint8_t)((match_code < 15) ? match_code : 15);
+    if(match_code >= 15)
+    {
+        out = peer_lz4_length(out, match_code - 15);
+    }
+    return out;
+}
+
+/* Greedy LZ4 block compressor with a single entry hash table */
+static size_t peer_encode_lz4(uint8_t *dst, const uint8_t *src, size_t size)
+{
+    static int32_t table[1 << PEER_LZ4_HASH_BITS];
+    uint8_t *out = dst;
+    size_t anchor = 0;
+    size_t ip = 0;
+
+    for(size_t i = 0; i < (sizeof(table) / sizeof(table[0])); i++)
+    {
+        table[i] = -1;
+    }
+
+    while((size > PEER_LZ4_MFLIMIT) && (ip < size - PEER_LZ4_MFLIMIT))
+    {
+        uint32_t seq;
+        memcpy(&seq, src + ip, sizeof(seq));
+        uint32_t h = (seq * 2654435761U) >> (32 - PEER_LZ4_HASH_BITS);
+        int32_t ref = table[h];
+        uint32_t ref_seq = 0;
+
+        table[h] = (int32_t)ip;
+        if(ref >= 0)
+        {
+            memcpy(&ref_seq, src + ref, sizeof(ref_seq));
+        }
+        if((ref < 0) || (ip - (size_t)ref > UINT16_MAX) || (ref_seq != seq))
+        {
+            ip++;
+            continue;
+        }
+
+        size_t match_len = PEER_LZ4_MIN_MATCH;
+        while((ip + match_len < size - PEER_LZ4_LAST_LITERALS) && (src[ref + match_len] == src[ip + match_len]))
+        {
+            match_len++;
+        }
+        out = peer_lz4_sequence(out, src + anchor, ip - anchor, ip - (size_t)ref, match_len);
+        ip += match_len;
+        anchor = ip;
+    }
+    out = peer_lz4_sequence(out, src + anchor, size - anchor, 0, 0);
+    return (size_t)(out - dst);
+}
+
+/* Codes the batch when that saves bytes and the device could decode it in place, the coded
+ * payload ending at the end of the capacity bytes of its receive buffer */
+static size_t peer_encode(peer_t *peer, const uint8_t *payload, size_t size, size_t capacity)
+{
+    size_t coded;
+
+    if(peer->codec == MTB_ML_STREAM_CODEC_DELTA16)
+    {
+        coded = peer_encode_delta16(peer->code_buf, payload, size);
+    }
+    else if(peer->codec == MTB_ML_STREAM_CODEC_LZ4)
+    {
+        coded = peer_encode_lz4(peer->code_buf, payload, size);
+    }
+    else
+    {
+        return 0;
+    }
+    if(coded >= size)
+    {
+        return 0;
+    }
+
+    if(capacity > peer->check_size)
+    {
+        free(peer->check_buf);
+        peer->check_buf = malloc(capacity);
+        if(peer->check_buf == NULL)
+        {
+            peer_fail("out of memory");
+        }
+        peer->check_size = capacity;
+    }
+    memcpy(peer->check_buf + capacity - coded, peer->code_buf, coded);
+    if(!mtb_ml_stream_codec_decode(peer->codec, peer->check_buf, size, peer->check_buf + capacity - coded, coded) ||
+       (memcmp(peer->check_buf, payload, size) != 0))
+    {
+        return 0;
+    }
+    return coded;
+}
+
+static void peer_send_batch(peer_t *peer, const mtb_ml_stream_v2_hdr_t *req, uint32_t first, uint32_t count)
+{
+    mtb_ml_stream_v2_hdr_t hdr;
+    const uint8_t *payload = peer->frames + (size_t)first * peer->frame_bytes;
+    size_t capacity = (size_t)req->count * peer->frame_bytes + req->length;
+    size_t coded = peer_encode(peer, payload, (size_t)count * peer->frame_bytes, capacity);
+
+    hdr.magic = MTB_ML_STREAM_V2_MAGIC;
+    hdr.type = MTB_ML_STREAM_V2_FRAMES;
+    hdr.count = (uint16_t)count;
+    hdr.seq = req->seq;
+    hdr.length = count * peer->frame_bytes;
+    peer->frame_payload_bytes += hdr.length;
+    if(coded > 0)
+    {
+        hdr.type = MTB_ML_STREAM_V2_FRAMES_CODED;
+        hdr.length = (uint32_t)coded;
+        payload = peer->code_buf;
+    }
+    peer->coded_payload_bytes += hdr.length;
+    hdr.crc = mtb_ml_stream_crc32(0, payload, hdr.length);
+    peer_send(peer, &hdr, sizeof(hdr));
+    peer_send(peer, payload, hdr.length);
+}
+
+/* Compares a reduced result batch with the reference, a mismatching batch is requested in full */
+static void peer_check_reduced(peer_t *peer, const mtb_ml_stream_v2_hdr_t *hdr, const uint8_t *results, bool crc_ok)
+{
+    uint8_t expected[MTB_ML_STREAM_V2_TOPK_MAX * (sizeof(uint32_t) + sizeof(float))];
+    uint32_t first = peer->results;
+    bool match = crc_ok && (first + hdr->count <= peer->num_samples);
+
+    for(uint32_t i = 0; match && (i < hdr->count); i++)
+    {
+        const uint8_t *ref = peer->ref + (size_t)(first + i) * peer->result_bytes;
+
+        const uint8_t *reduced = results + (size_t)i * peer->reduced_bytes;
+
+        mtb_ml_stream_reduce(peer->output_mode, peer->top_k, ref, peer->result_values, peer->output_type, expected);
+        if(mtb_ml_stream_reduced_match(peer->output_mode, peer->top_k, expected, reduced, peer->reduced_bytes))
+        {
+            memcpy(peer->all_reduced + (size_t)(first + i) * peer->reduced_bytes, reduced, peer->reduced_bytes);
+        }
+        else
+        {
+            match = false;
+        }
+    }
+    if(!match)
+    {
+        peer_pending_t *pending = realloc(peer->pending, (peer->num_pending + 1) * sizeof(*pending));
+        if(pending == NULL)
+        {
+            peer_fail("out of memory");
+        }
+        peer->pending = pending;
+        peer->pending[peer->num_pending].seq = hdr->seq;
+        peer->pending[peer->num_pending].first = first;
+        peer->pending[peer->num_pending].count = hdr->count;
+        peer->num_pending++;
+    }
+    peer->results += hdr->count;
+}
+
+/* Receives a result batch, returns the sequence number of the full results it resends or UINT32_MAX */
+static uint32_t peer_recv_results(peer_t *peer, const mtb_ml_stream_v2_hdr_t *hdr, uint8_t *results, uint32_t batch_frames)
+{
+    bool reduced = (hdr->type == MTB_ML_STREAM_V2_RESULTS_REDUCED);
+    uint32_t bytes = reduced ? peer->reduced_bytes : peer->result_bytes;
+    bool crc_ok;
+
+    if((hdr->count > batch_frames) || (hdr->length != hdr->count * bytes) ||
+       (reduced && (peer->output_mode == MTB_ML_STREAM_OUTPUT_FULL)))
+    {
+        errno = 0;
+        peer_fail("malformed result batch");
+    }
+    peer_recv(peer, results, hdr->length);
+    crc_ok = (mtb_ml_stream_crc32(0, results, hdr->length) == hdr->crc);
+    if(!crc_ok)
+    {
+        peer->crc_errors++;
+    }
+
+    if(peer->output_mode == MTB_ML_STREAM_OUTPUT_FULL)
+    {
+        peer_store_results(peer, results, hdr->count);
+        return UINT32_MAX;
+    }
+    if(reduced)
+    {
+        peer->result_payload_bytes += (uint64_t)hdr->count * peer->result_bytes;
+        peer->reduced_payload_bytes += hdr->length;
+        peer_check_reduced(peer, hdr, results, crc_ok);
+        return UINT32_MAX;
+    }
+
+    /* Full results of the oldest mismatching batch */
+    if((peer->num_pending == 0) || (hdr->seq != peer->pending[0].seq) || (hdr->count != peer->pending[0].count))
+    {
+        errno = 0;
+        peer_fail("full results of an unknown batch");
+    }
+    for(uint32_t i = 0; i < hdr->count; i++)
+    {
+        uint32_t index = peer->pending[0].first + i;
+        const uint8_t *result = results + (size_t)i * peer->result_bytes;
+        if((index < peer->num_samples) && (memcmp(result, peer->ref + (size_t)index * peer->result_bytes, peer->result_bytes) != 0))
+        {
+            peer->mismatches++;
+        }
+        if(index < peer->num_samples)
+        {
+            /* Reduced here as the device would have, the output file holds reduced results only */
+            mtb_ml_stream_reduce(peer->output_mode, peer->top_k, result, peer->result_values, peer->output_type,
+                                 peer->all_reduced + (size_t)index * peer->reduced_bytes);
+        }
+    }
+    peer->resent++;
+    return hdr->seq;
+}
+
+/* Asks for the full results of the mismatching batches ahead of the frames of a request */
+static void peer_request_pending(peer_t *peer, uint8_t *results, uint32_t batch_frames)
+{
+    mtb_ml_stream_v2_hdr_t hdr;
+
+    while(peer->num_pending > 0)
+    {
+        uint32_t seq = peer->pending[0].seq;
+
+        hdr.magic = MTB_ML_STREAM_V2_MAGIC;
+        hdr.type = MTB_ML_STREAM_V2_RESULT_REQ;
+        hdr.count = 0;
+        hdr.seq = seq;
+        hdr.length = 0;
+        hdr.crc = 0;
+        peer_send(peer, &hdr, sizeof(hdr));
+
+        /* Results of later batches could come first */
+        do
+        {
+            peer_recv_v2_hdr(peer, &hdr);
+            if((hdr.type != MTB_ML_STREAM_V2_RESULTS) && (hdr.type != MTB_ML_STREAM_V2_RESULTS_REDUCED))
+            {
+                errno = 0;
+                peer_fail("unexpected batch while waiting for full results");
+            }
+        } while(peer_recv_results(peer, &hdr, results, batch_frames) != seq);
+
+        peer->num_pending--;
+        memmove(peer->pending, peer->pending + 1, peer->num_pending * sizeof(*peer->pending));
+    }
+}
+
+static void peer_run_v2(peer_t *peer, uint32_t batch_frames)
+{
+    mtb_ml_stream_v2_hdr_t hdr;
+    mtb_ml_stream_v2_hdr_t last_req = { .seq = UINT32_MAX };
+    size_t result_bytes = (peer->reduced_bytes > peer->result_bytes) ? peer->reduced_bytes : peer->result_bytes;
+    uint8_t *results = malloc((size_t)batch_frames * result_bytes);
+    uint32_t last_first = 0;
+    uint32_t last_count = 0;
+    /* With reduced results the device ends with an empty request, answered after the last check */
+    bool last_req_done = (peer->output_mode == MTB_ML_STREAM_OUTPUT_FULL) || (peer->num_samples == 0);
+
+    if(results == NULL)
+    {
+        peer_fail("out of memory");
+    }
+    while((peer->results < peer->num_samples) || !last_req_done)
+    {
+        peer_recv_v2_hdr(peer, &hdr);
+        switch(hdr.type)
+        {
+            case MTB_ML_STREAM_V2_FRAME_REQ:
+                peer_request_pending(peer, results, batch_frames);
+                last_req = hdr;
+                last_req_done = last_req_done || (hdr.count == 0);
+                last_first = peer->frames_sent;
+                last_count = peer->num_frames - peer->frames_sent;
+                if(last_count > hdr.count)
+                {
+                    last_count = hdr.count;
+                }
+                peer_send_batch(peer, &last_req, last_first, last_count);
+                peer->frames_sent += last_count;
+                break;
+            case MTB_ML_STREAM_V2_NACK:
+                if(hdr.seq != last_req.seq)
+                {
+                    errno = 0;
+                    peer_fail("NACK of an unknown batch");
+                }
+                peer_send_batch(peer, &last_req, last_first, last_count);
+                break;
+            case MTB_ML_STREAM_V2_RESULTS:
+            case MTB_ML_STREAM_V2_RESULTS_REDUCED:
+                if(peer_recv_results(peer, &hdr, results, batch_frames) != UINT32_MAX)
+                {
+                    errno = 0;
+                    peer_fail("full results not asked for");
+                }
+                break;
+            default:
+                errno = 0;
+                peer_fail("unknown batch type");
+        }
+    }
+    free(results);
+}
+
+static int peer_listen(int domain, const struct sockaddr *addr, socklen_t addr_len)
+{
+    int one = 1;
+    int server = socket(domain, SOCK_STREAM, 0);
+    int fd;
+
+    if(server < 0)
+    {
+        peer_fail("socket failed");
+    }
+    (void)setsockopt(server, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if((bind(server, addr, addr_len) != 0) || (listen(server, 1) != 0))
+    {
+        peer_fail("cannot listen");
+    }
+    fd = accept(server, NULL, NULL);
+    if(fd < 0)
+    {
+        peer_fail("accept failed");
+    }
+    close(server);
+    if(domain != AF_UNIX)
+    {
+        (void)setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd;
+}
+
+static int peer_open_serial(const char *path)
+{
+    struct termios tio;
+    int fd = open(path, O_RDWR | O_NOCTTY);
+
+    if(fd < 0)
+    {
+        peer_fail("cannot open serial device");
+    }
+    if(tcgetattr(fd, &tio) == 0)
+    {
+        cfmakeraw(&tio);
+        (void)tcsetattr(fd, TCSANOW, &tio);
+    }
+    return fd;
+}
+
+static uint8_t *peer_load_dataset(const char *path, mtb_ml_x_file_header_t *header, size_t *size)
+{
+    FILE *f = fopen(path, "rb");
+    uint8_t *data;
+    long end;
+
+    if((f == NULL) || (fread(header, sizeof(*header), 1, f) != 1))
+    {
+        peer_fail("cannot read dataset header");
+    }
+    fseek(f, 0, SEEK_END);
+    end = ftell(f);
+    *size = (size_t)end - sizeof(*header);
+    data = malloc(*size);
+    fseek(f, (long)sizeof(*header), SEEK_SET);
+    if((data == NULL) || (fread(data, 1, *size, f) != *size))
+    {
+        peer_fail("cannot read dataset");
+    }
+    fclose(f);
+    return data;
+}
+
+static uint8_t *peer_load_file(const char *path, size_t *size)
+{
+    FILE *f = fopen(path, "rb");
+    uint8_t *data;
+    long end;
+
+    if((f == NULL) || (fseek(f, 0, SEEK_END) != 0) || ((end = ftell(f)) < 0))
+    {
+        peer_fail("cannot read reference file");
+    }
+    *size = (size_t)end;
+    data = malloc(*size + 1);
+    fseek(f, 0, SEEK_SET);
+    if((data == NULL) || (fread(data, 1, *size, f) != *size))
+    {
+        peer_fail("cannot read reference file");
+    }
+    fclose(f);
+    return data;
+}
+
+static uint32_t peer_type_size(mtb_ml_x_data_type_t type)
+{
+    switch(type)
+    {
+        case MTB_ML_X_DATA_FLOAT32:
+            return sizeof(float);
+        case MTB_ML_X_DATA_INT8:
+            return sizeof(int8_t);
+        case MTB_ML_X_DATA_INT16:
+            return sizeof(int16_t);
+        default:
+            errno = 0;
+            peer_fail("unknown dataset type");
+            return 0;
+    }
+}
+
+static double peer_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static const char *peer_codec_name(uint32_t codec)
+{
+    return (codec == MTB_ML_STREAM_CODEC_DELTA16) ? "delta16" :
+           (codec == MTB_ML_STREAM_CODEC_LZ4) ? "lz4" : "none";
+}
+
+/* Delta coding suits int16 time series, LZ4 any data */
+static uint32_t peer_select_codec(const char *name, uint32_t offered, mtb_ml_x_data_type_t type)
+{
+    bool auto_select = (strcmp(name, "auto") == 0);
+    uint32_t delta16 = (type == MTB_ML_X_DATA_INT16) ? (offered & MTB_ML_STREAM_CODEC_DELTA16) : 0;
+
+    if((auto_select || (strcmp(name, "delta16") == 0)) && (delta16 != 0))
+    {
+        return MTB_ML_STREAM_CODEC_DELTA16;
+    }
+    if(auto_select || (strcmp(name, "lz4") == 0))
+    {
+        return offered & MTB_ML_STREAM_CODEC_LZ4;
+    }
+    return 0;
+}
+
+static const char *peer_output_name(uint32_t mode)
+{
+    return (mode == MTB_ML_STREAM_OUTPUT_TOPK) ? "top-k" :
+           (mode == MTB_ML_STREAM_OUTPUT_HASH) ? "hash" : "full";
+}
+
+/* Full results are compared with the reference file, when there is one */
+static void peer_set_ref(peer_t *peer, const uint8_t *ref, size_t ref_size)
+{
+    if(ref == NULL)
+    {
+        return;
+    }
+    if(ref_size < (size_t)peer->num_samples * peer->result_bytes)
+    {
+        errno = 0;
+        peer_fail("reference file shorter than the results of the dataset");
+    }
+    peer->ref = ref;
+}
+
+/* Reduced results are only taken with reference results to check them against */
+static void peer_select_output(peer_t *peer, mtb_ml_stream_v2_caps_t *caps, uint32_t output_size)
+{
+    peer->output_mode = MTB_ML_STREAM_OUTPUT_FULL;
+    peer->top_k = 0;
+    /* The model output type may differ from the dataset type, it follows from the result size */
+    switch((output_size > 0) ? caps->result_bytes / output_size : 0)
+    {
+        case sizeof(int8_t):
+            peer->output_type = MTB_ML_X_DATA_INT8;
+            break;
+        case sizeof(int16_t):
+            peer->output_type = MTB_ML_X_DATA_INT16;
+            break;
+        case sizeof(float):
+            peer->output_type = MTB_ML_X_DATA_FLOAT32;
+            break;
+        default:
+            errno = 0;
+            peer_fail("result size does not match the model output size");
+            break;
+    }
+    peer->result_values = output_size;
+    if((caps->output_mode == MTB_ML_STREAM_OUTPUT_HASH) ||
+       ((caps->output_mode == MTB_ML_STREAM_OUTPUT_TOPK) && (caps->top_k > 0) &&
+        (caps->top_k <= MTB_ML_STREAM_V2_TOPK_MAX) && (caps->top_k <= peer->result_values)))
+    {
+        if(peer->ref == NULL)
+        {
+            printf("device offers %s results, full results without a reference file\n", peer_output_name(caps->output_mode));
+        }
+        else
+        {
+            peer->output_mode = caps->output_mode;
+            peer->top_k = (caps->output_mode == MTB_ML_STREAM_OUTPUT_TOPK) ? caps->top_k : 0;
+            peer->reduced_bytes = (uint32_t)mtb_ml_stream_reduced_bytes(peer->output_mode, peer->top_k,
+                                                                        peer->result_values, peer->output_type);
+            peer->all_reduced = malloc((size_t)peer->num_samples * peer->reduced_bytes);
+            if(peer->all_reduced == NULL)
+            {
+                peer_fail("out of memory");
+            }
+        }
+    }
+    caps->output_mode = peer->output_mode;
+    caps->top_k = peer->top_k;
+}
+
+static void peer_usage(void)
+{
+    fprintf(stderr, "usage: mtb_ml_stream_peer (--tcp PORT | --unix PATH | --serial DEVICE) "
+                    "-x X_FILE [-o OUT_FILE] [--batch K | --v1] [--codec none|delta16|lz4|auto] [--ref REF_FILE]\n");
+    exit(2);
+}
+
+/*******************************************************************************
+ * Main
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    static const struct option options[] =
+    {
+        { "tcp",    required_argument, NULL, 't' },
+        { "unix",   required_argument, NULL, 'u' },
+        { "serial", required_argument, NULL, 's' },
+        { "batch",  required_argument, NULL, 'k' },
+        { "v1",     no_argument,       NULL, '1' },
+        { "codec",  required_argument, NULL, 'c' },
+        { "ref",    required_argument, NULL, 'r' },
+        { NULL, 0, NULL, 0 }
+    };
+    const char *tcp_port = NULL, *unix_path = NULL, *serial = NULL;
+    const char *x_path = NULL, *out_path = NULL, *ref_path = NULL;
+    uint8_t *ref = NULL;
+    size_t ref_size = 0;
+    uint32_t max_batch = UINT16_MAX;
+    bool force_v1 = false;
+    const char *codec = "auto";
+    peer_t peer;
+    mtb_ml_x_file_header_t header;
+    mtb_ml_regression_info_t regr_info;
+    size_t data_size;
+    int opt;
+
+    while((opt = getopt_long(argc, argv, "x:o:", options, NULL)) != -1)
+    {
+        switch(opt)
+        {
+            case 't': tcp_port = optarg; break;
+            case 'u': unix_path = optarg; break;
+            case 's': serial = optarg; break;
+            case 'k': max_batch = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case '1': force_v1 = true; break;
+            case 'c': codec = optarg; break;
+            case 'r': ref_path = optarg; break;
+            case 'x': x_path = optarg; break;
+            case 'o': out_path = optarg; break;
+            default: peer_usage();
+        }
+    }
+    if((x_path == NULL) || ((tcp_port != NULL) + (unix_path != NULL) + (serial != NULL) != 1) || (max_batch == 0))
+    {
+        peer_usage();
+    }
+
+    memset(&peer, 0, sizeof(peer));
+    peer.frames = peer_load_dataset(x_path, &header, &data_size);
+    peer.num_samples = (uint32_t)header.num_of_samples;
+    peer.frame_bytes = (uint32_t)header.input_size * peer_type_size(header.data_type);
+    if(header.recurrent_ts_size > 1)
+    {
+        /* Streaming RNN, the device requests one time step slice at a time */
+        peer.frame_bytes /= (uint32_t)header.recurrent_ts_size;
+    }
+    peer.num_frames = (uint32_t)(data_size / peer.frame_bytes);
+    peer.data_type = header.data_type;
+    if(ref_path != NULL)
+    {
+        ref = peer_load_file(ref_path, &ref_size);
+    }
+    if(out_path != NULL)
+    {
+        peer.out = fopen(out_path, "wb");
+        if(peer.out == NULL)
+        {
+            peer_fail("cannot create output file");
+        }
+    }
+
+    if(tcp_port != NULL)
+    {
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons((uint16_t)strtoul(tcp_port, NULL, 0));
+        peer.fd = peer_listen(AF_INET, (const struct sockaddr *)&addr, sizeof(addr));
+    }
+    else if(unix_path != NULL)
+    {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, unix_path, sizeof(addr.sun_path) - 1);
+        unlink(unix_path);
+        peer.fd = peer_listen(AF_UNIX, (const struct sockaddr *)&addr, sizeof(addr));
+    }
+    else
+    {
+        peer.fd = peer_open_serial(serial);
+    }
+
+    /* Protocol v1 handshake */
+    peer_send(&peer, ML_TC_START_STRING, sizeof(ML_TC_START_STRING));
+    peer_expect(&peer, ML_CT_READY_STRING);
+    peer_send(&peer, ML_TC_MODEL_DATA_REQ_STRING, sizeof(ML_TC_MODEL_DATA_REQ_STRING));
+    peer_expect(&peer, ML_CT_MODEL_DATA_STRING);
+    peer_recv(&peer, &regr_info, sizeof(regr_info));
+    peer_send(&peer, ML_TC_DATASET_REQ_SEND_STRING, sizeof(ML_TC_DATASET_REQ_SEND_STRING));
+    peer_expect(&peer, ML_CT_READY_STRING);
+    peer_send(&peer, &header, sizeof(header));
+    peer.result_bytes = regr_info.output_size * peer_type_size(header.data_type);
+
+    double start = peer_now();
+
+    /* The device either offers protocol v2 or requests the first frame */
+    static const char *const first_tokens[] = { ML_CT_V2_OFFER_STRING, ML_CT_FRAME_REQ_STRING };
+    if(peer_wait_token(&peer, first_tokens, 2) == 0)
+    {
+        mtb_ml_stream_v2_caps_t caps;
+        peer_recv(&peer, &caps, sizeof(caps));
+        if(force_v1 || (caps.version != MTB_ML_STREAM_V2_VERSION) || (caps.frame_bytes != peer.frame_bytes))
+        {
+            peer_send(&peer, ML_TC_V2_DECLINE_STRING, sizeof(ML_TC_V2_DECLINE_STRING));
+            peer_set_ref(&peer, ref, ref_size);
+            peer_run_v1(&peer);
+        }
+        else
+        {
+            if(caps.batch_frames > max_batch)
+            {
+                caps.batch_frames = max_batch;
+            }
+            peer.result_bytes = caps.result_bytes;
+            peer.codec = peer_select_codec(codec, caps.codecs, header.data_type);
+            caps.codecs = peer.codec;
+            peer_set_ref(&peer, ref, ref_size);
+            peer_select_output(&peer, &caps, (uint32_t)regr_info.output_size);
+            if(peer.codec != 0)
+            {
+                size_t batch_bytes = (size_t)caps.batch_frames * peer.frame_bytes;
+                /* Worst case of both codecs, raw is sent beyond the batch size anyway */
+                peer.code_buf = malloc(2 * batch_bytes + 16);
+                if(peer.code_buf == NULL)
+                {
+                    peer_fail("out of memory");
+                }
+            }
+            peer_send(&peer, ML_TC_V2_ACCEPT_STRING, sizeof(ML_TC_V2_ACCEPT_STRING));
+            peer_send(&peer, &caps, sizeof(caps));
+            printf("protocol v2, %u frames per batch, codec %s, output %s\n", (unsigned)caps.batch_frames,
+                   peer_codec_name(peer.codec), peer_output_name(peer.output_mode));
+            peer_run_v2(&peer, caps.batch_frames);
+        }
+    }
+    else
+    {
+        /* First frame request already consumed */
+        peer_send(&peer, peer.frames, peer.frame_bytes);
+        peer.frames_sent = 1;
+        peer_set_ref(&peer, ref, ref_size);
+        peer_run_v1(&peer);
+    }
+
+    double elapsed = peer_now() - start;
+
+    peer_send(&peer, ML_TC_DONE_STRING, sizeof(ML_TC_DONE_STRING));
+    peer_expect(&peer, ML_CT_DONE_STRING);
+
+    printf("frames=%u results=%u crc_errors=%u time_s=%.3f frames_per_s=%.1f tx_bytes=%llu rx_bytes=%llu tx_kBps=%.1f\n",
+           (unsigned)peer.frames_sent, (unsigned)peer.results, (unsigned)peer.crc_errors, elapsed,
+           (elapsed > 0) ? peer.results / elapsed : 0.0,
+           (unsigned long long)peer.tx_bytes, (unsigned long long)peer.rx_bytes,
+           (elapsed > 0) ? peer.tx_bytes / elapsed / 1000.0 : 0.0);
+    if((peer.ref != NULL) && (peer.output_mode == MTB_ML_STREAM_OUTPUT_FULL))
+    {
+        printf("mismatches=%u\n", (unsigned)peer.mismatches);
+    }
+    if(peer.codec != 0)
+    {
+        printf("codec=%s frame_bytes=%llu coded_bytes=%llu ratio=%.2f\n", peer_codec_name(peer.codec),
+               (unsigned long long)peer.frame_payload_bytes, (unsigned long long)peer.coded_payload_bytes,
+               (peer.coded_payload_bytes > 0) ? (double)peer.frame_payload_bytes / peer.coded_payload_bytes : 0.0);
+    }
+
+    if(peer.output_mode != MTB_ML_STREAM_OUTPUT_FULL)
+    {
+        printf("output=%s result_bytes=%llu reduced_bytes=%llu ratio=%.1f mismatches=%u resent_batches=%u\n",
+               peer_output_name(peer.output_mode), (unsigned long long)peer.result_payload_bytes,
+               (unsigned long long)peer.reduced_payload_bytes,
+               (peer.reduced_payload_bytes > 0) ? (double)peer.result_payload_bytes / peer.reduced_payload_bytes : 0.0,
+               (unsigned)peer.mismatches, (unsigned)peer.resent);
+        if(peer.out != NULL)
+        {
+            fwrite(peer.all_reduced, peer.reduced_bytes, peer.num_samples, peer.out);
+        }
+    }
+
+    if(peer.out != NULL)
+    {
+        fclose(peer.out);
+    }
+    free(peer.all_reduced);
+    free(peer.pending);
+    free(ref);
+    free(peer.code_buf);
+    free(peer.check_buf);
+    close(peer.fd);
+    /* Any result the device got wrong fails the run, not only a corrupted transfer */
+    return ((peer.crc_errors == 0) && (peer.mismatches == 0)) ? 0 : 1;
+}